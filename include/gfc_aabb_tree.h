@@ -0,0 +1,194 @@
+#ifndef __GFC_AABB_TREE_H__
+#define __GFC_AABB_TREE_H__
+
+#include "gfc_types.h"
+#include "gfc_vector.h"
+#include "gfc_shape.h"
+
+/**
+ * @purpose a dynamic bounding volume tree over GFC_Rects, a broadphase for scenes that mix very large and very
+ * small bodies, where no single grid cell size suits everything (see gfc_spatial_hash.h for the uniform case).
+ * Each body is a leaf holding a fattened copy of its bounds (usually from gfc_shape_get_bounds), and each
+ * internal node holds the union of its two children.
+ * Leaves go where they grow the perimeter of the tree the least (the surface area heuristic, in 2D), and
+ * nodes are rotated on the way back up to keep the tree balanced.
+ * Because the stored bounds are fattened, a body can move a little without the tree changing at all.
+ * Query, raycast and pair traversals walk the tree with an explicit stack rather than recursion.
+ * Results are based on the fat bounds, so hand them to the gfc_shape tests for the exact answer.
+ */
+
+#define GFC_AABB_TREE_NONE 0                /**<never a valid body handle*/
+#define GFC_AABB_TREE_DISPLACEMENT_SCALE 4  /**<how many steps of a move the fat bounds are stretched ahead*/
+
+typedef struct
+{
+    GFC_Rect    bounds;         /**<fattened bounds for leaves, the union of both children for internal nodes*/
+    void       *data;           /**<the data given when the body was inserted, leaves only*/
+    Uint32      parent;         /**<the parent node, or the next free node when this one is unused*/
+    Uint32      child1,child2;  /**<GFC_AABB_TREE_NONE for leaves*/
+    Sint32      height;         /**<0 for leaves, -1 for unused nodes*/
+}GFC_AABBTreeNode;
+
+typedef struct
+{
+    GFC_AABBTreeNode   *nodes;      /**<node pool, node 0 is never used so that a handle of 0 can mean none*/
+    Uint32              size;       /**<how many nodes are allocated, including node 0*/
+    Uint32              root;       /**<the top of the tree, GFC_AABB_TREE_NONE when empty*/
+    Uint32              freeHead;   /**<the first unused node*/
+    Uint32              count;      /**<how many bodies (leaves) are in the tree*/
+    float               margin;     /**<how far leaf bounds are fattened on each side*/
+}GFC_AABBTree;
+
+/**
+ * @brief prototype for a function called for each pair of bodies
+ * @param a the handle of one body
+ * @param b the handle of the other body
+ * @param context the context given to the call
+ */
+typedef void gfc_aabb_tree_pair_func(Uint32 a,Uint32 b,void *context);
+
+/**
+ * @brief prototype for the narrowphase of a raycast, called for each body whose fat bounds the ray crosses
+ * @param handle the body to test
+ * @param ray the ray as given to gfc_aabb_tree_raycast
+ * @param maxFraction how far along the ray (0 to 1) the closest hit so far is
+ * @param context the context given to the call
+ * @return a negative number to ignore this body, the fraction along the ray where it is hit to shorten the
+ * ray to that point, 1 to carry on without shortening it, or 0 to stop the raycast
+ */
+typedef float gfc_aabb_tree_ray_func(Uint32 handle,GFC_Edge2D ray,float maxFraction,void *context);
+
+/**
+ * @brief allocate a new empty tree
+ * @param margin how far to fatten the bounds of each body on every side.  Larger margins mean fewer updates
+ * for moving bodies but more false positives in queries.  Must not be negative
+ * @return NULL on error, or the new tree.  Free it with gfc_aabb_tree_free
+ */
+GFC_AABBTree *gfc_aabb_tree_new(float margin);
+
+/**
+ * @brief free a tree
+ * @note the data given to each body is not freed
+ * @param tree the tree to free
+ */
+void gfc_aabb_tree_free(GFC_AABBTree *tree);
+
+/**
+ * @brief remove every body from the tree
+ * @note all handles become invalid
+ * @param tree the tree to clear
+ */
+void gfc_aabb_tree_clear(GFC_AABBTree *tree);
+
+/**
+ * @brief add a body to the tree
+ * @param tree the tree to add to
+ * @param bounds the tight bounds of the body, such as from gfc_shape_get_bounds
+ * @param data stored with the body, get it back with gfc_aabb_tree_get_data
+ * @return GFC_AABB_TREE_NONE on error, or the handle of the new body
+ */
+Uint32 gfc_aabb_tree_insert(GFC_AABBTree *tree,GFC_Rect bounds,void *data);
+
+/**
+ * @brief remove a body from the tree.  Its handle may be reused by a later insert
+ * @param tree the tree to remove from
+ * @param handle the body to remove
+ */
+void gfc_aabb_tree_remove(GFC_AABBTree *tree,Uint32 handle);
+
+/**
+ * @brief give a body new bounds, such as after it has moved.
+ * Nothing happens while the new bounds still fit in the fat bounds, otherwise the body is reinserted with
+ * its fat bounds stretched along displacement so it can keep moving that way for a while
+ * @param tree the tree the body is in
+ * @param handle the body to update
+ * @param bounds the new tight bounds of the body
+ * @param displacement how far the body moved this step, or a zero vector if unknown
+ * @return 1 if the body was reinserted, 0 if the tree did not change
+ */
+Uint8 gfc_aabb_tree_move(GFC_AABBTree *tree,Uint32 handle,GFC_Rect bounds,GFC_Vector2D displacement);
+
+/**
+ * @brief get the data a body was inserted with
+ * @param tree the tree the body is in
+ * @param handle the body
+ * @return NULL if the handle is not a body, the data otherwise
+ */
+void *gfc_aabb_tree_get_data(GFC_AABBTree *tree,Uint32 handle);
+
+/**
+ * @brief get the fattened bounds the tree keeps for a body
+ * @param tree the tree the body is in
+ * @param handle the body
+ * @return the fat bounds, or an empty rect if the handle is not a body
+ */
+GFC_Rect gfc_aabb_tree_get_fat_bounds(GFC_AABBTree *tree,Uint32 handle);
+
+/**
+ * @brief get the number of bodies in the tree
+ * @param tree the tree to check
+ * @return the count, 0 if tree is NULL
+ */
+Uint32 gfc_aabb_tree_get_count(GFC_AABBTree *tree);
+
+/**
+ * @brief get the height of the tree, 0 for an empty tree or a single body
+ * @param tree the tree to check
+ * @return the height
+ */
+Uint32 gfc_aabb_tree_get_height(GFC_AABBTree *tree);
+
+/**
+ * @brief find the bodies whose fat bounds overlap a rect
+ * @param tree the tree to search
+ * @param rect the area to search
+ * @param handles where to write the handles of the bodies found
+ * @param maxHandles how many handles fit, the search stops once it is full
+ * @return how many handles were written
+ */
+Uint32 gfc_aabb_tree_query(GFC_AABBTree *tree,GFC_Rect rect,Uint32 *handles,Uint32 maxHandles);
+
+/**
+ * @brief cast a ray through the tree, from (x1,y1) to (x2,y2) of the edge.
+ * func is called for each body whose fat bounds the ray crosses, and may shorten the ray (see
+ * gfc_aabb_tree_ray_func), so bodies past the closest hit so far are skipped.
+ * A typical func tests the body's shape with gfc_raycast_shape and returns the fraction of the hit
+ * @param tree the tree to search
+ * @param ray the segment to cast
+ * @param func the narrowphase test
+ * @param context passed along to func
+ * @param fraction if provided, set to how far along the ray the closest hit is, 1 if nothing was hit
+ * @return the handle of the closest body hit, GFC_AABB_TREE_NONE if none
+ */
+Uint32 gfc_aabb_tree_raycast(
+    GFC_AABBTree *tree,
+    GFC_Edge2D ray,
+    gfc_aabb_tree_ray_func *func,
+    void *context,
+    float *fraction);
+
+/**
+ * @brief cast many rays into a tree of shapes, finding the nearest hit for each, like gfc_raycast_batch but
+ * only testing the shapes each ray's path reaches
+ * @note for this each body's data must point to its GFC_Shape, which must stay valid.  Bodies with NULL data
+ * are skipped
+ * @param tree the tree to cast into
+ * @param rays the segments to cast
+ * @param rayCount how many rays there are
+ * @param hits an array of rayCount results, hits[i] is set to the nearest hit for rays[i].
+ * The id is the handle of the body hit
+ * @return how many of the rays hit something
+ */
+Uint32 gfc_aabb_tree_raycast_batch(GFC_AABBTree *tree,const GFC_Edge2D *rays,Uint32 rayCount,GFC_RaycastHit *hits);
+
+/**
+ * @brief call func once for each pair of bodies whose fat bounds overlap.
+ * These are the candidates to pass to a narrowphase test such as gfc_shape_overlap_poc
+ * @note the tree must not be changed from inside func
+ * @param tree the tree to search
+ * @param func called with the two handles of each pair
+ * @param context passed along to func
+ */
+void gfc_aabb_tree_foreach_pair(GFC_AABBTree *tree,gfc_aabb_tree_pair_func *func,void *context);
+
+#endif
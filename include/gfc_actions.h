@@ -5,6 +5,7 @@
 
 #include "gfc_text.h"
 #include "gfc_list.h"
+#include "gfc_intern.h"
 
 /**
  * @purpose Actions and ActionLists are meant to help with animated things.  
@@ -35,6 +36,7 @@ typedef enum
 typedef struct Action_S
 {
     GFC_TextLine        name;       /**<searchable name criteria*/
+    GFC_Atom            atom;       /**<the interned name, for lookup.  GFC_ATOM_NONE if name was set by hand*/
     int                 startFrame; /**<starting frame of the animation*/
     int                 endFrame;   /**<ending frame of the animmation*/
     float               frameRate;  /**<how much to progress a frame per update*/
@@ -107,6 +109,15 @@ SJson *gfc_action_list_to_json(GFC_ActionList *actionList);
  */
 GFC_Action *gfc_action_list_get_action_by_name(GFC_ActionList *list,const char *name);
 
+/**
+ * @brief given a list of Actions, search for the interned name
+ * @note actions whose atom is GFC_ATOM_NONE are never found this way, search by name for those
+ * @param list list containing actions
+ * @param atom the atom of the action name, from gfc_intern()
+ * @return NULL on error or not found, the Action otherwise
+ */
+GFC_Action *gfc_action_list_get_action_by_atom(GFC_ActionList *list,GFC_Atom atom);
+
 /**
  * @brief given a list of Actions, search for the name, and set the frame to the start frame if provided
  * @param list list containing actions
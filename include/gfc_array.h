@@ -0,0 +1,169 @@
+#ifndef __GFC_ARRAY_H__
+#define __GFC_ARRAY_H__
+
+#include <SDL.h>
+
+/**
+ * @brief the GFC_Array is an automatically expanding array that stores its elements by value.
+ * Where a GFC_List holds pointers to data that lives elsewhere, a GFC_Array copies each element into one
+ * contiguous block, so small structs (vectors, shapes, particles) need no allocation of their own
+ * and iterate straight through memory.
+ * @note pointers returned by gfc_array_get_nth are only valid until the array grows or is modified
+ */
+typedef struct
+{
+    Uint8  *data;           /**<the element storage*/
+    size_t  elementSize;    /**<the size of one element in bytes*/
+    Uint32  size;           /**<how many elements fit before the array needs to grow*/
+    Uint32  count;          /**<how many elements are in the array*/
+}GFC_Array;
+
+/**
+ * @brief access the nth element as the given type, with no bounds checking
+ * @example GFC_Vector2D p = gfc_array_nth_as(points,GFC_Vector2D,i);
+ */
+#define gfc_array_nth_as(array,type,n) (((type *)(array)->data)[n])
+
+/**
+ * @brief allocate a new empty array
+ * @param elementSize the size of each element, usually sizeof(type)
+ * @return NULL on memory error or a new empty array
+ */
+GFC_Array *gfc_array_new(size_t elementSize);
+
+/**
+ * @brief allocate a new empty array with room for count elements
+ * @param elementSize the size of each element, usually sizeof(type)
+ * @param count how many elements to make room for
+ * @return NULL on memory error or a new empty array
+ */
+GFC_Array *gfc_array_new_size(size_t elementSize,Uint32 count);
+
+/**
+ * @brief make a copy of an array, including the element data
+ * @param old the array to copy
+ * @return NULL on error, a new array otherwise
+ */
+GFC_Array *gfc_array_copy(GFC_Array *old);
+
+/**
+ * @brief free an array and its element storage
+ * @param array the array to delete
+ */
+void gfc_array_delete(GFC_Array *array);
+
+/**
+ * @brief remove all elements from the array, keeping its memory
+ * @param array the array to clear
+ */
+void gfc_array_clear(GFC_Array *array);
+
+/**
+ * @brief make sure the array can hold count elements without growing
+ * @param array the array to grow
+ * @param count the number of elements to make room for
+ * @return 0 on memory error, 1 otherwise
+ */
+int gfc_array_reserve(GFC_Array *array,Uint32 count);
+
+/**
+ * @brief release any memory the array holds beyond its current elements
+ * @param array the array to shrink
+ */
+void gfc_array_shrink_to_fit(GFC_Array *array);
+
+/**
+ * @brief get the address of the nth element
+ * @param array the array to get from
+ * @param n which element
+ * @return NULL on error (such as n >= count) or a pointer to the element in the array
+ */
+void *gfc_array_get_nth(GFC_Array *array,Uint32 n);
+
+//shorthand
+#define gfc_array_nth(array,n) gfc_array_get_nth(array,n)
+
+/**
+ * @brief overwrite the nth element
+ * @param array the array to change
+ * @param n which element to change
+ * @param data pointer to the value to copy in, elementSize bytes are copied
+ */
+void gfc_array_set_nth(GFC_Array *array,Uint32 n,const void *data);
+
+/**
+ * @brief copy an element onto the end of the array
+ * @param array the array to add to
+ * @param data pointer to the value to copy in.  If NULL, the new element is zeroed.
+ * It may point to an element of this same array
+ * @return NULL on error, or a pointer to the new element in the array
+ */
+void *gfc_array_append(GFC_Array *array,const void *data);
+
+/**
+ * @brief copy an element into the array at position n, shifting later elements up
+ * @param array the array to insert into
+ * @param data pointer to the value to copy in.  If NULL, the new element is zeroed.
+ * It may point to an element of this same array
+ * @param n the position to insert at, up to count
+ * @return NULL on error, or a pointer to the new element in the array
+ */
+void *gfc_array_insert(GFC_Array *array,const void *data,Uint32 n);
+
+/**
+ * @brief delete the nth element, shifting later elements down to keep the order
+ * @param array the array to delete from
+ * @param n the element to delete
+ * @return -1 on error, 0 otherwise
+ */
+int gfc_array_delete_nth(GFC_Array *array,Uint32 n);
+
+/**
+ * @brief delete the nth element by moving the last element into its place
+ * @note O(1), but the order of the array is not preserved
+ * @param array the array to delete from
+ * @param n the element to delete
+ * @return -1 on error, 0 otherwise
+ */
+int gfc_array_delete_nth_unordered(GFC_Array *array,Uint32 n);
+
+/**
+ * @brief delete the last element of the array
+ * @param array the array to delete from
+ * @return -1 on error, 0 otherwise
+ */
+int gfc_array_delete_last(GFC_Array *array);
+
+/**
+ * @brief get the number of elements in the array
+ * @param array the array to check
+ * @return the count, zero if array is NULL
+ */
+Uint32 gfc_array_get_count(GFC_Array *array);
+
+//shorthand
+#define gfc_array_count(array) gfc_array_get_count(array)
+
+/**
+ * @brief sort the array in place
+ * @param array the array to sort
+ * @param compare given pointers to two elements, same rules as gfc_compare_func
+ */
+void gfc_array_sort(GFC_Array *array,int (*compare)(const void *a,const void *b));
+
+/**
+ * @brief call the function provided with a pointer to each element in the array
+ * @param array the array to iterate over
+ * @param function called with the address of each element
+ */
+void gfc_array_foreach(GFC_Array *array,void (*function)(void *data));
+
+/**
+ * @brief call the function provided with a pointer to each element in the array and the context
+ * @param array the array to iterate over
+ * @param function called with the address of each element and contextData
+ * @param contextData passed as the second argument to function
+ */
+void gfc_array_foreach_context(GFC_Array *array,void (*function)(void *data,void *context),void *contextData);
+
+#endif
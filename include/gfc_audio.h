@@ -10,6 +10,7 @@
 #include "gfc_text.h"
 #include "gfc_list.h"
 #include "gfc_hashmap.h"
+#include "gfc_intern.h"
 
 typedef struct
 {
@@ -22,6 +23,7 @@ typedef struct
 {
     Uint32 ref_count;
     GFC_TextLine filepath;  /**<the sound file that was loaded*/
+    GFC_Atom     atom;      /**<the interned filepath, for lookup*/
     Mix_Chunk *sound;
     float volume;
     int defaultChannel;
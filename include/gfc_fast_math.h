@@ -0,0 +1,155 @@
+#ifndef __GFC_FAST_MATH_H__
+#define __GFC_FAST_MATH_H__
+
+#include <math.h>
+#include "gfc_types.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 1))
+    #define GFC_FAST_MATH_SSE 1
+    #include <xmmintrin.h>
+#endif
+
+/**
+ * @purpose single precision approximations of the libm functions that steering, rotation and noise code call
+ * in tight loops.  The gfc_fast_ functions are always available.  The gfc_math_ macros at the bottom pick
+ * the fast versions when the library is built with GFC_FAST_MATH defined (-DGFC_FAST_MATH), and otherwise the
+ * same libm calls the vector code always made (double sin, cos and sqrt, float atan2), so results without the
+ * flag are unchanged.
+ *
+ * The error bounds below were measured against double precision libm on dense sweeps of the input range.
+ * None of these handle NaN, infinity or signed zero the way libm does.
+ */
+
+/**
+ * @brief an approximate 1 / sqrt(x)
+ * @note max relative error 3e-7 with SSE (rsqrtss plus one Newton step), 5e-6 without (two Newton steps).
+ * Measured over every normal float: 2.96e-7 and 4.7e-6, both worst just above FLT_MIN
+ * @param x must be greater than zero
+ */
+static inline float gfc_fast_rsqrt(float x)
+{
+    float y;
+#ifdef GFC_FAST_MATH_SSE
+    y = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(x)));
+    return y * (1.5f - 0.5f * x * y * y);
+#else
+    union {float f; Uint32 i;} bits;
+    bits.f = x;
+    bits.i = 0x5f375a86 - (bits.i >> 1);
+    y = bits.f;
+    y = y * (1.5f - 0.5f * x * y * y);
+    return y * (1.5f - 0.5f * x * y * y);
+#endif
+}
+
+/**
+ * @brief an approximate sqrt(x), as x * gfc_fast_rsqrt(x)
+ * @note same relative error as gfc_fast_rsqrt.  Returns 0 for x <= 0
+ */
+static inline float gfc_fast_sqrt(float x)
+{
+    if (x <= 0)return 0;
+    return x * gfc_fast_rsqrt(x);
+}
+
+/**
+ * @brief sine and cosine of the same angle together, for about the cost of one libm call
+ * @note max absolute error 1e-7 for |radians| <= 1000, growing to 1e-6 by |radians| = 1e5.
+ * Past about 1e7 the reduction runs out of precision (and int range) and the result is meaningless.
+ * Keep angles wrapped (see gfc_angle_clamp_radians) for best results
+ * @param radians the angle
+ * @param s if provided, set to the sine
+ * @param c if provided, set to the cosine
+ */
+static inline void gfc_sincos(float radians,float *s,float *c)
+{
+    int quadrant;
+    float k,r,r2,sr,cr,t;
+    //reduce to [-pi/4,pi/4] by taking off the nearest multiple of pi/2, in three parts to keep the low bits
+    quadrant = (int)(radians * 0.63661977236758134f + ((radians >= 0) ? 0.5f : -0.5f));
+    k = (float)quadrant;
+    r = ((radians - k * 1.5703125f) - k * 4.837512969970703125e-4f) - k * 7.549789948768648e-8f;
+    r2 = r * r;
+    //minimax polynomials over [-pi/4,pi/4]
+    sr = r + r * r2 * (-1.6666654611e-1f + r2 * (8.3321608736e-3f + r2 * -1.9515295891e-4f));
+    cr = 1.0f - 0.5f * r2 + r2 * r2 * (4.166664568298827e-2f + r2 * (-1.388731625493765e-3f + r2 * 2.443315711809948e-5f));
+    //odd quadrants swap sine and cosine, then the signs follow the quadrant
+    if (quadrant & 1)
+    {
+        t = sr;
+        sr = cr;
+        cr = -t;
+    }
+    if (quadrant & 2)
+    {
+        sr = -sr;
+        cr = -cr;
+    }
+    if (s)*s = sr;
+    if (c)*c = cr;
+}
+
+/**
+ * @brief approximate sine, see gfc_sincos for the error bound
+ */
+static inline float gfc_fast_sin(float radians)
+{
+    float s;
+    gfc_sincos(radians,&s,NULL);
+    return s;
+}
+
+/**
+ * @brief approximate cosine, see gfc_sincos for the error bound
+ */
+static inline float gfc_fast_cos(float radians)
+{
+    float c;
+    gfc_sincos(radians,NULL,&c);
+    return c;
+}
+
+/**
+ * @brief approximate atan2, same quadrant rules as libm
+ * @note max absolute error 2e-6 radians.  Returns 0 when x and y are both 0
+ */
+static inline float gfc_fast_atan2(float y,float x)
+{
+    float ax,ay,z,z2,a;
+    ax = fabsf(x);
+    ay = fabsf(y);
+    if ((ax == 0)&&(ay == 0))return 0;
+    //fold into the first octant so the polynomial only has to cover [0,1]
+    z = (ax >= ay) ? ay / ax : ax / ay;
+    z2 = z * z;
+    a = z * (0.99997726f + z2 * (-0.33262347f + z2 * (0.19354346f + z2 * (-0.11643287f + z2 * (0.05265332f + z2 * -0.01172120f)))));
+    if (ay > ax)a = 1.57079632679489662f - a;
+    if (x < 0)a = 3.14159265358979324f - a;
+    if (y < 0)a = -a;
+    return a;
+}
+
+/**
+ * @brief the type to keep gfc_math_sincos results in when they are used in further arithmetic.
+ * float for the fast path, double otherwise so the products round the same way they always did
+ */
+#ifdef GFC_FAST_MATH
+    typedef float GFC_MathReal;
+#else
+    typedef double GFC_MathReal;
+#endif
+
+#ifdef GFC_FAST_MATH
+    #define gfc_math_rsqrt(x) gfc_fast_rsqrt(x)
+    #define gfc_math_sqrt(x) gfc_fast_sqrt(x)
+    #define gfc_math_sincos(radians,s,c) gfc_sincos(radians,s,c)
+    #define gfc_math_atan2(y,x) gfc_fast_atan2(y,x)
+#else
+    //exactly what the callers did before these macros: double libm, rounded to float on the way out
+    #define gfc_math_rsqrt(x) (1.0f / (float)sqrt(x))
+    #define gfc_math_sqrt(x) ((float)sqrt(x))
+    #define gfc_math_sincos(radians,s,c) do {*(s) = sin(radians); *(c) = cos(radians);} while (0)
+    #define gfc_math_atan2(y,x) atan2f(y,x)
+#endif
+
+#endif
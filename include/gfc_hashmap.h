@@ -26,19 +26,56 @@
 #include "gfc_types.h"
 #include "gfc_list.h"
 
+/**
+ * @brief prototype for a function used to hash hashmap keys
+ * @param key the key to hash, it may not be null terminated
+ * @param length how many characters of key to hash
+ * @param seed the seed of the hashmap
+ * @return the hash value
+ */
+typedef Uint32 gfc_hash_func(const char *key,size_t length,Uint32 seed);
+
+/**
+ * @brief the GFC_HashMap is an open addressing hash table using robin hood probing.
+ * Collisions probe forward (wrapping around the end of the table) and the table only grows
+ * when the load factor is exceeded, so memory stays proportional to the number of keys.
+ * Slots are kept in parallel arrays so a probe only walks the hashes, and keys are copied into
+ * a single string arena owned by the map, so inserting does not allocate per element.
+ */
 typedef struct
 {
-    GFC_TextLine    key;
-    Uint32          hashValue;
-    void           *data;
-}GFC_HashElement;
+    Uint32     *hashes;     /**<the hash of the key in each slot, 0 marks an empty slot*/
+    Uint32     *keys;       /**<offset into the arena of the key in each slot*/
+    void      **values;     /**<the data stored in each slot*/
+    char       *arena;      /**<every key in the map, null terminated, packed end to end*/
+    Uint32      arenaSize;  /**<how many bytes are allocated for the arena*/
+    Uint32      arenaUsed;  /**<how many bytes of the arena are in use, including deleted keys*/
+    Uint32      arenaDead;  /**<how many bytes of the arena belong to deleted keys*/
+    Uint32      size;       /**<how many slots are in the table, always a power of two*/
+    Uint32      count;      /**<how many elements are stored in the table*/
+    Uint32      seed;       /**<the seed to calculate the hashed*/
+    gfc_hash_func *hash;    /**<the function used to hash keys, gfc_hash_fast by default*/
+}GFC_HashMap;
 
+/**
+ * @brief cursor for walking the elements of a hashmap in place, without allocating.
+ * Iteration rules:
+ *  - replacing the data of an existing key (gfc_hashmap_insert with a key already in the map) is safe at any time
+ *  - deleting the CURRENT element, with gfc_hashmap_iter_delete or gfc_hashmap_delete_by_key, is safe.
+ *    Every remaining element is still visited exactly once
+ *  - inserting new keys, deleting any other key, or changing the seed during iteration is NOT safe.
+ *    Elements may be skipped or visited twice
+ * @note element order is unspecified
+ */
 typedef struct
 {
-    GFC_List   *map;      /**<the hash values*/
-    Uint32      size;    /**<how many values are available in the hash*/
-    Uint32      seed;    /**<the seed to calculate the hashed*/
-}GFC_HashMap;
+    GFC_HashMap *map;       /**<the map being walked*/
+    Uint32       start;     /**<iteration begins just after this empty slot, so clusters never wrap past the end*/
+    Uint32       step;      /**<how many slots past start have been walked*/
+    Uint32       keyOffset; /**<arena offset of the current key, used to spot that the current element was deleted*/
+    const char  *key;       /**<the key of the current element, NULL before the first or after the last*/
+    void        *value;     /**<the data of the current element*/
+}GFC_HashMapIter;
 
 /**
  * @brief allocate and initialize an empty hashmap
@@ -47,6 +84,46 @@ typedef struct
  */
 GFC_HashMap *gfc_hashmap_new();
 
+/**
+ * @brief allocate an empty hashmap with room for count keys before it needs to grow
+ * @param count how many keys to make room for
+ * @returns NULL on error or an empty hashmap otherwise
+ * @note must be freed with gfc_hashmap_free();
+ */
+GFC_HashMap *gfc_hashmap_new_reserve(Uint32 count);
+
+/**
+ * @brief grow the hashmap, if needed, so that it can hold count keys without resizing again
+ * @param map the map to grow
+ * @param count the total number of keys to make room for
+ */
+void gfc_hashmap_reserve(GFC_HashMap *map,Uint32 count);
+
+/**
+ * @brief the classic byte at a time djb2 hash (h * 33 + c).  Slow on long keys, kept for compatibility
+ */
+Uint32 gfc_hash_djb2(const char *key,size_t length,Uint32 seed);
+
+/**
+ * @brief hash that consumes the key 8 bytes at a time with a multiply / rotate mix (xxhash style)
+ * and a full avalanche at the end, so similar keys spread across the whole table.  The default for new hashmaps.
+ */
+Uint32 gfc_hash_fast(const char *key,size_t length,Uint32 seed);
+
+/**
+ * @brief change the hash function used by the map.  Any keys already in the map are rehashed
+ * @param map the map to change
+ * @param func the new hash function. If NULL this is a no-op
+ */
+void gfc_hashmap_set_hash_func(GFC_HashMap *map,gfc_hash_func *func);
+
+/**
+ * @brief change the seed used to hash keys.  Any keys already in the map are rehashed
+ * @param map the map to change
+ * @param seed the new seed
+ */
+void gfc_hashmap_set_seed(GFC_HashMap *map,Uint32 seed);
+
 /**
  * @brief free a previously allocated hashmap
  * @param map the hashmap to free
@@ -58,9 +135,20 @@ void gfc_hashmap_free(GFC_HashMap *map);
  * @param map the map to add a value to
  * @param key the key to retreive the data with
  * @param data the data to keep track of
+ * @note if the key is already in the map, its data is replaced.  The old data is not cleaned up
  */
 void gfc_hashmap_insert(GFC_HashMap *map,const char *key,void *data);
 
+/**
+ * @brief add many keys at once.  The table and key storage are sized once, then filled in a single pass
+ * @param map the map to add to
+ * @param keys array of count keys.  NULL keys are skipped
+ * @param values array of count values, keys[i] maps to values[i].  If NULL, every key maps to NULL
+ * @param count how many keys to add
+ * @note as with gfc_hashmap_insert, a key already in the map has its data replaced
+ */
+void gfc_hashmap_insert_batch(GFC_HashMap *map,const char **keys,void **values,Uint32 count);
+
 /**
  * @brief search the hashmap for the given key
  * @param map the map to searsh
@@ -68,6 +156,27 @@ void gfc_hashmap_insert(GFC_HashMap *map,const char *key,void *data);
  */
 void *gfc_hashmap_get(GFC_HashMap *map,const char *key);
 
+/**
+ * @brief hash a key the way the provided map will, to be used with gfc_hashmap_get_hashed
+ * @param map the map whose hash function and seed to use
+ * @param key the key to hash
+ * @param lengthOut [optional output] set to the length of the key
+ * @return the hash of the key, 0 on error
+ * @note the hash is only valid while the map's hash function and seed are unchanged
+ */
+Uint32 gfc_hashmap_hash_key(GFC_HashMap *map,const char *key,size_t *lengthOut);
+
+/**
+ * @brief search the hashmap for the given key, using a hash computed ahead of time.
+ * Saves rehashing and measuring constant keys that are looked up every frame
+ * @param map the map to search
+ * @param key the key to search by
+ * @param hash the hash of the key from gfc_hashmap_hash_key
+ * @param length the length of the key (not counting the null terminator)
+ * @return NULL if not found, the data otherwise
+ */
+void *gfc_hashmap_get_hashed(GFC_HashMap *map,const char *key,Uint32 hash,size_t length);
+
 /**
  * @brief delete a value out of the hashmap
  * @param map the map to delete a value from
@@ -75,10 +184,17 @@ void *gfc_hashmap_get(GFC_HashMap *map,const char *key);
  */
 void gfc_hashmap_delete_by_key(GFC_HashMap *map,const char *key);
 
+/**
+ * @brief get the number of keys stored in the hashmap
+ * @param map the map to check
+ * @return the number of keys, 0 if map is NULL
+ */
+Uint32 gfc_hashmap_get_count(GFC_HashMap *map);
+
 /**
  * @brief get a list of all of the values in the hashmap
  * @param map the map to extract the data from
- * @return NULL on bad map, or a list of the data otherwise.
+ * @return NULL on bad map, or a list of the data otherwise.  The list holds the data pointers that were inserted
  * @note: the list itself will need to be freed by gfc_list_delete
  * @note use this to clean up a hashmap before deleting it
  */
@@ -88,9 +204,59 @@ GFC_List *gfc_hashmap_get_all_values(GFC_HashMap *map);
  * @brief run a function on all values in a hashmap
  * @param map the hashmap to work on
  * @param func the function to be run on each item, it will be given each item from the hashmap
+ * @note func may delete the key of the item it was given, but must not add or delete other keys
  */
 void gfc_hashmap_foreach(GFC_HashMap *map, gfc_work_func func);
 
+/**
+ * @brief run a function on all values in a hashmap, passing along a context pointer
+ * @param map the hashmap to work on
+ * @param func the function to be run on each item, it will be given each item from the hashmap and the context
+ * @param context passed as the second argument to func
+ */
+void gfc_hashmap_foreach_context(GFC_HashMap *map, gfc_work_func_context func,void *context);
+
+/**
+ * @brief run a function on all values in a hashmap, spread across the worker threads of the thread pool
+ * @note see gfc_thread_pool.h: values are visited in no particular order, calls may run at the same time on different threads,
+ * and this returns only once every value has been handled.  No keys may be added or deleted until then
+ * @note runs serially if gfc_thread_pool_init has not been called
+ * @param map the hashmap to work on
+ * @param func the function to be run on each item, it will be given each item from the hashmap and the context
+ * @param context passed as the second argument to func
+ * @param grainSize how many table slots a thread takes at a time, 0 to pick automatically
+ */
+void gfc_hashmap_foreach_parallel(GFC_HashMap *map, gfc_work_func_context func,void *context,Uint32 grainSize);
+
+/**
+ * @brief set up an iterator to walk the provided map
+ * @param map the map to walk.  If NULL the iteration is empty
+ * @param iter [output] the iterator to initialize
+ * @note see GFC_HashMapIter for which changes to the map are safe during iteration
+ * @example
+ * GFC_HashMapIter it;
+ * gfc_hashmap_iter_begin(map,&it);
+ * while (gfc_hashmap_iter_next(&it))
+ * {
+ *     slog("%s",it.key);
+ * }
+ */
+void gfc_hashmap_iter_begin(GFC_HashMap *map,GFC_HashMapIter *iter);
+
+/**
+ * @brief advance the iterator to the next element in the map
+ * @param iter the iterator to advance
+ * @return 1 if iter->key and iter->value now refer to an element, 0 when iteration is done
+ */
+int gfc_hashmap_iter_next(GFC_HashMapIter *iter);
+
+/**
+ * @brief delete the element the iterator is currently on
+ * @note does not clean up the data stored with the key.  Continue with gfc_hashmap_iter_next as normal
+ * @param iter the iterator referring to the element to delete
+ */
+void gfc_hashmap_iter_delete(GFC_HashMapIter *iter);
+
 /**
  * @brief simple log the hash keys of the provided hashmap
  * @param map the map to print.  If NULL, this is a no op
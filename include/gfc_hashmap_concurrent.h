@@ -0,0 +1,134 @@
+#ifndef __GFC_HASHMAP_CONCURRENT_H__
+#define __GFC_HASHMAP_CONCURRENT_H__
+
+/**
+ * gfc_hashmap_concurrent
+ * @license The MIT License (MIT)
+   @copyright Copyright (c) 2024 EngineerOfLies
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <SDL.h>
+
+#include "gfc_types.h"
+#include "gfc_list.h"
+#include "gfc_hashmap.h"
+
+/**
+ * @purpose a read-mostly hashmap that may be read from any thread while another thread writes to it.
+ * Lookups never take a lock: they only count themselves in and out with an atomic.
+ * Writers are serialized by a mutex and publish each new slot with atomic stores, data first and key last,
+ * so a reader either sees a complete slot or an empty one.
+ * Growing the table builds a new table and swaps it in atomically.  The old table is retired and only freed
+ * once no lookups are in flight, so a reader that is still walking it stays safe.
+ * Meant for asset registries that a loader thread fills while the main thread looks things up by name.
+ * @note slots are linear probed (no robin hood displacement) because entries can not be moved under a reader.
+ * Deleted keys leave a tombstone until the next resize
+ * @note NULL data can not be stored, inserting NULL is the same as deleting the key
+ * @note key text is kept until the map is freed, so it suits registries more than maps with heavy churn
+ */
+
+typedef struct
+{
+    void       *key;    /**<NULL for an empty slot, otherwise the key entry.  Published last*/
+    void       *value;  /**<the data for the key, NULL once deleted*/
+    Uint32      hash;   /**<the hash of the key*/
+}GFC_ConcurrentSlot;
+
+typedef struct
+{
+    GFC_ConcurrentSlot *slots;  /**<the slots of the table*/
+    Uint32              size;   /**<how many slots, always a power of two*/
+    Uint32              used;   /**<how many slots have ever held a key, including tombstones*/
+}GFC_ConcurrentTable;
+
+typedef struct
+{
+    void           *table;      /**<the live GFC_ConcurrentTable, only ever accessed atomically*/
+    SDL_atomic_t    readers;    /**<how many lookups are in flight*/
+    SDL_mutex      *lock;       /**<serializes writers.  Readers never touch it*/
+    GFC_List       *retired;    /**<tables that were replaced and are waiting for readers to drain*/
+    GFC_List       *keyChunks;  /**<blocks of key text.  They never move so readers can hold on to keys*/
+    Uint32          chunkUsed;  /**<how much of the last key chunk is in use*/
+    Uint32          chunkSize;  /**<how big the last key chunk is*/
+    Uint32          count;      /**<how many live keys are stored*/
+    Uint32          seed;       /**<the seed to calculate the hashes*/
+}GFC_ConcurrentHashMap;
+
+/**
+ * @brief allocate and initialize an empty concurrent hashmap
+ * @returns NULL on error or an empty hashmap otherwise
+ * @note must be freed with gfc_hashmap_concurrent_free();
+ */
+GFC_ConcurrentHashMap *gfc_hashmap_concurrent_new();
+
+/**
+ * @brief free a concurrent hashmap
+ * @note NOT thread safe, every other thread must be done with the map.  The stored data is not freed
+ * @param map the map to free
+ */
+void gfc_hashmap_concurrent_free(GFC_ConcurrentHashMap *map);
+
+/**
+ * @brief add data to the map.  Safe to call from any thread, writers wait on each other but never on readers
+ * @param map the map to add to
+ * @param key the key to retrieve the data with
+ * @param data the data to keep track of.  If NULL, this deletes the key
+ * @note if the key is already in the map, its data is replaced.  The old data is not cleaned up
+ */
+void gfc_hashmap_concurrent_insert(GFC_ConcurrentHashMap *map,const char *key,void *data);
+
+/**
+ * @brief search the map for the given key.  Lock free, safe to call from any thread at any time
+ * @param map the map to search
+ * @param key the key to search by
+ * @return NULL if not found, the data otherwise
+ */
+void *gfc_hashmap_concurrent_get(GFC_ConcurrentHashMap *map,const char *key);
+
+/**
+ * @brief delete a key from the map.  Safe to call from any thread
+ * @note the data is not cleaned up.  A reader that already got the data may still be using it
+ * @param map the map to delete from
+ * @param key the key to delete
+ */
+void gfc_hashmap_concurrent_delete_by_key(GFC_ConcurrentHashMap *map,const char *key);
+
+/**
+ * @brief get the number of live keys in the map
+ * @param map the map to check
+ * @return the count, which may already be stale if another thread is writing
+ */
+Uint32 gfc_hashmap_concurrent_get_count(GFC_ConcurrentHashMap *map);
+
+/**
+ * @brief run a function on every value in the map.  Lock free like gfc_hashmap_concurrent_get
+ * @note walks a snapshot of the table, keys inserted while this runs may or may not be visited
+ * @param map the map to walk
+ * @param func the function to call with each value
+ * @param context passed as the second argument to func
+ */
+void gfc_hashmap_concurrent_foreach_context(GFC_ConcurrentHashMap *map, gfc_work_func_context func,void *context);
+
+/**
+ * @brief free any retired tables if no lookups are in flight.
+ * Writers already try this after each resize, call it at a quiet point (such as between frames) to catch the rest
+ * @param map the map to clean up
+ */
+void gfc_hashmap_concurrent_reclaim(GFC_ConcurrentHashMap *map);
+
+#endif
@@ -4,6 +4,7 @@
 #include <SDL.h>
 #include "gfc_text.h"
 #include "gfc_list.h"
+#include "gfc_intern.h"
 
 typedef enum
 {
@@ -105,6 +106,7 @@ typedef struct
 typedef struct
 {
     GFC_TextLine            name;           /**<the name of this command*/
+    GFC_Atom                atom;           /**<the interned name, for lookup.  GFC_ATOM_NONE if name was set by hand*/
     GFC_InputTriggerType    trigger;        /**<what it takes to trigger this input, combo or any*/
     GFC_List               *inputs;         /**<inputs that are part of the input*/
     int                     downCount;      /**<how many of the inputs are down*/
@@ -244,6 +246,14 @@ int gfc_input_get_active_controller_input(GFC_TextWord output,Uint8 controllerId
  */
 GFC_Command *gfc_command_get_by_name(const char *name);
 
+/**
+ * @brief get a command by its interned name
+ * @note commands whose atom is GFC_ATOM_NONE are never found this way, get them by name instead
+ * @param atom the atom of the command name, from gfc_intern()
+ * @return NULL if it doesn't exist, or a pointer to its data otherwise
+ */
+GFC_Command *gfc_command_get_by_atom(GFC_Atom atom);
+
 /**
  * @brief given the name of a command, get the first key input label
  * @note this doesn't really work for multiple key inputs
@@ -0,0 +1,89 @@
+#ifndef __GFC_INTERN_H__
+#define __GFC_INTERN_H__
+
+/**
+ * gfc_intern
+ * @license The MIT License (MIT)
+   @copyright Copyright (c) 2024 EngineerOfLies
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "gfc_types.h"
+
+/**
+ * @purpose string interning for identifiers.  Every distinct string is stored once and given a
+ * small integer atom.  The same text always gives the same atom for the life of the program,
+ * so names can be compared with == instead of strcmp.
+ * Command names, action names, sound files and channel groups keep an atom next to their name for fast lookup.
+ * @note safe to use from any thread, so loader threads may intern while the main thread looks names up.
+ * Lookups (gfc_intern_find) take no lock, adding a new string takes a mutex
+ */
+typedef Uint32 GFC_Atom;
+
+#define GFC_ATOM_NONE 0 /**<never given to any string*/
+
+/**
+ * @brief get the atom for a string, adding it to the table if it is new
+ * @param text the string to intern
+ * @return GFC_ATOM_NONE if text is NULL or on memory error, the atom otherwise
+ */
+GFC_Atom gfc_intern(const char *text);
+
+/**
+ * @brief get the atom for a string only if it has already been interned
+ * @note use this for lookups so searching for names that do not exist does not grow the table
+ * @param text the string to look for
+ * @return GFC_ATOM_NONE if the string has never been interned, the atom otherwise
+ */
+GFC_Atom gfc_intern_find(const char *text);
+
+/**
+ * @brief get the atom for a string, ignoring case.  "Music" and "music" give the same atom
+ * @note these atoms belong to the lower case form of the text, so they only match other _nocase atoms
+ * and case sensitive atoms of already lower case text
+ * @param text the string to intern
+ * @return GFC_ATOM_NONE if text is NULL or on memory error, the atom otherwise
+ */
+GFC_Atom gfc_intern_nocase(const char *text);
+
+/**
+ * @brief case insensitive version of gfc_intern_find
+ * @param text the string to look for
+ * @return GFC_ATOM_NONE if the string has never been interned, the atom otherwise
+ */
+GFC_Atom gfc_intern_find_nocase(const char *text);
+
+/**
+ * @brief get the text an atom was made from
+ * @param atom the atom to look up
+ * @return NULL if the atom is not valid, the interned string otherwise.  It stays valid until gfc_intern_close
+ */
+const char *gfc_intern_text(GFC_Atom atom);
+
+/**
+ * @brief get how many strings have been interned
+ * @return the count
+ */
+Uint32 gfc_intern_get_count();
+
+/**
+ * @brief free the intern table.  Called automatically at exit
+ * @note every atom handed out before this becomes invalid
+ */
+void gfc_intern_close();
+
+#endif
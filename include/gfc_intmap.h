@@ -0,0 +1,169 @@
+#ifndef __GFC_INTMAP_H__
+#define __GFC_INTMAP_H__
+
+/**
+ * gfc_intmap
+ * @license The MIT License (MIT)
+   @copyright Copyright (c) 2024 EngineerOfLies
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "gfc_types.h"
+#include "gfc_list.h"
+
+/**
+ * @purpose the GFC_IntMap is the companion to GFC_HashMap for integer and pointer keys.
+ * Keys are stored inline as 64 bit values and hashed with a single multiply, so entity ids,
+ * scancodes and addresses can be looked up without formatting them into strings.
+ * It uses the same robin hood open addressing and backward shift deletion as GFC_HashMap.
+ */
+typedef struct
+{
+    Uint32     *hashes;     /**<the hash of the key in each slot, 0 marks an empty slot*/
+    Uint64     *keys;       /**<the key in each slot*/
+    void      **values;     /**<the data stored in each slot*/
+    Uint32      size;       /**<how many slots are in the table, always a power of two*/
+    Uint32      shift;      /**<32 - log2(size), the home slot of a hash is hash >> shift*/
+    Uint32      count;      /**<how many elements are stored in the table*/
+}GFC_IntMap;
+
+/**
+ * @brief cursor for walking the elements of an intmap in place.
+ * @note follows the same rules as GFC_HashMapIter: changing data of existing keys and deleting the
+ * CURRENT element are safe, inserting or deleting any other key is not
+ */
+typedef struct
+{
+    GFC_IntMap *map;        /**<the map being walked*/
+    Uint32      start;      /**<iteration begins just after this empty slot*/
+    Uint32      step;       /**<how many slots past start have been walked*/
+    Uint8       valid;      /**<true when key and value refer to an element*/
+    Uint64      key;        /**<the key of the current element*/
+    void       *value;      /**<the data of the current element*/
+}GFC_IntMapIter;
+
+/**
+ * @brief convert a pointer into an intmap key
+ */
+#define gfc_intmap_ptr_key(ptr) ((Uint64)(size_t)(ptr))
+
+/**
+ * @brief allocate and initialize an empty intmap
+ * @returns NULL on error or an empty intmap otherwise
+ * @note must be freed with gfc_intmap_free();
+ */
+GFC_IntMap *gfc_intmap_new();
+
+/**
+ * @brief allocate an empty intmap with room for count keys before it needs to grow
+ * @param count how many keys to make room for
+ * @returns NULL on error or an empty intmap otherwise
+ */
+GFC_IntMap *gfc_intmap_new_size(Uint32 count);
+
+/**
+ * @brief free a previously allocated intmap
+ * @note does not free the data stored in the map
+ * @param map the intmap to free
+ */
+void gfc_intmap_free(GFC_IntMap *map);
+
+/**
+ * @brief add data to the intmap
+ * @param map the map to add a value to
+ * @param key the key to retreive the data with
+ * @param data the data to keep track of
+ * @note if the key is already in the map, its data is replaced.  The old data is not cleaned up
+ */
+void gfc_intmap_insert(GFC_IntMap *map,Uint64 key,void *data);
+
+/**
+ * @brief search the intmap for the given key
+ * @param map the map to search
+ * @param key the key to search by
+ * @return NULL if not found, the data otherwise
+ */
+void *gfc_intmap_get(GFC_IntMap *map,Uint64 key);
+
+/**
+ * @brief check if a key is in the map, useful when NULL data is stored
+ * @param map the map to search
+ * @param key the key to search by
+ * @return 1 if found, 0 otherwise
+ */
+int gfc_intmap_has_key(GFC_IntMap *map,Uint64 key);
+
+/**
+ * @brief delete a value out of the intmap
+ * @param map the map to delete a value from
+ * @param key the key to the value to be deleted
+ */
+void gfc_intmap_delete_by_key(GFC_IntMap *map,Uint64 key);
+
+/**
+ * @brief get the number of keys stored in the intmap
+ * @param map the map to check
+ * @return the number of keys, 0 if map is NULL
+ */
+Uint32 gfc_intmap_get_count(GFC_IntMap *map);
+
+/**
+ * @brief get a list of all of the values in the intmap
+ * @param map the map to extract the data from
+ * @return NULL on bad map, or a list of the data otherwise.
+ * @note: the list itself will need to be freed by gfc_list_delete
+ */
+GFC_List *gfc_intmap_get_all_values(GFC_IntMap *map);
+
+/**
+ * @brief run a function on all values in an intmap
+ * @param map the intmap to work on
+ * @param func the function to be run on each item
+ * @note func may delete the key of the item it was given, but must not add or delete other keys
+ */
+void gfc_intmap_foreach(GFC_IntMap *map, gfc_work_func func);
+
+/**
+ * @brief run a function on all values in an intmap, passing along a context pointer
+ * @param map the intmap to work on
+ * @param func the function to be run on each item, it will be given each item and the context
+ * @param context passed as the second argument to func
+ */
+void gfc_intmap_foreach_context(GFC_IntMap *map, gfc_work_func_context func,void *context);
+
+/**
+ * @brief set up an iterator to walk the provided map
+ * @param map the map to walk.  If NULL the iteration is empty
+ * @param iter [output] the iterator to initialize
+ */
+void gfc_intmap_iter_begin(GFC_IntMap *map,GFC_IntMapIter *iter);
+
+/**
+ * @brief advance the iterator to the next element in the map
+ * @param iter the iterator to advance
+ * @return 1 if iter->key and iter->value now refer to an element, 0 when iteration is done
+ */
+int gfc_intmap_iter_next(GFC_IntMapIter *iter);
+
+/**
+ * @brief delete the element the iterator is currently on
+ * @note does not clean up the data stored with the key.  Continue with gfc_intmap_iter_next as normal
+ * @param iter the iterator referring to the element to delete
+ */
+void gfc_intmap_iter_delete(GFC_IntMapIter *iter);
+
+#endif
@@ -19,6 +19,18 @@ typedef void gfc_work_func_context(void*,void*);/**<prototype for a work functio
  */
 typedef int  gfc_compare_func(void*,void*);/**<prototype for a compare function for sorting*/
 
+/**
+ * @brief to be used in gfc_list_sort_context
+ * @note same as gfc_compare_func, the third parameter is the context provided to the sort (like qsort_r)
+ */
+typedef int  gfc_compare_func_context(void*,void*,void*);/**<prototype for a compare function for sorting with context*/
+
+/**
+ * @brief to be used in gfc_list_remove_if
+ * @note It must return non-zero if the data (first parameter) should be removed.  The second parameter is the context
+ */
+typedef int  gfc_predicate_func(void*,void*);/**<prototype for a test function*/
+
 typedef struct
 {
     void *data;
@@ -27,12 +39,19 @@ typedef struct
 /**
  * @brief the GFC GFC_List is an automatically expanding general purpose list
  * the list stores data in contiguous memory
+ * Deleting the first element is O(1): the list just starts one element later and the freed slot
+ * is kept in front (head) for later prepends.  In deque mode the list also keeps room in front when
+ * it grows, so both prepend and append are amortized O(1).  elements[0] through elements[count-1]
+ * are always the contents of the list.
  */
 typedef struct
 {
-    GFC_ListElementData *elements;
-    Uint32 size;
-    Uint32 count;
+    GFC_ListElementData *elements;  /**<the first element of the list, may be past the start of the allocation*/
+    Uint32 size;                    /**<how many elements fit from elements on*/
+    Uint32 count;                   /**<how many elements are in the list*/
+    Uint32 head;                    /**<how many unused elements are allocated in front of elements*/
+    float  growth;                  /**<how much the list grows by when it is full, 0 uses the default of 2x*/
+    Uint8  deque;                   /**<if true, growing also keeps room at the front for prepends*/
 }GFC_List;
 
 /**
@@ -71,6 +90,15 @@ void gfc_list_delete(GFC_List *list);
  */
 void gfc_list_clear(GFC_List *list);
 
+/**
+ * @brief make sure the list can hold count elements without growing
+ * @note use before adding many elements (or merging large lists) so the storage is only reallocated once
+ * @param list the list to grow
+ * @param count the number of elements to make room for
+ * @return 0 on memory error, 1 otherwise
+ */
+int gfc_list_reserve(GFC_List *list,Uint32 count);
+
 /**
  * @brief get the data stored at the nth element
  * @param list the list to pull data from
@@ -101,7 +129,7 @@ void gfc_list_append(GFC_List *list,void *data);
 
 /**
  * @brief add an element to the beginning of the list
- * @note must catch the returned list to replace the list you had
+ * @note O(1) if there is room in front of the list (see gfc_list_set_deque), otherwise all elements are shifted
  * @param list the list to add to
  * @param data the data to assign to the new element
  */
@@ -124,6 +152,21 @@ void gfc_list_insert(GFC_List *list,void *data,Uint32 n);
  */
 int gfc_list_delete_nth(GFC_List *list,Uint32 n);
 
+/**
+ * @brief delete the first item in the list
+ * @note O(1), the list just starts one element later
+ * @param list the list to delete from;
+ * @return 0 if all is well, -1 on error
+ */
+int gfc_list_delete_first(GFC_List *list);
+
+/**
+ * @brief when treating the list like a queue, remove and return the first element
+ * @param list the list to pop from
+ * @return NULL if the list is NULL or empty, the first data element otherwise
+ */
+void *gfc_list_pop_first(GFC_List *list);
+
 /**
  * @brief delete the item at the end of the list
  * @note this does not clean up the information that the list is referring to
@@ -141,6 +184,35 @@ int gfc_list_delete_last(GFC_List *list);
  */
 int gfc_list_delete_data(GFC_List *list,void *data);
 
+/**
+ * @brief delete the element at the nth position by moving the last element into its place
+ * @note O(1), but the order of the list is not preserved.  Does not clean up the data
+ * @param list the list to delete out of
+ * @param n the element to delete
+ * @return -1 on error, 0 otherwise
+ */
+int gfc_list_delete_nth_unordered(GFC_List *list,Uint32 n);
+
+/**
+ * @brief delete the first element pointing to data by moving the last element into its place
+ * @note the order of the list is not preserved.  Does not delete the data itself
+ * @param list the list to delete the element from
+ * @param data used to match against which element to delete
+ * @return -1 on error or not found, 0 otherwise
+ */
+int gfc_list_delete_data_unordered(GFC_List *list,void *data);
+
+/**
+ * @brief delete every element that the predicate says to, compacting the list in a single pass
+ * @note the order of the remaining elements is preserved.  Does not clean up the removed data,
+ * do that in the predicate if needed
+ * @param list the list to filter
+ * @param predicate called with each element's data and context.  Return non-zero to remove the element
+ * @param context passed as the second argument to predicate
+ * @return the number of elements removed
+ */
+Uint32 gfc_list_remove_if(GFC_List *list,gfc_predicate_func *predicate,void *context);
+
 /**
  * @brief search the list for the given item
  * @param list the list to search
@@ -149,6 +221,27 @@ int gfc_list_delete_data(GFC_List *list,void *data);
  */
 int gfc_list_get_item_index(GFC_List *list,void *data);
 
+/**
+ * @brief set how much the list grows by each time it runs out of room
+ * @param list the list to configure
+ * @param growth the factor to multiply the size by. 2.0 (the default) doubles it.  Values <= 1 restore the default
+ */
+void gfc_list_set_growth(GFC_List *list,float growth);
+
+/**
+ * @brief turn deque mode on or off.  In deque mode the list keeps room at the front when it grows,
+ * so gfc_list_prepend is amortized O(1) like gfc_list_append.  Use this for queues that push to the front
+ * @param list the list to configure
+ * @param deque true to enable, false to disable
+ */
+void gfc_list_set_deque(GFC_List *list,Uint8 deque);
+
+/**
+ * @brief release any memory the list is holding beyond what it needs for its current elements
+ * @param list the list to shrink
+ */
+void gfc_list_shrink_to_fit(GFC_List *list);
+
 /**
  * @brief get the number of tracked elements in the list
  * @param list the list the check
@@ -174,6 +267,18 @@ void gfc_list_foreach(GFC_List *list,void (*function)(void *data));
  */
 void gfc_list_foreach_context(GFC_List *list,void (*function)(void *data,void *context),void *contextData);
 
+/**
+ * @brief call the function provided on each element, spread across the worker threads of the thread pool
+ * @note see gfc_thread_pool.h: there is no ordering between elements, calls may run at the same time on different threads,
+ * and this returns only once every element has been handled.  The list must not be changed until then
+ * @note runs serially if gfc_thread_pool_init has not been called
+ * @param list the list to iterate over
+ * @param function called with each data element and contextData
+ * @param contextData passed as the second argument to function
+ * @param grainSize how many elements a thread takes at a time, 0 to pick automatically
+ */
+void gfc_list_foreach_parallel(GFC_List *list,gfc_work_func_context *function,void *contextData,Uint32 grainSize);
+
 /**
  * @brief swap the locations of two items in the list.
  * @param list the list to alter
@@ -203,12 +308,37 @@ GFC_List *gfc_list_concat_free(GFC_List *a,GFC_List *b);
 
 /**
  * @brief perform a sort on the provided list.
- * @note This uses the merge sort algorithm.  It will end up created log(n) more lists in memory but not duplicate the data.
+ * @note This uses introsort in place and allocates nothing.  It is NOT stable, items that compare equal may change order.
+ * Use gfc_list_sort_stable if that matters
  * @param list the list to sort. This list will be sorted if this is successful
  * @param compar the comparison function,gfc_compare_func can be used as a prototype.  It must return < 0 if the left should be before the right, or > 0 if right should be before the left, 0 if they are equal priority (like strcmp)
  */
 void gfc_list_sort(GFC_List *list,int (*compare)(void *a,void *b));
 
+/**
+ * @brief same as gfc_list_sort, but compare is also given a context pointer (like qsort_r)
+ * @param list the list to sort
+ * @param compare the comparison function, see gfc_compare_func_context
+ * @param context passed as the third argument to compare
+ */
+void gfc_list_sort_context(GFC_List *list,gfc_compare_func_context *compare,void *context);
+
+/**
+ * @brief perform a stable sort on the provided list.  Items that compare equal keep their order
+ * @note This uses merge sort with a single scratch buffer the size of the list
+ * @param list the list to sort
+ * @param compare the comparison function, see gfc_list_sort
+ */
+void gfc_list_sort_stable(GFC_List *list,int (*compare)(void *a,void *b));
+
+/**
+ * @brief same as gfc_list_sort_stable, but compare is also given a context pointer (like qsort_r)
+ * @param list the list to sort
+ * @param compare the comparison function, see gfc_compare_func_context
+ * @param context passed as the third argument to compare
+ */
+void gfc_list_sort_stable_context(GFC_List *list,gfc_compare_func_context *compare,void *context);
+
 /**
  * @brief whean treating the list like a stack, this will peek the top (last) element in the stack.
  * @param stack the list being used as a stack
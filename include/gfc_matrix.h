@@ -45,6 +45,25 @@ Uint8 gfc_matrix2_invert(GFC_Matrix4 out, GFC_Matrix4 in);
 Uint8 gfc_matrix3_invert(GFC_Matrix4 out, GFC_Matrix4 in);
 Uint8 gfc_matrix4_invert(GFC_Matrix4 out, GFC_Matrix4 in);
 
+/**
+ * @brief invert an affine matrix: rotation, scale and shear in the upper 3x3 and translation in the bottom row.
+ * Much cheaper than gfc_matrix4_invert for model and bone transforms
+ * @note the last column must be 0,0,0,1, which is true for anything built from translate, rotate and scale
+ * @param out the resulting inverse matrix, may be the same as in
+ * @param in the matrix to invert
+ * @return 1 on success, 0 if the matrix has no inverse.  On 0, out will not be changed
+ */
+Uint8 gfc_matrix4_invert_affine(GFC_Matrix4 out, GFC_Matrix4 in);
+
+/**
+ * @brief invert a rigid transform: rotation and translation only, no scale.  Cheapest of the inverses,
+ * suited to view matrices from gfc_matrix4_view
+ * @note gives a wrong answer if the matrix is scaled or is not affine, use gfc_matrix4_invert_affine for those
+ * @param out the resulting inverse matrix, may be the same as in
+ * @param in the matrix to invert
+ */
+void gfc_matrix4_invert_rigid(GFC_Matrix4 out, GFC_Matrix4 in);
+
 /**
  * @brief create a translation matrix given the gfc_vector
  * @param out the output matrix, the contents of this matrix are overwritten
@@ -144,6 +163,17 @@ void gfc_matrix4_multiply(
     GFC_Matrix4 b
   );
 
+/**
+ * @brief multiply a list of matrices together in one pass, with no temporary matrices between steps
+ * @note result = matrices[0] * matrices[1] * ... * matrices[count - 1], so for v * M the first is applied first
+ * @example GFC_Matrix4 *chain[] = {&model,&view,&projection};
+ *          gfc_matrix4_multiply_chain(mvp,chain,3);
+ * @param out the output matrix, may be one of the inputs
+ * @param matrices an array of count pointers to matrices
+ * @param count how many matrices to multiply, if zero out is set to the identity
+ */
+void gfc_matrix4_multiply_chain(GFC_Matrix4 out,GFC_Matrix4 **matrices,Uint32 count);
+
 /**
  * @brief multiply a gfc_vector by the matrix, v * M
  * @param out a pointer to the gfc_vector that will hold the result
@@ -164,6 +194,26 @@ void gfc_matrix2_multiply_v(GFC_Vector2D * out,GFC_Matrix2 mat,GFC_Vector2D vec)
 void gfc_matrix3_multiply_v(GFC_Vector3D * out,GFC_Matrix3 mat,GFC_Vector3D vec);
 void gfc_matrix4_multiply_v(GFC_Vector4D * out,GFC_Matrix4 mat,GFC_Vector4D vec);
 
+/**
+ * @brief transform many points at once, as gfc_matrix4_v_multiply would with w = 1 (so translation applies)
+ * @note the resulting w is dropped, no perspective divide is done
+ * @param out where to write the transformed points, may be the same arrays as in
+ * @param in the points to transform
+ * @param mat the transform
+ * @param count how many points are in the arrays
+ */
+void gfc_vector3d_batch_transform(GFC_Vector3DBatch out,GFC_Vector3DBatch in,GFC_Matrix4 mat,Uint32 count);
+
+/**
+ * @brief transform many directions at once, as gfc_matrix4_v_multiply would with w = 0 (so translation is ignored)
+ * @note for normals under non-uniform scale, pass the inverse transpose of the transform
+ * @param out where to write the transformed directions, may be the same arrays as in
+ * @param in the directions to transform
+ * @param mat the transform
+ * @param count how many directions are in the arrays
+ */
+void gfc_vector3d_batch_transform_direction(GFC_Vector3DBatch out,GFC_Vector3DBatch in,GFC_Matrix4 mat,Uint32 count);
+
 
 /**
  * @brief create a transformation matrix from the three basic operation gfc_vectors
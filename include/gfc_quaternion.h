@@ -0,0 +1,162 @@
+#ifndef __GFC_QUATERNION_H__
+#define __GFC_QUATERNION_H__
+
+#include "gfc_vector.h"
+#include "gfc_matrix.h"
+
+/**
+ * @purpose unit quaternions for rotation.  Composing, blending and applying rotations this way costs a handful
+ * of multiply-adds, where the Euler angle and matrix paths cost full 4x4 multiplies and trig for every step.
+ * x,y,z is the vector part and w is the scalar part.  The identity rotation is (0,0,0,1).
+ * GFC_Quaternion shares its layout with GFC_Vector4D, so it can be handed straight to gfc_matrix4_from_quaternion
+ * and gfc_matrix4_from_vectors_q, and the gfc_vector4d macros work on it.
+ * @note unless noted otherwise, functions expect unit quaternions.  Normalize anything built by hand.
+ */
+typedef GFC_Vector4D GFC_Quaternion;
+
+/**
+ * @brief make a quaternion from its components
+ * @param x,y,z the vector part
+ * @param w the scalar part
+ * @return the quaternion, not normalized
+ */
+GFC_Quaternion gfc_quaternion(float x,float y,float z,float w);
+
+/**
+ * @brief get the quaternion for no rotation
+ * @return (0,0,0,1)
+ */
+GFC_Quaternion gfc_quaternion_identity();
+
+/**
+ * @brief make a rotation about an axis
+ * @param axis the axis to rotate about, does not need to be normalized
+ * @param radians how far to rotate, counter clockwise looking down the axis
+ * @return the rotation, or the identity if axis is zero length
+ */
+GFC_Quaternion gfc_quaternion_from_axis_angle(GFC_Vector3D axis,float radians);
+
+/**
+ * @brief get the axis and angle of a rotation
+ * @param q the rotation
+ * @param axis if provided, set to the unit axis.  Set to (0,0,1) for the identity
+ * @param radians if provided, set to the angle in the range [0,2pi]
+ */
+void gfc_quaternion_to_axis_angle(GFC_Quaternion q,GFC_Vector3D *axis,float *radians);
+
+/**
+ * @brief make the same rotation that gfc_matrix4_rotate_by_vector and gfc_matrix4_from_vectors apply
+ * @param rotation euler angles in radians, using the same component order as gfc_matrix4_rotate_by_vector
+ * @return the rotation
+ */
+GFC_Quaternion gfc_quaternion_from_euler(GFC_Vector3D rotation);
+
+/**
+ * @brief get the rotation part of a matrix
+ * @param mat a rotation matrix, or rotation and translation.  Scale must be removed first
+ * @return the rotation as a unit quaternion
+ */
+GFC_Quaternion gfc_quaternion_from_matrix4(GFC_Matrix4 mat);
+
+/**
+ * @brief build a rotation matrix, same as gfc_matrix4_from_quaternion
+ * @param out the resulting matrix
+ * @param q the rotation
+ */
+void gfc_quaternion_to_matrix4(GFC_Matrix4 out,GFC_Quaternion q);
+
+/**
+ * @brief combine two rotations
+ * @note out = a * b, which applies b first and then a.
+ * The matrix of the result is the matrix of b times the matrix of a, to match gfc_matrix4_multiply
+ * @param a the rotation applied second
+ * @param b the rotation applied first
+ * @return the combined rotation
+ */
+GFC_Quaternion gfc_quaternion_multiply(GFC_Quaternion a,GFC_Quaternion b);
+
+/**
+ * @brief get the conjugate of a quaternion.  For a unit quaternion this is the inverse rotation
+ * @param q the quaternion
+ * @return (-x,-y,-z,w)
+ */
+GFC_Quaternion gfc_quaternion_conjugate(GFC_Quaternion q);
+
+/**
+ * @brief get the inverse of any non zero quaternion
+ * @param q the quaternion
+ * @return the inverse, or the identity if q is zero
+ */
+GFC_Quaternion gfc_quaternion_inverse(GFC_Quaternion q);
+
+/**
+ * @brief get the dot product of two quaternions, the cosine of half the angle between two unit rotations
+ */
+float gfc_quaternion_dot(GFC_Quaternion a,GFC_Quaternion b);
+
+/**
+ * @brief scale a quaternion to unit length
+ * @param q the quaternion
+ * @return the unit quaternion, or the identity if q is zero
+ */
+GFC_Quaternion gfc_quaternion_normalize(GFC_Quaternion q);
+
+/**
+ * @brief rotate a vector
+ * @note same result as gfc_matrix4_v_multiply with the matrix of q and w = 0
+ * @param q the rotation
+ * @param v the vector to rotate
+ * @return the rotated vector
+ */
+GFC_Vector3D gfc_quaternion_rotate_vector(GFC_Quaternion q,GFC_Vector3D v);
+
+/**
+ * @brief blend two rotations by a normalized linear interpolation, always along the shorter path
+ * @note much cheaper than slerp.  The speed is not constant over t, but is close for small angles, as between
+ * animation key frames
+ * @param a the rotation at t = 0
+ * @param b the rotation at t = 1
+ * @param t how far to blend, usually 0 to 1
+ * @return the blended unit rotation
+ */
+GFC_Quaternion gfc_quaternion_nlerp(GFC_Quaternion a,GFC_Quaternion b,float t);
+
+/**
+ * @brief blend two rotations at a constant angular speed, along the shorter path
+ * @note falls back to nlerp when the rotations are nearly the same, where the two agree
+ * @param a the rotation at t = 0
+ * @param b the rotation at t = 1
+ * @param t how far to blend, usually 0 to 1
+ * @return the blended unit rotation
+ */
+GFC_Quaternion gfc_quaternion_slerp(GFC_Quaternion a,GFC_Quaternion b,float t);
+
+/**
+ * @brief out[i] = a[i] * b[i] for count quaternions, as for composing the bones of a skeleton
+ * @note out may be the same array as a or b
+ */
+void gfc_quaternion_batch_multiply(GFC_Quaternion *out,const GFC_Quaternion *a,const GFC_Quaternion *b,Uint32 count);
+
+/**
+ * @brief nlerp count pairs of rotations by the same t, as for blending two animation poses
+ * @note out may be the same array as a or b
+ */
+void gfc_quaternion_batch_nlerp(GFC_Quaternion *out,const GFC_Quaternion *a,const GFC_Quaternion *b,float t,Uint32 count);
+
+/**
+ * @brief slerp count pairs of rotations by the same t
+ * @note out may be the same array as a or b
+ */
+void gfc_quaternion_batch_slerp(GFC_Quaternion *out,const GFC_Quaternion *a,const GFC_Quaternion *b,float t,Uint32 count);
+
+/**
+ * @brief rotate many vectors by the same rotation.
+ * The rotation is turned into a 3x3 matrix once, which is cheaper per vector than the quaternion formula
+ * @param out where to write the results, may be the same arrays as in
+ * @param in the vectors to rotate
+ * @param q the rotation
+ * @param count how many vectors
+ */
+void gfc_quaternion_batch_rotate(GFC_Vector3DBatch out,GFC_Vector3DBatch in,GFC_Quaternion q,Uint32 count);
+
+#endif
@@ -8,25 +8,36 @@
 #include "gfc_vector.h"
 #include "gfc_color.h"
 #include "gfc_list.h"
+#include "gfc_array.h"
 
 
 /**
  * @purpose gfc_shapes is meant to provide a common way to represent simple 2D shapes and test collisions based on them
  */
 
+/**
+ * @brief the type of every shape coordinate.  float by default to match GFC_Vector2D, so the collision code
+ * does not convert back and forth.  Build with GFC_SHAPE_DOUBLE defined (-DGFC_SHAPE_DOUBLE) for double precision
+ */
+#ifdef GFC_SHAPE_DOUBLE
+typedef double GFC_ShapeFloat;
+#else
+typedef float GFC_ShapeFloat;
+#endif
+
 typedef struct
 {
-    double x1,y1,x2,y2;
+    GFC_ShapeFloat x1,y1,x2,y2;
 }GFC_Edge2D;
 
 typedef struct
 {
-    double       x,y,r;
+    GFC_ShapeFloat       x,y,r;
 }GFC_Circle;
 
 typedef struct
 {
-    double x,y,w,h;
+    GFC_ShapeFloat x,y,w,h;
 }GFC_Rect;
 
 typedef enum
@@ -48,6 +59,57 @@ typedef struct
     }s;
 }GFC_Shape;
 
+/**
+ * @brief structure of arrays storage for many shapes, for testing one shape against all of them at once.
+ * Each kind of shape has its own set of float arrays, one per coordinate, so the tests run down contiguous
+ * memory and the rect and circle tests vectorize.
+ * Shapes are tagged with an id when added, which is what the queries report back
+ * @note the batch always stores float, so in GFC_SHAPE_DOUBLE builds shapes that exactly touch may disagree with
+ * gfc_shape_overlap
+ */
+typedef struct
+{
+    Uint32  count;          /**<how many rects are stored*/
+    Uint32  size;           /**<how many rects fit before the arrays grow*/
+    Uint32 *id;             /**<the id each rect was added with*/
+    float  *x,*y,*w,*h;
+}GFC_RectBatch;
+
+typedef struct
+{
+    Uint32  count;
+    Uint32  size;
+    Uint32 *id;
+    float  *x,*y,*r;
+}GFC_CircleBatch;
+
+typedef struct
+{
+    Uint32  count;
+    Uint32  size;
+    Uint32 *id;
+    float  *x1,*y1,*x2,*y2;
+}GFC_EdgeBatch;
+
+typedef struct
+{
+    GFC_RectBatch   rects;
+    GFC_CircleBatch circles;
+    GFC_EdgeBatch   edges;
+}GFC_ShapeBatch;
+
+/**
+ * @brief the nearest hit of a raycast
+ */
+typedef struct
+{
+    Uint8           hit;        /**<1 if the ray hit anything.  If 0 the fraction is 1 and the rest is zero*/
+    Uint32          id;         /**<which shape was hit, see the raycast function for what the id refers to*/
+    float           fraction;   /**<how far along the ray the hit is, from 0 at (x1,y1) to 1 at (x2,y2)*/
+    GFC_Vector2D    poc;        /**<the point of contact*/
+    GFC_Vector2D    normal;     /**<the unit surface normal of the shape at the point of contact*/
+}GFC_RaycastHit;
+
 /**
  * @brief macro to set an sdl rect.  should work with any data structure with elements x,y,w,h
  * @param r the rect to set
@@ -563,6 +625,26 @@ GFC_List *gfc_shape_get_bezier_point_list_2d(GFC_Vector2D p0, GFC_Vector2D p1, G
  */
 GFC_List *gfc_shape_get_bezier_point_list_3d(GFC_Vector3D p0, GFC_Vector3D p1, GFC_Vector3D p2,Uint32 count);
 
+/**
+ * @brief get the points that describe a bezier curve bound by the 3 points provided in 2D, stored by value
+ * @param p0 a point bounding the curve
+ * @param p1 a point bounding the curve
+ * @param p2 a point bounding the curve
+ * @param count how many segments to split the curve into, count + 1 points are produced
+ * @return NULL on error or an array of GFC_Vector2D.  Free it with gfc_array_delete
+ */
+GFC_Array *gfc_shape_get_bezier_point_array_2d(GFC_Vector2D p0, GFC_Vector2D p1, GFC_Vector2D p2,Uint32 count);
+
+/**
+ * @brief get the points that describe a bezier curve bound by the 3 points provided in 3D, stored by value
+ * @param p0 a point bounding the curve
+ * @param p1 a point bounding the curve
+ * @param p2 a point bounding the curve
+ * @param count how many segments to split the curve into, count + 1 points are produced
+ * @return NULL on error or an array of GFC_Vector3D.  Free it with gfc_array_delete
+ */
+GFC_Array *gfc_shape_get_bezier_point_array_3d(GFC_Vector3D p0, GFC_Vector3D p1, GFC_Vector3D p2,Uint32 count);
+
 /**
  * @brief free a point list, works for both 2d and 3d
  * @param list the list of points (as created from above) to delete
@@ -570,4 +652,79 @@ GFC_List *gfc_shape_get_bezier_point_list_3d(GFC_Vector3D p0, GFC_Vector3D p1, G
  */
 void gfc_shape_point_list_free(GFC_List *list);
 
+/**
+ * @brief allocate a new empty shape batch
+ * @return NULL on memory error or the new batch.  Free it with gfc_shape_batch_free
+ */
+GFC_ShapeBatch *gfc_shape_batch_new();
+
+/**
+ * @brief free a shape batch and all of its arrays
+ * @param batch the batch to free
+ */
+void gfc_shape_batch_free(GFC_ShapeBatch *batch);
+
+/**
+ * @brief remove all shapes from the batch, keeping its memory for reuse
+ * @param batch the batch to clear
+ */
+void gfc_shape_batch_clear(GFC_ShapeBatch *batch);
+
+/**
+ * @brief add a copy of a shape to the batch
+ * @param batch the batch to add to
+ * @param shape the shape to add
+ * @param id reported by gfc_shape_batch_overlap when this shape is hit, such as an index into the caller's entities
+ * @return 0 on error, 1 otherwise
+ */
+int gfc_shape_batch_add(GFC_ShapeBatch *batch,GFC_Shape shape,Uint32 id);
+
+/**
+ * @brief get the number of shapes of all kinds in the batch
+ * @param batch the batch to check
+ * @return the count, 0 if batch is NULL
+ */
+Uint32 gfc_shape_batch_get_count(GFC_ShapeBatch *batch);
+
+/**
+ * @brief test one shape against every shape in the batch, same rules as gfc_shape_overlap
+ * @note rects and circles are tested a block at a time with vectorized loops.
+ * Edges, and any test against an edge query, use the regular per shape tests
+ * @param batch the batch to test against
+ * @param shape the shape to test
+ * @param hits where to write the ids of the overlapping shapes.  Rects are reported first, then circles, then edges
+ * @param maxHits how many ids hits can hold, testing stops once it is full
+ * @return how many ids were written to hits
+ */
+Uint32 gfc_shape_batch_overlap(GFC_ShapeBatch *batch,GFC_Shape shape,Uint32 *hits,Uint32 maxHits);
+
+/**
+ * @brief find where a ray first meets a shape, from (x1,y1) to (x2,y2) of the edge
+ * @note rects and circles are solid.  A ray that starts inside one hits where it comes out, and one that
+ * lies entirely inside hits nothing, the same as gfc_edge_rect_intersection_poc.
+ * Rect normals point straight out of the face that was hit, circle normals point away from the center,
+ * and edge normals are perpendicular to the edge on the side the ray came from
+ * @param ray the segment to cast
+ * @param shape the shape to test
+ * @param hit if provided, set to the hit.  The id is set to 0
+ * @return 1 if the ray hits the shape, 0 otherwise
+ */
+Uint8 gfc_raycast_shape(GFC_Edge2D ray,GFC_Shape shape,GFC_RaycastHit *hit);
+
+/**
+ * @brief cast many rays against every shape in a batch, finding the nearest hit for each, as for line of sight
+ * checks from many agents against the same walls
+ * @note the shapes are tested a block at a time with vectorized loops.  Only blocks that have something
+ * nearer than the best hit so far are searched for which shape it was, and once a ray hits something
+ * farther shapes are cheap to reject.
+ * For a scene too big to test every shape against every ray, see gfc_aabb_tree_raycast_batch
+ * @param rays the segments to cast
+ * @param rayCount how many rays there are
+ * @param shapes the shapes to cast against
+ * @param hits an array of rayCount results, hits[i] is set to the nearest hit for rays[i].
+ * The id is the one the shape was added to the batch with
+ * @return how many of the rays hit something
+ */
+Uint32 gfc_raycast_batch(const GFC_Edge2D *rays,Uint32 rayCount,GFC_ShapeBatch *shapes,GFC_RaycastHit *hits);
+
 #endif
@@ -0,0 +1,148 @@
+#ifndef __GFC_SIMD_H__
+#define __GFC_SIMD_H__
+
+/**
+ * @purpose a thin wrapper over 4 wide float SIMD registers, used internally by the vector and matrix code.
+ * It is only switched on when the library is built with GFC_SIMD defined (-DGFC_SIMD) and the target has
+ * a supported instruction set:
+ *  - SSE2 on x86 (SSE4.1 is used for dot products when the compiler targets it, ie -msse4.1)
+ *  - NEON on arm
+ * Otherwise GFC_SIMD_ENABLED is 0 and the plain C code is used.  Either way the public API is unchanged.
+ * @note results can differ from the scalar code in the last bit or so, since the order of additions is not the same
+ */
+
+#if defined(GFC_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)))
+    #define GFC_SIMD_SSE 1
+    #include <emmintrin.h>
+    #ifdef __SSE4_1__
+        #include <smmintrin.h>
+    #endif
+#elif defined(GFC_SIMD) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+    #define GFC_SIMD_NEON 1
+    #include <arm_neon.h>
+#endif
+
+#if defined(GFC_SIMD_SSE) || defined(GFC_SIMD_NEON)
+    #define GFC_SIMD_ENABLED 1
+#else
+    #define GFC_SIMD_ENABLED 0
+#endif
+
+#if GFC_SIMD_ENABLED
+
+#ifdef GFC_SIMD_SSE
+
+typedef __m128 GFC_Simd4f;
+
+static inline GFC_Simd4f gfc_simd_load(const float *p){return _mm_loadu_ps(p);}
+static inline void gfc_simd_store(float *p,GFC_Simd4f v){_mm_storeu_ps(p,v);}
+static inline GFC_Simd4f gfc_simd_set1(float f){return _mm_set1_ps(f);}
+static inline GFC_Simd4f gfc_simd_add(GFC_Simd4f a,GFC_Simd4f b){return _mm_add_ps(a,b);}
+static inline GFC_Simd4f gfc_simd_sub(GFC_Simd4f a,GFC_Simd4f b){return _mm_sub_ps(a,b);}
+static inline GFC_Simd4f gfc_simd_mul(GFC_Simd4f a,GFC_Simd4f b){return _mm_mul_ps(a,b);}
+
+/**
+ * @brief broadcast one lane of v into all four lanes
+ */
+#define gfc_simd_splat(v,lane) _mm_shuffle_ps(v,v,_MM_SHUFFLE(lane,lane,lane,lane))
+
+/**
+ * @brief a * b + c
+ */
+static inline GFC_Simd4f gfc_simd_madd(GFC_Simd4f a,GFC_Simd4f b,GFC_Simd4f c){return _mm_add_ps(_mm_mul_ps(a,b),c);}
+
+/**
+ * @brief the sum of all four lanes
+ */
+static inline float gfc_simd_hsum(GFC_Simd4f v)
+{
+    __m128 shuf,sums;
+    shuf = _mm_shuffle_ps(v,v,_MM_SHUFFLE(2,3,0,1));
+    sums = _mm_add_ps(v,shuf);
+    shuf = _mm_movehl_ps(shuf,sums);
+    sums = _mm_add_ss(sums,shuf);
+    return _mm_cvtss_f32(sums);
+}
+
+static inline float gfc_simd_dot4(GFC_Simd4f a,GFC_Simd4f b)
+{
+#ifdef __SSE4_1__
+    return _mm_cvtss_f32(_mm_dp_ps(a,b,0xF1));
+#else
+    return gfc_simd_hsum(_mm_mul_ps(a,b));
+#endif
+}
+
+/**
+ * @brief transpose four rows in place
+ */
+#define gfc_simd_transpose4(r0,r1,r2,r3) _MM_TRANSPOSE4_PS(r0,r1,r2,r3)
+
+#define GFC_SIMD_HAS_SQRT 1
+static inline GFC_Simd4f gfc_simd_sqrt(GFC_Simd4f v){return _mm_sqrt_ps(v);}
+static inline GFC_Simd4f gfc_simd_div(GFC_Simd4f a,GFC_Simd4f b){return _mm_div_ps(a,b);}
+
+/**
+ * @brief per lane, pick a where test > 0 and b everywhere else
+ */
+static inline GFC_Simd4f gfc_simd_select_positive(GFC_Simd4f test,GFC_Simd4f a,GFC_Simd4f b)
+{
+    __m128 mask = _mm_cmpgt_ps(test,_mm_setzero_ps());
+    return _mm_or_ps(_mm_and_ps(mask,a),_mm_andnot_ps(mask,b));
+}
+
+#endif
+
+#ifdef GFC_SIMD_NEON
+
+typedef float32x4_t GFC_Simd4f;
+
+static inline GFC_Simd4f gfc_simd_load(const float *p){return vld1q_f32(p);}
+static inline void gfc_simd_store(float *p,GFC_Simd4f v){vst1q_f32(p,v);}
+static inline GFC_Simd4f gfc_simd_set1(float f){return vdupq_n_f32(f);}
+static inline GFC_Simd4f gfc_simd_add(GFC_Simd4f a,GFC_Simd4f b){return vaddq_f32(a,b);}
+static inline GFC_Simd4f gfc_simd_sub(GFC_Simd4f a,GFC_Simd4f b){return vsubq_f32(a,b);}
+static inline GFC_Simd4f gfc_simd_mul(GFC_Simd4f a,GFC_Simd4f b){return vmulq_f32(a,b);}
+
+#define gfc_simd_splat(v,lane) vdupq_n_f32(vgetq_lane_f32(v,lane))
+
+static inline GFC_Simd4f gfc_simd_madd(GFC_Simd4f a,GFC_Simd4f b,GFC_Simd4f c){return vmlaq_f32(c,a,b);}
+
+static inline float gfc_simd_hsum(GFC_Simd4f v)
+{
+    float32x2_t r;
+    r = vadd_f32(vget_low_f32(v),vget_high_f32(v));
+    return vget_lane_f32(vpadd_f32(r,r),0);
+}
+
+static inline float gfc_simd_dot4(GFC_Simd4f a,GFC_Simd4f b)
+{
+    return gfc_simd_hsum(vmulq_f32(a,b));
+}
+
+#define gfc_simd_transpose4(r0,r1,r2,r3) do {\
+    float32x4x2_t t01 = vtrnq_f32(r0,r1);\
+    float32x4x2_t t23 = vtrnq_f32(r2,r3);\
+    r0 = vcombine_f32(vget_low_f32(t01.val[0]),vget_low_f32(t23.val[0]));\
+    r1 = vcombine_f32(vget_low_f32(t01.val[1]),vget_low_f32(t23.val[1]));\
+    r2 = vcombine_f32(vget_high_f32(t01.val[0]),vget_high_f32(t23.val[0]));\
+    r3 = vcombine_f32(vget_high_f32(t01.val[1]),vget_high_f32(t23.val[1]));\
+    } while (0)
+
+#ifdef __aarch64__
+//32 bit arm has no vector square root or divide
+#define GFC_SIMD_HAS_SQRT 1
+static inline GFC_Simd4f gfc_simd_sqrt(GFC_Simd4f v){return vsqrtq_f32(v);}
+static inline GFC_Simd4f gfc_simd_div(GFC_Simd4f a,GFC_Simd4f b){return vdivq_f32(a,b);}
+#endif
+
+static inline GFC_Simd4f gfc_simd_select_positive(GFC_Simd4f test,GFC_Simd4f a,GFC_Simd4f b)
+{
+    return vbslq_f32(vcgtq_f32(test,vdupq_n_f32(0)),a,b);
+}
+
+#endif
+
+#endif
+
+#endif
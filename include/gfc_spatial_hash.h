@@ -0,0 +1,176 @@
+#ifndef __GFC_SPATIAL_HASH_H__
+#define __GFC_SPATIAL_HASH_H__
+
+#include "gfc_types.h"
+#include "gfc_shape.h"
+#include "gfc_list.h"
+#include "gfc_array.h"
+#include "gfc_intmap.h"
+
+/**
+ * @purpose a broadphase for 2D shapes.  Space is split into a uniform grid of square cells, and each body is
+ * listed in every cell its bounding rect touches.  Only cells that hold something are stored, in a GFC_IntMap,
+ * so the grid has no fixed extent.  Cells that empty out leave the grid and wait in a pool for reuse.
+ * Range queries and pair enumeration only look at bodies sharing a cell, then hand the survivors to the regular
+ * gfc_shape tests, instead of testing every body against every other.
+ * Moving a body only touches the grid when it crosses into a different set of cells, so most frame to frame
+ * updates just rewrite its shape.
+ * Pick a cell size around the size of a typical body: much smaller and bodies span many cells, much larger and
+ * cells fill up with bodies that are not near each other.
+ */
+
+#define GFC_SPATIAL_HASH_NONE 0     /**<never a valid body handle*/
+
+typedef struct
+{
+    GFC_Shape   shape;          /**<the shape of the body*/
+    GFC_Rect    bounds;         /**<bounding rect of the shape*/
+    Sint32      cellX1,cellY1;  /**<the first cell the bounds touch*/
+    Sint32      cellX2,cellY2;  /**<the last cell the bounds touch*/
+    void       *data;           /**<the data given when the body was inserted*/
+    Uint32      stamp;          /**<the last query to visit this body, so bodies in several cells are reported once*/
+    Uint32      nextFree;       /**<when not in use, the next free handle*/
+    Uint8       inUse;
+}GFC_SpatialHashBody;
+
+typedef struct
+{
+    float       cellSize;       /**<the width and height of a cell*/
+    float       invCellSize;    /**<1 / cellSize*/
+    GFC_Array  *bodies;         /**<GFC_SpatialHashBody by value, a handle is its index + 1*/
+    Uint32      freeHead;       /**<the first unused handle, GFC_SPATIAL_HASH_NONE if there are none*/
+    Uint32      count;          /**<how many bodies are in the hash*/
+    GFC_IntMap *cells;          /**<the occupied cells, keyed by packed cell coordinates*/
+    GFC_List   *cellList;       /**<the same cells in a dense list, for walking all of them*/
+    GFC_List   *cellPool;       /**<emptied cells, kept so a body crossing cell borders does not allocate*/
+    Uint32      stamp;          /**<incremented for each query*/
+}GFC_SpatialHash2D;
+
+/**
+ * @brief prototype for a function called for each pair of bodies
+ * @param a the handle of one body
+ * @param b the handle of the other body
+ * @param context the context given to the call
+ */
+typedef void gfc_spatial_hash_pair_func(Uint32 a,Uint32 b,void *context);
+
+/**
+ * @brief allocate a new empty spatial hash
+ * @param cellSize the width and height of a grid cell, must be greater than zero
+ * @return NULL on error, or the new hash.  Free it with gfc_spatial_hash_free
+ */
+GFC_SpatialHash2D *gfc_spatial_hash_new(float cellSize);
+
+/**
+ * @brief free a spatial hash and all of its cells
+ * @note the data given to each body is not freed
+ * @param hash the hash to free
+ */
+void gfc_spatial_hash_free(GFC_SpatialHash2D *hash);
+
+/**
+ * @brief remove every body from the hash and free its cells
+ * @note all handles become invalid
+ * @param hash the hash to clear
+ */
+void gfc_spatial_hash_clear(GFC_SpatialHash2D *hash);
+
+/**
+ * @brief add a body to the hash
+ * @param hash the hash to add to
+ * @param shape the shape of the body, a copy is kept
+ * @param data stored with the body, get it back with gfc_spatial_hash_get_data
+ * @return GFC_SPATIAL_HASH_NONE on error, or the handle of the new body
+ */
+Uint32 gfc_spatial_hash_insert(GFC_SpatialHash2D *hash,GFC_Shape shape,void *data);
+
+/**
+ * @brief remove a body from the hash.  Its handle may be reused by a later insert
+ * @param hash the hash to remove from
+ * @param handle the body to remove
+ */
+void gfc_spatial_hash_remove(GFC_SpatialHash2D *hash,Uint32 handle);
+
+/**
+ * @brief give a body a new shape, such as after it has moved
+ * @param hash the hash the body is in
+ * @param handle the body to change
+ * @param shape the new shape
+ */
+void gfc_spatial_hash_update(GFC_SpatialHash2D *hash,Uint32 handle,GFC_Shape shape);
+
+/**
+ * @brief move a body by an offset, same as gfc_shape_move
+ * @param hash the hash the body is in
+ * @param handle the body to move
+ * @param move how far to move it
+ */
+void gfc_spatial_hash_move(GFC_SpatialHash2D *hash,Uint32 handle,GFC_Vector2D move);
+
+/**
+ * @brief get the data a body was inserted with
+ * @param hash the hash the body is in
+ * @param handle the body
+ * @return NULL if the handle is not in use, the data otherwise
+ */
+void *gfc_spatial_hash_get_data(GFC_SpatialHash2D *hash,Uint32 handle);
+
+/**
+ * @brief get the shape of a body
+ * @note the pointer is only valid until the next insert
+ * @param hash the hash the body is in
+ * @param handle the body
+ * @return NULL if the handle is not in use, the shape otherwise
+ */
+GFC_Shape *gfc_spatial_hash_get_shape(GFC_SpatialHash2D *hash,Uint32 handle);
+
+/**
+ * @brief get the number of bodies in the hash
+ * @param hash the hash to check
+ * @return the count, 0 if hash is NULL
+ */
+Uint32 gfc_spatial_hash_get_count(GFC_SpatialHash2D *hash);
+
+/**
+ * @brief find the bodies whose shapes overlap a shape, using gfc_shape_overlap
+ * @param hash the hash to search
+ * @param shape the shape to test with
+ * @param handles where to write the handles of the bodies found, each body is written once
+ * @param maxHandles how many handles fit, the search stops once it is full
+ * @return how many handles were written
+ */
+Uint32 gfc_spatial_hash_query_shape(GFC_SpatialHash2D *hash,GFC_Shape shape,Uint32 *handles,Uint32 maxHandles);
+
+/**
+ * @brief find the bodies whose shapes overlap a rect
+ * @note same as gfc_spatial_hash_query_shape with gfc_shape_from_rect(rect)
+ */
+Uint32 gfc_spatial_hash_query_rect(GFC_SpatialHash2D *hash,GFC_Rect rect,Uint32 *handles,Uint32 maxHandles);
+
+/**
+ * @brief find the bodies whose shapes overlap a circle
+ * @note same as gfc_spatial_hash_query_shape with gfc_shape_from_circle(circle)
+ */
+Uint32 gfc_spatial_hash_query_circle(GFC_SpatialHash2D *hash,GFC_Circle circle,Uint32 *handles,Uint32 maxHandles);
+
+/**
+ * @brief call func once for each pair of bodies whose bounding rects overlap.
+ * These are the candidates to pass to a narrowphase test such as gfc_shape_overlap_poc
+ * @note the hash must not be changed from inside func
+ * @param hash the hash to search
+ * @param func called with the two handles of each pair
+ * @param context passed along to func
+ */
+void gfc_spatial_hash_foreach_pair(GFC_SpatialHash2D *hash,gfc_spatial_hash_pair_func *func,void *context);
+
+/**
+ * @brief call func once for each pair of bodies whose shapes overlap, by gfc_shape_overlap.
+ * This replaces testing every body against every other body
+ * @note the hash must not be changed from inside func
+ * @param hash the hash to search
+ * @param func called with the two handles of each pair
+ * @param context passed along to func
+ */
+void gfc_spatial_hash_foreach_overlap(GFC_SpatialHash2D *hash,gfc_spatial_hash_pair_func *func,void *context);
+
+#endif
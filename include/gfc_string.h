@@ -2,14 +2,35 @@
 #define __GFC_STRING_H__
 
 #include "gfc_types.h"
+#include "gfc_list.h"
 
+#define GFC_STRING_LOCAL_SIZE 32   /**<strings shorter than this are kept inside the GFC_String itself*/
+
+/**
+ * @brief a growable, null terminated string.
+ * Short strings live in the local buffer and need no allocation beyond the struct; once the text outgrows it
+ * the buffer moves to the heap.
+ * @note because buffer may point into the struct itself, never copy a GFC_String by value
+ */
 typedef struct
 {
-    char   *buffer; /**<contains the character data*/
+    char   *buffer; /**<contains the character data, either local or heap allocated*/
     size_t  length; /**<how long the character array is*/
-    size_t  size;   /**<how much data has been allocated*/
+    size_t  size;   /**<how much space buffer has, including the null terminator*/
+    char    local[GFC_STRING_LOCAL_SIZE];/**<inline storage for short strings*/
 }GFC_String;
 
+/**
+ * @brief a write only text accumulator for building up large strings out of many small pieces.
+ * Text is copied into fixed size chunks that are never moved, so appending never reallocates or copies
+ * what was written before.  The whole text is put together once, when the result is requested.
+ */
+typedef struct
+{
+    GFC_List   *chunks;     /**<list of text chunks, in order*/
+    size_t      length;     /**<total length of all text appended*/
+}GFC_StringBuilder;
+
 
 /**
  * @brief allocate an empty string
@@ -19,7 +40,8 @@ GFC_String *gfc_string_new();
 
 /**
  * @brief allocate an empty string, pre-allocatign a set buffer length
- * @param size how many characters you want to pre-allocate.  if zero, this is a no-op
+ * @param size how many characters you want to pre-allocate.  if zero, this is a no-op.
+ * Sizes that fit in GFC_STRING_LOCAL_SIZE use the local buffer
  * @return NULL if memory is full, a pointer to an empty GFC_String otherwise of size
  */
 GFC_String *gfc_string_new_size(Uint32 size);
@@ -122,4 +144,59 @@ int gfc_string_strcmp(GFC_String *string1,const char *string2);
  */
 int gfc_string_l_strcmp(GFC_String *string1,const char *string2);
 
+/**
+ * @brief allocate a new empty string builder
+ * @return NULL on memory error, a new builder otherwise
+ */
+GFC_StringBuilder *gfc_string_builder_new();
+
+/**
+ * @brief free a string builder and all of the text it holds
+ * @param builder the builder to free
+ */
+void gfc_string_builder_free(GFC_StringBuilder *builder);
+
+/**
+ * @brief throw away the text in the builder, keeping one chunk for reuse
+ * @param builder the builder to clear
+ */
+void gfc_string_builder_clear(GFC_StringBuilder *builder);
+
+/**
+ * @brief add text to the end of the builder
+ * @param builder the builder to add to
+ * @param text the text to add
+ */
+void gfc_string_builder_append(GFC_StringBuilder *builder,const char *text);
+
+/**
+ * @brief add formatted text to the end of the builder, similar to printf
+ * @param builder the builder to add to
+ * @param format the format string
+ * @param ... the variables used to populate the formatted text
+ */
+void gfc_string_builder_appendf(GFC_StringBuilder *builder,const char *format,...);
+
+/**
+ * @brief get the total length of the text in the builder
+ * @param builder the builder to check
+ * @return the length in characters, not counting a null terminator
+ */
+size_t gfc_string_builder_get_length(GFC_StringBuilder *builder);
+
+/**
+ * @brief put all of the text in the builder together into a new string
+ * @param builder the builder to read from.  It is left unchanged
+ * @return NULL on error, a new GFC_String otherwise that must be freed with gfc_string_free()
+ */
+GFC_String *gfc_string_builder_to_string(GFC_StringBuilder *builder);
+
+/**
+ * @brief put all of the text in the builder together into a new character buffer
+ * @param builder the builder to read from.  It is left unchanged
+ * @param lengthOut [optional output] set to the length of the text
+ * @return NULL on error, a new null terminated buffer otherwise that must be free()'d
+ */
+char *gfc_string_builder_flatten(GFC_StringBuilder *builder,size_t *lengthOut);
+
 #endif
@@ -44,6 +44,7 @@ int gfc_strlcmp(const char *a,const char *b);
 
 /**
  * @brief believe it or not but standard C does not have stricmp.  This does that
+ * @note only ascii letters are folded.  Compares 16 bytes at a time where SSE2 is available
  * @param a one of the strings to compare
  * @param b one of the strings to compare
  * @returns strcmp results
@@ -52,6 +53,7 @@ int gfc_stricmp(const char *a,const char *b);
 
 /**
  * @brief case insensitive number string compare
+ * @note only ascii letters are folded.  Compares 16 bytes at a time where SSE2 is available
  * @param a one of the strings to compare
  * @param b one of the strings to compare
  * @param n how many characters to compare
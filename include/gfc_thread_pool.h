@@ -0,0 +1,60 @@
+#ifndef __GFC_THREAD_POOL_H__
+#define __GFC_THREAD_POOL_H__
+
+#include <SDL.h>
+
+/**
+ * @purpose a persistent pool of worker threads for splitting loops over large collections.
+ * The pool is created once with gfc_thread_pool_init and sleeps between jobs.
+ * A job is a range of indices.  The workers and the calling thread all pull chunks of grainSize
+ * indices from a shared atomic counter until the range is used up, so a thread that finishes early
+ * simply takes the next chunk and the load balances itself.
+ *
+ * Guarantees for every parallel call (including gfc_list_foreach_parallel and gfc_hashmap_foreach_parallel):
+ *  - every index is processed exactly once
+ *  - NO ordering: chunks run concurrently on different threads in any order.  Within one chunk indices run in order
+ *  - the call returns only after every chunk has finished, and anything the callbacks wrote is visible to the caller
+ *  - the collection must not be modified while the call runs, and callbacks must not touch shared state without
+ *    their own synchronization
+ *  - if the pool is not initialized, or a parallel call is made from inside another one, the work runs serially
+ *    on the calling thread
+ */
+
+/**
+ * @brief prototype for the work done on a chunk of a parallel job
+ * @param start the first index of the chunk
+ * @param end one past the last index of the chunk
+ * @param context the context given to the parallel call
+ */
+typedef void gfc_range_func(Uint32 start,Uint32 end,void *context);
+
+/**
+ * @brief start up the worker threads
+ * @param threadCount how many workers to create.  If zero, one less than the number of CPU cores is used
+ * (the calling thread also does work during a job)
+ * @note the pool is shut down automatically at exit
+ */
+void gfc_thread_pool_init(Uint32 threadCount);
+
+/**
+ * @brief stop and join all of the worker threads
+ */
+void gfc_thread_pool_close();
+
+/**
+ * @brief get the number of worker threads in the pool
+ * @return the count, 0 if the pool is not running
+ */
+Uint32 gfc_thread_pool_get_thread_count();
+
+/**
+ * @brief split the range [0,count) into chunks of grainSize and run func on each of them, spread over the pool
+ * @param count how many indices to process
+ * @param grainSize how many indices to hand out at a time.  If zero a size is picked from the thread count.
+ * Larger chunks mean less overhead, smaller chunks balance uneven work better
+ * @param func the function to run for each chunk
+ * @param context passed along to func
+ */
+void gfc_thread_pool_parallel_for(Uint32 count,Uint32 grainSize,gfc_range_func *func,void *context);
+
+#endif
@@ -49,6 +49,18 @@ typedef struct
   float w;
 }GFC_Vector4D;
 
+/**
+ * @brief a structure of arrays view over many 3D vectors, the ith vector is (x[i],y[i],z[i]).
+ * The batch functions below work on the three arrays a component at a time, so the compiler can vectorize
+ * them and the data streams straight through memory.  The arrays are owned by the caller.
+ */
+typedef struct
+{
+    float *x;
+    float *y;
+    float *z;
+}GFC_Vector3DBatch;
+
 /**
  * The integer space gfc_vector types:
  */
@@ -631,4 +643,66 @@ void gfc_vector2d_move_towards(GFC_Vector2D *out, GFC_Vector2D point, GFC_Vector
  */
 void gfc_vector3d_randomize(GFC_Vector3D *out,GFC_Vector3D in);
 
+/**
+ * @brief make a batch view from three component arrays
+ * @param x array of x components
+ * @param y array of y components
+ * @param z array of z components
+ * @return the batch
+ */
+GFC_Vector3DBatch gfc_vector3d_batch(float *x,float *y,float *z);
+
+/**
+ * @brief batch operations over count vectors
+ * @note out may be the same arrays as an input to work in place, but must not otherwise overlap them
+ */
+
+/**
+ * @brief out[i] = a[i] + b[i]
+ */
+void gfc_vector3d_batch_add(GFC_Vector3DBatch out,GFC_Vector3DBatch a,GFC_Vector3DBatch b,Uint32 count);
+
+/**
+ * @brief out[i] = a[i] - b[i]
+ */
+void gfc_vector3d_batch_sub(GFC_Vector3DBatch out,GFC_Vector3DBatch a,GFC_Vector3DBatch b,Uint32 count);
+
+/**
+ * @brief out[i] = a[i] * factor
+ */
+void gfc_vector3d_batch_scale(GFC_Vector3DBatch out,GFC_Vector3DBatch a,float factor,Uint32 count);
+
+/**
+ * @brief out[i] = a[i] + b[i] * factor.  For example position += velocity * time step
+ */
+void gfc_vector3d_batch_add_scaled(GFC_Vector3DBatch out,GFC_Vector3DBatch a,GFC_Vector3DBatch b,float factor,Uint32 count);
+
+/**
+ * @brief out[i] = the dot product of a[i] and b[i]
+ * @param out array of count floats
+ */
+void gfc_vector3d_batch_dot(float *out,GFC_Vector3DBatch a,GFC_Vector3DBatch b,Uint32 count);
+
+/**
+ * @brief out[i] = the cross product of a[i] and b[i]
+ */
+void gfc_vector3d_batch_cross(GFC_Vector3DBatch out,GFC_Vector3DBatch a,GFC_Vector3DBatch b,Uint32 count);
+
+/**
+ * @brief out[i] = the magnitude of a[i]
+ * @param out array of count floats
+ */
+void gfc_vector3d_batch_magnitude(float *out,GFC_Vector3DBatch a,Uint32 count);
+
+/**
+ * @brief out[i] = the squared magnitude of a[i]
+ * @param out array of count floats
+ */
+void gfc_vector3d_batch_magnitude_squared(float *out,GFC_Vector3DBatch a,Uint32 count);
+
+/**
+ * @brief out[i] = a[i] scaled to unit length.  Zero length vectors are copied unchanged, same as gfc_vector3d_normalize
+ */
+void gfc_vector3d_batch_normalize(GFC_Vector3DBatch out,GFC_Vector3DBatch a,Uint32 count);
+
 #endif
@@ -0,0 +1,603 @@
+#include <math.h>
+
+#include "simple_logger.h"
+
+#include "gfc_aabb_tree.h"
+
+#define GFC_AABB_TREE_INITIAL_SIZE 16
+#define GFC_AABB_TREE_STACK_LOCAL 128
+
+/**
+ * @brief traversal stack.  Starts out in the local array and only goes to the heap for very deep trees,
+ * so traversals do not allocate and can safely be nested inside each other's callbacks
+ */
+typedef struct
+{
+    Uint32  local[GFC_AABB_TREE_STACK_LOCAL];
+    Uint32 *items;
+    Uint32  count;
+    Uint32  size;
+}GFC_AABBTreeStack;
+
+static void gfc_aabb_tree_stack_init(GFC_AABBTreeStack *stack)
+{
+    stack->items = stack->local;
+    stack->count = 0;
+    stack->size = GFC_AABB_TREE_STACK_LOCAL;
+}
+
+static void gfc_aabb_tree_stack_free(GFC_AABBTreeStack *stack)
+{
+    if (stack->items != stack->local)free(stack->items);
+}
+
+static int gfc_aabb_tree_stack_push(GFC_AABBTreeStack *stack,Uint32 index)
+{
+    Uint32 *items;
+    if (stack->count >= stack->size)
+    {
+        items = malloc(sizeof(Uint32) * stack->size * 2);
+        if (!items)
+        {
+            slog("failed to grow aabb tree traversal stack");
+            return 0;
+        }
+        memcpy(items,stack->items,sizeof(Uint32) * stack->count);
+        gfc_aabb_tree_stack_free(stack);
+        stack->items = items;
+        stack->size *= 2;
+    }
+    stack->items[stack->count++] = index;
+    return 1;
+}
+
+static inline GFC_Rect gfc_aabb_tree_union(GFC_Rect a,GFC_Rect b)
+{
+    GFC_Rect r;
+    r.x = MIN(a.x,b.x);
+    r.y = MIN(a.y,b.y);
+    r.w = MAX(a.x + a.w,b.x + b.w) - r.x;
+    r.h = MAX(a.y + a.h,b.y + b.h) - r.y;
+    return r;
+}
+
+/**
+ * @brief the 2D stand in for surface area, used as the cost of a node
+ */
+static inline float gfc_aabb_tree_perimeter(GFC_Rect r)
+{
+    return 2.0f * (r.w + r.h);
+}
+
+static inline Uint8 gfc_aabb_tree_overlap(GFC_Rect a,GFC_Rect b)
+{
+    return (a.x <= b.x + b.w)&&(b.x <= a.x + a.w)&&(a.y <= b.y + b.h)&&(b.y <= a.y + a.h);
+}
+
+static inline Uint8 gfc_aabb_tree_contains(GFC_Rect outer,GFC_Rect inner)
+{
+    return (outer.x <= inner.x)&&(outer.y <= inner.y)
+        &&(inner.x + inner.w <= outer.x + outer.w)&&(inner.y + inner.h <= outer.y + outer.h);
+}
+
+/**
+ * @brief put nodes first through size - 1 on the free list, in order
+ */
+static void gfc_aabb_tree_link_free(GFC_AABBTree *tree,Uint32 first)
+{
+    Uint32 i;
+    for (i = first; i < tree->size; i++)
+    {
+        memset(&tree->nodes[i],0,sizeof(GFC_AABBTreeNode));
+        tree->nodes[i].parent = (i + 1 < tree->size) ? i + 1 : GFC_AABB_TREE_NONE;
+        tree->nodes[i].height = -1;
+    }
+    tree->freeHead = first;
+}
+
+GFC_AABBTree *gfc_aabb_tree_new(float margin)
+{
+    GFC_AABBTree *tree;
+    if (margin < 0)
+    {
+        slog("aabb tree margin must not be negative");
+        return NULL;
+    }
+    tree = gfc_allocate_array(sizeof(GFC_AABBTree),1);
+    if (!tree)return NULL;
+    tree->nodes = gfc_allocate_array(sizeof(GFC_AABBTreeNode),GFC_AABB_TREE_INITIAL_SIZE);
+    if (!tree->nodes)
+    {
+        free(tree);
+        return NULL;
+    }
+    tree->size = GFC_AABB_TREE_INITIAL_SIZE;
+    tree->margin = margin;
+    tree->nodes[0].height = -1;
+    gfc_aabb_tree_link_free(tree,1);
+    return tree;
+}
+
+void gfc_aabb_tree_free(GFC_AABBTree *tree)
+{
+    if (!tree)return;
+    free(tree->nodes);
+    free(tree);
+}
+
+void gfc_aabb_tree_clear(GFC_AABBTree *tree)
+{
+    if (!tree)return;
+    tree->root = GFC_AABB_TREE_NONE;
+    tree->count = 0;
+    gfc_aabb_tree_link_free(tree,1);
+}
+
+/**
+ * @brief take a node off the free list, growing the pool if needed
+ * @note the pool may move, so do not hold node pointers across this call
+ */
+static Uint32 gfc_aabb_tree_allocate_node(GFC_AABBTree *tree)
+{
+    Uint32 index,oldSize;
+    GFC_AABBTreeNode *nodes;
+    if (tree->freeHead == GFC_AABB_TREE_NONE)
+    {
+        oldSize = tree->size;
+        nodes = realloc(tree->nodes,sizeof(GFC_AABBTreeNode) * oldSize * 2);
+        if (!nodes)
+        {
+            slog("failed to grow aabb tree");
+            return GFC_AABB_TREE_NONE;
+        }
+        tree->nodes = nodes;
+        tree->size = oldSize * 2;
+        gfc_aabb_tree_link_free(tree,oldSize);
+    }
+    index = tree->freeHead;
+    tree->freeHead = tree->nodes[index].parent;
+    tree->nodes[index].parent = GFC_AABB_TREE_NONE;
+    tree->nodes[index].child1 = GFC_AABB_TREE_NONE;
+    tree->nodes[index].child2 = GFC_AABB_TREE_NONE;
+    tree->nodes[index].data = NULL;
+    tree->nodes[index].height = 0;
+    return index;
+}
+
+static void gfc_aabb_tree_free_node(GFC_AABBTree *tree,Uint32 index)
+{
+    tree->nodes[index].parent = tree->freeHead;
+    tree->nodes[index].height = -1;
+    tree->nodes[index].data = NULL;
+    tree->freeHead = index;
+}
+
+/**
+ * @brief if node a is out of balance, rotate its taller child up into its place
+ * @return the node now where a was
+ */
+static Uint32 gfc_aabb_tree_balance(GFC_AABBTree *tree,Uint32 iA)
+{
+    Sint32 balance;
+    Uint32 iB,iC,iKeep,iGive;
+    GFC_AABBTreeNode *A,*B,*C,*keep,*give;
+    A = &tree->nodes[iA];
+    if ((A->child1 == GFC_AABB_TREE_NONE)||(A->height < 2))return iA;
+    balance = tree->nodes[A->child2].height - tree->nodes[A->child1].height;
+    if ((balance >= -1)&&(balance <= 1))return iA;
+    //C is the taller child and B the shorter
+    iB = (balance > 1) ? A->child1 : A->child2;
+    iC = (balance > 1) ? A->child2 : A->child1;
+    B = &tree->nodes[iB];
+    C = &tree->nodes[iC];
+    //C takes A's place
+    C->parent = A->parent;
+    A->parent = iC;
+    if (C->parent != GFC_AABB_TREE_NONE)
+    {
+        if (tree->nodes[C->parent].child1 == iA)tree->nodes[C->parent].child1 = iC;
+        else tree->nodes[C->parent].child2 = iC;
+    }
+    else tree->root = iC;
+    //the taller of C's children stays with C, the shorter one goes to A in C's old spot
+    if (tree->nodes[C->child1].height > tree->nodes[C->child2].height)
+    {
+        iKeep = C->child1;
+        iGive = C->child2;
+    }
+    else
+    {
+        iKeep = C->child2;
+        iGive = C->child1;
+    }
+    keep = &tree->nodes[iKeep];
+    give = &tree->nodes[iGive];
+    C->child1 = iA;
+    C->child2 = iKeep;
+    if (A->child1 == iC)A->child1 = iGive;
+    else A->child2 = iGive;
+    give->parent = iA;
+    A->bounds = gfc_aabb_tree_union(B->bounds,give->bounds);
+    A->height = 1 + MAX(B->height,give->height);
+    C->bounds = gfc_aabb_tree_union(A->bounds,keep->bounds);
+    C->height = 1 + MAX(A->height,keep->height);
+    return iC;
+}
+
+static void gfc_aabb_tree_refit(GFC_AABBTree *tree,Uint32 index)
+{
+    GFC_AABBTreeNode *node;
+    while (index != GFC_AABB_TREE_NONE)
+    {
+        index = gfc_aabb_tree_balance(tree,index);
+        node = &tree->nodes[index];
+        node->height = 1 + MAX(tree->nodes[node->child1].height,tree->nodes[node->child2].height);
+        node->bounds = gfc_aabb_tree_union(tree->nodes[node->child1].bounds,tree->nodes[node->child2].bounds);
+        index = node->parent;
+    }
+}
+
+/**
+ * @brief the cost of hanging a leaf with bounds under node index, not counting what the ancestors add
+ */
+static inline float gfc_aabb_tree_descend_cost(GFC_AABBTree *tree,Uint32 index,GFC_Rect bounds)
+{
+    GFC_AABBTreeNode *node = &tree->nodes[index];
+    float cost = gfc_aabb_tree_perimeter(gfc_aabb_tree_union(bounds,node->bounds));
+    if (node->child1 == GFC_AABB_TREE_NONE)return cost;
+    //an internal node already pays for its own perimeter, only the growth is new
+    return cost - gfc_aabb_tree_perimeter(node->bounds);
+}
+
+static int gfc_aabb_tree_insert_leaf(GFC_AABBTree *tree,Uint32 leaf)
+{
+    Uint32 index,sibling,oldParent,newParent;
+    float perimeter,combined,cost,inheritance,cost1,cost2;
+    GFC_Rect bounds;
+    GFC_AABBTreeNode *node;
+    if (tree->root == GFC_AABB_TREE_NONE)
+    {
+        tree->root = leaf;
+        tree->nodes[leaf].parent = GFC_AABB_TREE_NONE;
+        return 1;
+    }
+    //walk down to the sibling that grows the total perimeter the least
+    bounds = tree->nodes[leaf].bounds;
+    index = tree->root;
+    while (tree->nodes[index].child1 != GFC_AABB_TREE_NONE)
+    {
+        node = &tree->nodes[index];
+        perimeter = gfc_aabb_tree_perimeter(node->bounds);
+        combined = gfc_aabb_tree_perimeter(gfc_aabb_tree_union(node->bounds,bounds));
+        //cost of making a new parent for this node and the leaf
+        cost = 2.0f * combined;
+        //going further down still grows this node
+        inheritance = 2.0f * (combined - perimeter);
+        cost1 = gfc_aabb_tree_descend_cost(tree,node->child1,bounds) + inheritance;
+        cost2 = gfc_aabb_tree_descend_cost(tree,node->child2,bounds) + inheritance;
+        if ((cost < cost1)&&(cost < cost2))break;
+        index = (cost1 < cost2) ? node->child1 : node->child2;
+    }
+    sibling = index;
+    newParent = gfc_aabb_tree_allocate_node(tree);
+    if (newParent == GFC_AABB_TREE_NONE)return 0;
+    oldParent = tree->nodes[sibling].parent;
+    node = &tree->nodes[newParent];
+    node->parent = oldParent;
+    node->bounds = gfc_aabb_tree_union(bounds,tree->nodes[sibling].bounds);
+    node->height = tree->nodes[sibling].height + 1;
+    node->child1 = sibling;
+    node->child2 = leaf;
+    tree->nodes[sibling].parent = newParent;
+    tree->nodes[leaf].parent = newParent;
+    if (oldParent != GFC_AABB_TREE_NONE)
+    {
+        if (tree->nodes[oldParent].child1 == sibling)tree->nodes[oldParent].child1 = newParent;
+        else tree->nodes[oldParent].child2 = newParent;
+    }
+    else tree->root = newParent;
+    gfc_aabb_tree_refit(tree,oldParent);
+    return 1;
+}
+
+static void gfc_aabb_tree_remove_leaf(GFC_AABBTree *tree,Uint32 leaf)
+{
+    Uint32 parent,grandParent,sibling;
+    if (leaf == tree->root)
+    {
+        tree->root = GFC_AABB_TREE_NONE;
+        return;
+    }
+    parent = tree->nodes[leaf].parent;
+    grandParent = tree->nodes[parent].parent;
+    sibling = (tree->nodes[parent].child1 == leaf) ? tree->nodes[parent].child2 : tree->nodes[parent].child1;
+    //the sibling takes the place of the parent
+    tree->nodes[sibling].parent = grandParent;
+    gfc_aabb_tree_free_node(tree,parent);
+    if (grandParent == GFC_AABB_TREE_NONE)
+    {
+        tree->root = sibling;
+        return;
+    }
+    if (tree->nodes[grandParent].child1 == parent)tree->nodes[grandParent].child1 = sibling;
+    else tree->nodes[grandParent].child2 = sibling;
+    gfc_aabb_tree_refit(tree,grandParent);
+}
+
+static GFC_Rect gfc_aabb_tree_fatten(GFC_AABBTree *tree,GFC_Rect bounds)
+{
+    bounds.x -= tree->margin;
+    bounds.y -= tree->margin;
+    bounds.w += tree->margin * 2;
+    bounds.h += tree->margin * 2;
+    return bounds;
+}
+
+static GFC_AABBTreeNode *gfc_aabb_tree_get_leaf(GFC_AABBTree *tree,Uint32 handle)
+{
+    GFC_AABBTreeNode *node;
+    if ((!tree)||(handle == GFC_AABB_TREE_NONE)||(handle >= tree->size))return NULL;
+    node = &tree->nodes[handle];
+    if (node->height != 0)return NULL;//unused, or an internal node
+    return node;
+}
+
+Uint32 gfc_aabb_tree_insert(GFC_AABBTree *tree,GFC_Rect bounds,void *data)
+{
+    Uint32 leaf;
+    if (!tree)return GFC_AABB_TREE_NONE;
+    leaf = gfc_aabb_tree_allocate_node(tree);
+    if (leaf == GFC_AABB_TREE_NONE)return GFC_AABB_TREE_NONE;
+    tree->nodes[leaf].bounds = gfc_aabb_tree_fatten(tree,bounds);
+    tree->nodes[leaf].data = data;
+    if (!gfc_aabb_tree_insert_leaf(tree,leaf))
+    {
+        gfc_aabb_tree_free_node(tree,leaf);
+        return GFC_AABB_TREE_NONE;
+    }
+    tree->count++;
+    return leaf;
+}
+
+void gfc_aabb_tree_remove(GFC_AABBTree *tree,Uint32 handle)
+{
+    if (!gfc_aabb_tree_get_leaf(tree,handle))return;
+    gfc_aabb_tree_remove_leaf(tree,handle);
+    gfc_aabb_tree_free_node(tree,handle);
+    tree->count--;
+}
+
+Uint8 gfc_aabb_tree_move(GFC_AABBTree *tree,Uint32 handle,GFC_Rect bounds,GFC_Vector2D displacement)
+{
+    GFC_Rect fat;
+    GFC_AABBTreeNode *node;
+    node = gfc_aabb_tree_get_leaf(tree,handle);
+    if (!node)return 0;
+    if (gfc_aabb_tree_contains(node->bounds,bounds))return 0;
+    fat = gfc_aabb_tree_fatten(tree,bounds);
+    //stretch ahead of the motion so the next few steps fit too
+    displacement.x *= GFC_AABB_TREE_DISPLACEMENT_SCALE;
+    displacement.y *= GFC_AABB_TREE_DISPLACEMENT_SCALE;
+    if (displacement.x < 0)fat.x += displacement.x;
+    fat.w += fabsf(displacement.x);
+    if (displacement.y < 0)fat.y += displacement.y;
+    fat.h += fabsf(displacement.y);
+    gfc_aabb_tree_remove_leaf(tree,handle);
+    tree->nodes[handle].bounds = fat;
+    //the leaf just freed a parent node, so reinserting cannot need to grow the pool
+    gfc_aabb_tree_insert_leaf(tree,handle);
+    return 1;
+}
+
+void *gfc_aabb_tree_get_data(GFC_AABBTree *tree,Uint32 handle)
+{
+    GFC_AABBTreeNode *node;
+    node = gfc_aabb_tree_get_leaf(tree,handle);
+    if (!node)return NULL;
+    return node->data;
+}
+
+GFC_Rect gfc_aabb_tree_get_fat_bounds(GFC_AABBTree *tree,Uint32 handle)
+{
+    GFC_AABBTreeNode *node;
+    node = gfc_aabb_tree_get_leaf(tree,handle);
+    if (!node)return gfc_rect(0,0,0,0);
+    return node->bounds;
+}
+
+Uint32 gfc_aabb_tree_get_count(GFC_AABBTree *tree)
+{
+    if (!tree)return 0;
+    return tree->count;
+}
+
+Uint32 gfc_aabb_tree_get_height(GFC_AABBTree *tree)
+{
+    if ((!tree)||(tree->root == GFC_AABB_TREE_NONE))return 0;
+    return tree->nodes[tree->root].height;
+}
+
+Uint32 gfc_aabb_tree_query(GFC_AABBTree *tree,GFC_Rect rect,Uint32 *handles,Uint32 maxHandles)
+{
+    Uint32 index,found = 0;
+    GFC_AABBTreeNode *node;
+    GFC_AABBTreeStack stack;
+    if ((!tree)||(!handles)||(!maxHandles)||(tree->root == GFC_AABB_TREE_NONE))return 0;
+    gfc_aabb_tree_stack_init(&stack);
+    gfc_aabb_tree_stack_push(&stack,tree->root);
+    while ((stack.count)&&(found < maxHandles))
+    {
+        index = stack.items[--stack.count];
+        node = &tree->nodes[index];
+        if (!gfc_aabb_tree_overlap(node->bounds,rect))continue;
+        if (node->child1 == GFC_AABB_TREE_NONE)
+        {
+            handles[found++] = index;
+            continue;
+        }
+        gfc_aabb_tree_stack_push(&stack,node->child1);
+        gfc_aabb_tree_stack_push(&stack,node->child2);
+    }
+    gfc_aabb_tree_stack_free(&stack);
+    return found;
+}
+
+Uint32 gfc_aabb_tree_raycast(
+    GFC_AABBTree *tree,
+    GFC_Edge2D ray,
+    gfc_aabb_tree_ray_func *func,
+    void *context,
+    float *fraction)
+{
+    Uint32 index,hit = GFC_AABB_TREE_NONE;
+    float dx,dy,length,nx,ny,cx,cy,separation,value,maxFraction = 1;
+    GFC_Rect segment;
+    GFC_AABBTreeNode *node;
+    GFC_AABBTreeStack stack;
+    if (fraction)*fraction = 1;
+    if ((!tree)||(!func)||(tree->root == GFC_AABB_TREE_NONE))return GFC_AABB_TREE_NONE;
+    dx = ray.x2 - ray.x1;
+    dy = ray.y2 - ray.y1;
+    length = sqrtf(dx * dx + dy * dy);
+    //normal of the ray, for rejecting boxes that sit beside the line
+    nx = length > 0 ? -dy / length : 0;
+    ny = length > 0 ? dx / length : 0;
+    segment = gfc_rect(MIN(ray.x1,ray.x2),MIN(ray.y1,ray.y2),fabsf(dx),fabsf(dy));
+    gfc_aabb_tree_stack_init(&stack);
+    gfc_aabb_tree_stack_push(&stack,tree->root);
+    while (stack.count)
+    {
+        index = stack.items[--stack.count];
+        node = &tree->nodes[index];
+        if (!gfc_aabb_tree_overlap(node->bounds,segment))continue;
+        //a box is missed if its center is further from the line than its extent along the normal
+        cx = node->bounds.x + node->bounds.w * 0.5f - ray.x1;
+        cy = node->bounds.y + node->bounds.h * 0.5f - ray.y1;
+        separation = fabsf(nx * cx + ny * cy) - 0.5f * (fabsf(nx) * node->bounds.w + fabsf(ny) * node->bounds.h);
+        if (separation > 0)continue;
+        if (node->child1 != GFC_AABB_TREE_NONE)
+        {
+            gfc_aabb_tree_stack_push(&stack,node->child1);
+            gfc_aabb_tree_stack_push(&stack,node->child2);
+            continue;
+        }
+        value = func(index,ray,maxFraction,context);
+        if (value < 0)continue;
+        if (value < maxFraction)
+        {
+            hit = index;
+            maxFraction = value;
+            if (value == 0)break;
+            //only boxes the shortened ray can reach are worth visiting
+            segment = gfc_rect(
+                MIN(ray.x1,ray.x1 + dx * maxFraction),
+                MIN(ray.y1,ray.y1 + dy * maxFraction),
+                fabsf(dx * maxFraction),
+                fabsf(dy * maxFraction));
+        }
+    }
+    gfc_aabb_tree_stack_free(&stack);
+    if (fraction)*fraction = maxFraction;
+    return hit;
+}
+
+typedef struct
+{
+    GFC_AABBTree   *tree;
+    GFC_RaycastHit *nearest;
+}GFC_AABBTreeRaycastContext;
+
+/**
+ * @brief narrowphase for gfc_aabb_tree_raycast_batch, keeps the nearest hit in the context
+ */
+static float gfc_aabb_tree_raycast_shape(Uint32 handle,GFC_Edge2D ray,float maxFraction,void *context)
+{
+    GFC_Shape *shape;
+    GFC_RaycastHit hit;
+    GFC_AABBTreeRaycastContext *raycast = context;
+    shape = raycast->tree->nodes[handle].data;
+    if (!shape)return -1;
+    if (!gfc_raycast_shape(ray,*shape,&hit))return -1;
+    if ((raycast->nearest->hit)&&(hit.fraction >= raycast->nearest->fraction))return -1;
+    hit.id = handle;
+    *raycast->nearest = hit;
+    return hit.fraction;
+}
+
+Uint32 gfc_aabb_tree_raycast_batch(GFC_AABBTree *tree,const GFC_Edge2D *rays,Uint32 rayCount,GFC_RaycastHit *hits)
+{
+    Uint32 i,hitCount = 0;
+    GFC_AABBTreeRaycastContext raycast;
+    if ((!rays)||(!hits))return 0;
+    raycast.tree = tree;
+    for (i = 0; i < rayCount; i++)
+    {
+        memset(&hits[i],0,sizeof(GFC_RaycastHit));
+        hits[i].fraction = 1;
+        raycast.nearest = &hits[i];
+        gfc_aabb_tree_raycast(tree,rays[i],gfc_aabb_tree_raycast_shape,&raycast,NULL);
+        if (hits[i].hit)hitCount++;
+    }
+    return hitCount;
+}
+
+/**
+ * @brief queue a pair of nodes for gfc_aabb_tree_foreach_pair, if their bounds overlap at all
+ */
+static inline void gfc_aabb_tree_push_pair(GFC_AABBTree *tree,GFC_AABBTreeStack *stack,Uint32 a,Uint32 b)
+{
+    if (!gfc_aabb_tree_overlap(tree->nodes[a].bounds,tree->nodes[b].bounds))return;
+    gfc_aabb_tree_stack_push(stack,a);
+    gfc_aabb_tree_stack_push(stack,b);
+}
+
+void gfc_aabb_tree_foreach_pair(GFC_AABBTree *tree,gfc_aabb_tree_pair_func *func,void *context)
+{
+    Uint32 a,b;
+    GFC_AABBTreeNode *nodeA,*nodeB;
+    GFC_AABBTreeStack stack;
+    if ((!tree)||(!func)||(tree->root == GFC_AABB_TREE_NONE))return;
+    //walk the tree against itself, a stack entry is a pair of nodes whose bounds overlap.
+    //a node paired with itself stands for the pairs within its subtree, so each pair is reached once
+    gfc_aabb_tree_stack_init(&stack);
+    gfc_aabb_tree_stack_push(&stack,tree->root);
+    gfc_aabb_tree_stack_push(&stack,tree->root);
+    while (stack.count)
+    {
+        b = stack.items[--stack.count];
+        a = stack.items[--stack.count];
+        nodeA = &tree->nodes[a];
+        nodeB = &tree->nodes[b];
+        if (a == b)
+        {
+            if (nodeA->child1 == GFC_AABB_TREE_NONE)continue;
+            gfc_aabb_tree_stack_push(&stack,nodeA->child1);
+            gfc_aabb_tree_stack_push(&stack,nodeA->child1);
+            gfc_aabb_tree_stack_push(&stack,nodeA->child2);
+            gfc_aabb_tree_stack_push(&stack,nodeA->child2);
+            gfc_aabb_tree_push_pair(tree,&stack,nodeA->child1,nodeA->child2);
+            continue;
+        }
+        if ((nodeA->child1 == GFC_AABB_TREE_NONE)&&(nodeB->child1 == GFC_AABB_TREE_NONE))
+        {
+            func(a,b,context);
+            continue;
+        }
+        //split the bigger of the two, so both sides shrink at about the same rate
+        if ((nodeB->child1 == GFC_AABB_TREE_NONE)||
+            ((nodeA->child1 != GFC_AABB_TREE_NONE)&&
+             (gfc_aabb_tree_perimeter(nodeA->bounds) > gfc_aabb_tree_perimeter(nodeB->bounds))))
+        {
+            gfc_aabb_tree_push_pair(tree,&stack,nodeA->child1,b);
+            gfc_aabb_tree_push_pair(tree,&stack,nodeA->child2,b);
+        }
+        else
+        {
+            gfc_aabb_tree_push_pair(tree,&stack,a,nodeB->child1);
+            gfc_aabb_tree_push_pair(tree,&stack,a,nodeB->child2);
+        }
+    }
+    gfc_aabb_tree_stack_free(&stack);
+}
+
+/*eol@eof*/
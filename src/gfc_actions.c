@@ -94,6 +94,7 @@ GFC_Action *gfc_action_json_parse(SJson *actionSJ)
     if (tempStr)
     {
         gfc_line_cpy(action->name,tempStr);
+        action->atom = gfc_intern(tempStr);
     }
     tempStr = sj_get_string_value(sj_object_get_value(actionSJ,"type"));
     if (gfc_strlcmp(tempStr,"loop")==0)
@@ -219,8 +220,6 @@ GFC_Action *gfc_action_list_get_action_frame(GFC_ActionList *al, const char *nam
 
 GFC_Action *gfc_action_list_get_action(GFC_ActionList *al, const char *name)
 {
-    GFC_Action *action;
-    int i,c;
     if ((!al)||(!al->actions))
     {
         slog("no action list provided");
@@ -231,17 +230,7 @@ GFC_Action *gfc_action_list_get_action(GFC_ActionList *al, const char *name)
         slog("no filename provided");
         return NULL;
     }
-    c = gfc_list_get_count(al->actions);
-    for (i = 0; i < c;i++)
-    {
-        action = gfc_list_get_nth(al->actions,i);
-        if (!action)continue;
-        if (gfc_strlcmp(action->name,name) == 0)
-        {
-            return action;
-        }
-    }
-    return NULL;// not found
+    return gfc_action_list_get_action_by_name(al,name);
 }
 
 Uint32 gfc_action_next_frame_after(GFC_Action *action,float frame)
@@ -381,14 +370,35 @@ GFC_Action *gfc_action_list_get_action_by_frame(GFC_ActionList *list,Uint32 fram
 GFC_Action *gfc_action_list_get_action_by_name(GFC_ActionList *list,const char *name)
 {
     GFC_Action *action;
+    GFC_Atom atom;
     int i,c;
     if ((!list)||(!name))return NULL;
+    atom = gfc_intern_find(name);
+    c = gfc_list_get_count(list->actions);
+    for (i = 0; i < c; i++)
+    {
+        action = gfc_list_get_nth(list->actions,i);
+        if (!action)continue;
+        if (action->atom != GFC_ATOM_NONE)
+        {
+            if (action->atom == atom)return action;
+        }
+        else if (gfc_strlcmp(action->name,name) == 0)return action;//name was set by hand, never interned
+    }
+    return NULL;
+}
+
+GFC_Action *gfc_action_list_get_action_by_atom(GFC_ActionList *list,GFC_Atom atom)
+{
+    GFC_Action *action;
+    int i,c;
+    if ((!list)||(atom == GFC_ATOM_NONE))return NULL;
     c = gfc_list_get_count(list->actions);
     for (i = 0; i < c; i++)
     {
         action = gfc_list_get_nth(list->actions,i);
         if (!action)continue;
-        if (gfc_strlcmp(action->name,name)==0)return action;
+        if (action->atom == atom)return action;
     }
     return NULL;
 }
@@ -0,0 +1,231 @@
+#include "simple_logger.h"
+
+#include "gfc_types.h"
+#include "gfc_array.h"
+
+#define gfc_array_element(array,n) (&(array)->data[(size_t)(n) * (array)->elementSize])
+
+GFC_Array *gfc_array_new(size_t elementSize)
+{
+    return gfc_array_new_size(elementSize,16);
+}
+
+GFC_Array *gfc_array_new_size(size_t elementSize,Uint32 count)
+{
+    GFC_Array *array;
+    if (!elementSize)
+    {
+        slog("cannot make an array of zero sized elements");
+        return NULL;
+    }
+    array = gfc_allocate_array(sizeof(GFC_Array),1);
+    if (!array)return NULL;
+    array->elementSize = elementSize;
+    if (count < 8)count = 8;
+    if (!gfc_array_reserve(array,count))
+    {
+        free(array);
+        return NULL;
+    }
+    return array;
+}
+
+GFC_Array *gfc_array_copy(GFC_Array *old)
+{
+    GFC_Array *array;
+    if (!old)return NULL;
+    array = gfc_array_new_size(old->elementSize,old->count);
+    if (!array)return NULL;
+    if (old->count)memcpy(array->data,old->data,old->elementSize * old->count);
+    array->count = old->count;
+    return array;
+}
+
+void gfc_array_delete(GFC_Array *array)
+{
+    if (!array)return;
+    if (array->data)free(array->data);
+    free(array);
+}
+
+void gfc_array_clear(GFC_Array *array)
+{
+    if (!array)return;
+    array->count = 0;
+}
+
+static int gfc_array_resize(GFC_Array *array,Uint32 size)
+{
+    Uint8 *data;
+    data = realloc(array->data,array->elementSize * size);
+    if (!data)
+    {
+        slog("failed to allocate space for %i array elements",size);
+        return 0;
+    }
+    array->data = data;
+    array->size = size;
+    return 1;
+}
+
+int gfc_array_reserve(GFC_Array *array,Uint32 count)
+{
+    if (!array)return 0;
+    if (count <= array->size)return 1;
+    return gfc_array_resize(array,count);
+}
+
+void gfc_array_shrink_to_fit(GFC_Array *array)
+{
+    if (!array)return;
+    if (array->size == MAX(array->count,1))return;
+    gfc_array_resize(array,MAX(array->count,1));
+}
+
+static int gfc_array_expand(GFC_Array *array)
+{
+    if (array->count < array->size)return 1;
+    return gfc_array_resize(array,array->size ? array->size * 2 : 8);
+}
+
+void *gfc_array_get_nth(GFC_Array *array,Uint32 n)
+{
+    if (!array)return NULL;
+    if (n >= array->count)return NULL;
+    return gfc_array_element(array,n);
+}
+
+void gfc_array_set_nth(GFC_Array *array,Uint32 n,const void *data)
+{
+    if ((!array)||(!data))return;
+    if (n >= array->count)return;
+    memcpy(gfc_array_element(array,n),data,array->elementSize);
+}
+
+void *gfc_array_append(GFC_Array *array,const void *data)
+{
+    return gfc_array_insert(array,data,array ? array->count : 0);
+}
+
+void *gfc_array_insert(GFC_Array *array,const void *data,Uint32 n)
+{
+    Uint8 *element;
+    size_t offset = 0;
+    int inside = 0;
+    if (!array)
+    {
+        slog("no array provided");
+        return NULL;
+    }
+    if (n > array->count)
+    {
+        slog("attempting to insert element beyond length of array");
+        return NULL;
+    }
+    if ((data)&&(array->count)&&((const Uint8 *)data >= (Uint8 *)array->data)&&
+        ((const Uint8 *)data < (Uint8 *)array->data + array->elementSize * array->count))
+    {
+        //data is one of our own elements, which moves if we grow or shift, so keep track of it by offset
+        inside = 1;
+        offset = (const Uint8 *)data - (Uint8 *)array->data;
+    }
+    if (!gfc_array_expand(array))return NULL;
+    element = gfc_array_element(array,n);
+    if (n < array->count)
+    {
+        memmove(element + array->elementSize,element,array->elementSize * (array->count - n));
+        if ((inside)&&(offset >= array->elementSize * n))offset += array->elementSize;
+    }
+    if (inside)data = (Uint8 *)array->data + offset;
+    if (data)memcpy(element,data,array->elementSize);
+    else memset(element,0,array->elementSize);
+    array->count++;
+    return element;
+}
+
+int gfc_array_delete_nth(GFC_Array *array,Uint32 n)
+{
+    if (!array)
+    {
+        slog("no array provided");
+        return -1;
+    }
+    if (n >= array->count)
+    {
+        slog("attempting to delete beyond the length of the array");
+        return -1;
+    }
+    array->count--;
+    if (n < array->count)
+    {
+        memmove(gfc_array_element(array,n),gfc_array_element(array,n + 1),array->elementSize * (array->count - n));
+    }
+    return 0;
+}
+
+int gfc_array_delete_nth_unordered(GFC_Array *array,Uint32 n)
+{
+    if (!array)
+    {
+        slog("no array provided");
+        return -1;
+    }
+    if (n >= array->count)
+    {
+        slog("attempting to delete beyond the length of the array");
+        return -1;
+    }
+    array->count--;
+    if (n < array->count)
+    {
+        memcpy(gfc_array_element(array,n),gfc_array_element(array,array->count),array->elementSize);
+    }
+    return 0;
+}
+
+int gfc_array_delete_last(GFC_Array *array)
+{
+    if (!array)
+    {
+        slog("no array provided");
+        return -1;
+    }
+    if (!array->count)return -1;
+    array->count--;
+    return 0;
+}
+
+Uint32 gfc_array_get_count(GFC_Array *array)
+{
+    if (!array)return 0;
+    return array->count;
+}
+
+void gfc_array_sort(GFC_Array *array,int (*compare)(const void *a,const void *b))
+{
+    if ((!array)||(!compare))return;
+    if (array->count <= 1)return;
+    qsort(array->data,array->count,array->elementSize,compare);
+}
+
+void gfc_array_foreach(GFC_Array *array,void (*function)(void *data))
+{
+    Uint32 i;
+    if ((!array)||(!function))return;
+    for (i = 0;i < array->count;i++)
+    {
+        function(gfc_array_element(array,i));
+    }
+}
+
+void gfc_array_foreach_context(GFC_Array *array,void (*function)(void *data,void *context),void *contextData)
+{
+    Uint32 i;
+    if ((!array)||(!function))return;
+    for (i = 0;i < array->count;i++)
+    {
+        function(gfc_array_element(array,i),contextData);
+    }
+}
+
+/*eol@eof*/
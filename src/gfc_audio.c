@@ -9,6 +9,7 @@
 typedef struct
 {
     GFC_TextLine    name;
+    GFC_Atom        atom;   /**<the interned name, ignoring case*/
     float           volume;
     int             from;
     int             to;
@@ -95,21 +96,28 @@ ChannelGroup *gfc_audio_channel_group_new()
     return gfc_allocate_array(sizeof(ChannelGroup),1);
 }
 
-ChannelGroup *gfc_audio_get_group(const char *groupName)
+ChannelGroup *gfc_audio_get_group_by_atom(GFC_Atom atom)
 {
     int i,c;
     ChannelGroup *group;
-    if (!groupName)return NULL;
+    if (atom == GFC_ATOM_NONE)return NULL;
     c = gfc_list_count(sound_manager.channelGroups);
     for (i = 0; i < c;i++)
     {
         group = gfc_list_nth(sound_manager.channelGroups,i);
         if (!group)continue;
-        if (gfc_stricmp(groupName,group->name) == 0)return group;
+        if (group->atom == atom)return group;
     }
     return NULL;
 }
 
+ChannelGroup *gfc_audio_get_group(const char *groupName)
+{
+    if (!groupName)return NULL;
+    //group names have always been case insensitive
+    return gfc_audio_get_group_by_atom(gfc_intern_find_nocase(groupName));
+}
+
 void gfc_audio_parse_groups(SJson *json)
 {
     int from = 0;
@@ -137,6 +145,7 @@ void gfc_audio_parse_groups(SJson *json)
         if (!group)continue;
         count = 0;
         sj_object_line_value(item,"name",group->name);
+        group->atom = gfc_intern_nocase(group->name);
         sj_object_get_int(item,"channels",&count);
         if (sj_object_get_uint8(item,"volume",&groupVolume))
         {
@@ -256,12 +265,13 @@ GFC_Sound *gfc_sound_new()
     return NULL;
 }
 
-GFC_Sound *gfc_sound_get_by_filename(const char * filename)
+GFC_Sound *gfc_sound_get_by_atom(GFC_Atom atom)
 {
     int i;
+    if (atom == GFC_ATOM_NONE)return NULL;
     for (i = 0;i < sound_manager.max_sounds;i++)
     {
-        if (gfc_line_cmp(sound_manager.sound_list[i].filepath,filename)==0)
+        if (sound_manager.sound_list[i].atom == atom)
         {
             return &sound_manager.sound_list[i];
         }
@@ -269,6 +279,12 @@ GFC_Sound *gfc_sound_get_by_filename(const char * filename)
     return NULL;// not found
 }
 
+GFC_Sound *gfc_sound_get_by_filename(const char * filename)
+{
+    if (!filename)return NULL;
+    return gfc_sound_get_by_atom(gfc_intern_find(filename));
+}
+
 GFC_Sound *gfc_sound_load(const char *filename,float volume,int defaultChannel)
 {
     char *buffer = NULL;
@@ -324,6 +340,7 @@ GFC_Sound *gfc_sound_load(const char *filename,float volume,int defaultChannel)
     sound->volume = volume;
     sound->defaultChannel = defaultChannel;
     gfc_line_cpy(sound->filepath,filename);
+    sound->atom = gfc_intern(filename);
     return sound;
 }
 
@@ -434,7 +451,7 @@ GFC_HashMap *gfc_sound_pack_parse(SJson *sounds)
     
     c = sj_array_get_count(sounds);
     if (!c)return NULL;
-    pack = gfc_hashmap_new();
+    pack = gfc_hashmap_new_reserve(c);
     if (!pack)return NULL;
     for (i = 0; i < c; i++)
     {
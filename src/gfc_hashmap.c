@@ -1,258 +1,623 @@
 #include "simple_logger.h"
 #include "gfc_hashmap.h"
+#include "gfc_thread_pool.h"
 
-Uint32 gfc_hash(GFC_HashMap *map,const char *key)
+Uint32 gfc_hash_djb2(const char *key,size_t length,Uint32 seed)
+{
+    Uint32 h = seed;
+    size_t i;
+    for (i = 0;i < length;i++)
+    {
+        h = h * 33 + key[i];
+    }
+    return h;
+}
+
+#define GFC_HASH_PRIME1 0x9E3779B185EBCA87ULL
+#define GFC_HASH_PRIME2 0xC2B2AE3D27D4EB4FULL
+#define GFC_HASH_PRIME3 0x165667B19E3779F9ULL
+#define gfc_hash_rotl(x,r) (((x) << (r)) | ((x) >> (64 - (r))))
+
+Uint32 gfc_hash_fast(const char *key,size_t length,Uint32 seed)
+{
+    Uint64 h,w;
+    const char *p = key;
+    size_t left = length;
+    h = ((Uint64)seed + GFC_HASH_PRIME3) ^ ((Uint64)length * GFC_HASH_PRIME1);
+    while (left >= 8)
+    {
+        memcpy(&w,p,8);//unaligned safe load, compiles to a single mov
+        w *= GFC_HASH_PRIME2;
+        w = gfc_hash_rotl(w,31);
+        w *= GFC_HASH_PRIME1;
+        h ^= w;
+        h = gfc_hash_rotl(h,27) * GFC_HASH_PRIME1 + GFC_HASH_PRIME3;
+        p += 8;
+        left -= 8;
+    }
+    if (left)
+    {
+        w = 0;
+        memcpy(&w,p,left);
+        w *= GFC_HASH_PRIME1;
+        w = gfc_hash_rotl(w,31);
+        w *= GFC_HASH_PRIME2;
+        h ^= w;
+    }
+    //final avalanche so every input bit affects the low bits we mask with
+    h ^= h >> 33;
+    h *= GFC_HASH_PRIME2;
+    h ^= h >> 29;
+    h *= GFC_HASH_PRIME3;
+    h ^= h >> 32;
+    return (Uint32)h;
+}
+
+Uint32 gfc_hash(GFC_HashMap *map,const char *key,size_t length)
 {
     Uint32 h;
-    const char *p;
     if (!map)return 0;
-    h = map->seed;
-    for (p = key;*p != 0;p++)
+    h = map->hash(key,length,map->seed);
+    if (!h)h = 1;//zero is reserved to mark empty slots
+    return h;
+}
+
+#define GFC_HASHMAP_MIN_SIZE 8
+#define GFC_HASHMAP_MIN_ARENA 256
+// grow once the table would be more than 7/8ths full.  Robin hood probing keeps probe lengths short even at high load
+#define gfc_hashmap_over_load(count,size) ((count) * 8 > (size) * 7)
+// arena entries are the key length followed by the null terminated key, padded so the next length stays aligned
+#define gfc_hashmap_entry_size(length) ((sizeof(Uint32) + (length) + 1 + 3) & ~3)
+#define gfc_hashmap_key_length(map,i) (*(Uint32 *)&(map)->arena[(map)->keys[i]])
+#define gfc_hashmap_key(map,i) (&(map)->arena[(map)->keys[i] + sizeof(Uint32)])
+
+/**
+ * @brief how far the slot at index is from its home slot, accounting for wraparound
+ */
+static Uint32 gfc_hashmap_probe_distance(GFC_HashMap *map,Uint32 hashValue,Uint32 index)
+{
+    return (index + map->size - (hashValue & (map->size - 1))) & (map->size - 1);
+}
+
+/**
+ * @brief place a slot in the table using robin hood displacement.
+ * @note the caller must ensure there is room and that the key is not already present
+ */
+static void gfc_hashmap_place(GFC_HashMap *map,Uint32 hashValue,Uint32 key,void *value)
+{
+    Uint32 i,dist,otherDist;
+    Uint32 otherHash,otherKey;
+    void *otherValue;
+    Uint32 mask = map->size - 1;
+    i = hashValue & mask;
+    dist = 0;
+    for (;;)
     {
-        h = h * 33 + *p;
+        if (!map->hashes[i])
+        {
+            map->hashes[i] = hashValue;
+            map->keys[i] = key;
+            map->values[i] = value;
+            return;
+        }
+        otherDist = gfc_hashmap_probe_distance(map,map->hashes[i],i);
+        if (otherDist < dist)
+        {
+            //the resident is closer to home than we are, take its slot and keep placing it instead
+            otherHash = map->hashes[i];
+            otherKey = map->keys[i];
+            otherValue = map->values[i];
+            map->hashes[i] = hashValue;
+            map->keys[i] = key;
+            map->values[i] = value;
+            hashValue = otherHash;
+            key = otherKey;
+            value = otherValue;
+            dist = otherDist;
+        }
+        i = (i + 1) & mask;
+        dist++;
+    }
+}
+
+/**
+ * @brief copy only the live keys into a fresh arena of at least size bytes, dropping deleted keys
+ */
+static int gfc_hashmap_arena_compact(GFC_HashMap *map,Uint32 size)
+{
+    Uint32 i,length,used = 0;
+    char *arena;
+    for (;size < map->arenaUsed - map->arenaDead;size *= 2);
+    arena = gfc_allocate_array(sizeof(char),size);
+    if (!arena)return 0;
+    for (i = 0; i < map->size;i++)
+    {
+        if (!map->hashes[i])continue;
+        length = gfc_hashmap_entry_size(gfc_hashmap_key_length(map,i));
+        memcpy(&arena[used],&map->arena[map->keys[i]],length);
+        map->keys[i] = used;
+        used += length;
+    }
+    free(map->arena);
+    map->arena = arena;
+    map->arenaSize = size;
+    map->arenaUsed = used;
+    map->arenaDead = 0;
+    return 1;
+}
+
+/**
+ * @brief make sure the arena has room for another length bytes, growing or compacting it as needed
+ * @return 0 on memory error, 1 otherwise
+ */
+static int gfc_hashmap_arena_reserve(GFC_HashMap *map,Uint32 length)
+{
+    Uint32 size;
+    char *arena;
+    if (map->arenaUsed + length <= map->arenaSize)return 1;
+    if ((map->arenaDead > map->arenaUsed / 2)&&(map->arenaUsed - map->arenaDead + length <= map->arenaSize))
+    {
+        //mostly garbage, reclaim it rather than growing
+        return gfc_hashmap_arena_compact(map,map->arenaSize);
+    }
+    for (size = map->arenaSize ? map->arenaSize : GFC_HASHMAP_MIN_ARENA;size < map->arenaUsed + length;size *= 2);
+    arena = realloc(map->arena,size);
+    if (!arena)
+    {
+        slog("failed to grow hashmap key arena");
+        return 0;
+    }
+    map->arena = arena;
+    map->arenaSize = size;
+    return 1;
+}
+
+/**
+ * @brief copy a key into the arena
+ * @return the offset of the key in the arena, or -1 on memory error
+ */
+static Sint64 gfc_hashmap_arena_add(GFC_HashMap *map,const char *key,Uint32 keyLength)
+{
+    Uint32 offset,length;
+    length = gfc_hashmap_entry_size(keyLength);
+    if (!gfc_hashmap_arena_reserve(map,length))return -1;
+    offset = map->arenaUsed;
+    memset(&map->arena[offset],0,length);
+    memcpy(&map->arena[offset],&keyLength,sizeof(Uint32));
+    memcpy(&map->arena[offset + sizeof(Uint32)],key,keyLength);
+    map->arenaUsed += length;
+    return offset;
+}
+
+void gfc_hashmap_resize(GFC_HashMap *map,Uint32 size)
+{
+    Uint32 i,oldSize;
+    Uint32 *oldHashes,*oldKeys;
+    void **oldValues;
+    Uint32 *hashes,*keys;
+    void **values;
+    if (!map)return;
+    hashes = gfc_allocate_array(sizeof(Uint32),size);
+    keys = gfc_allocate_array(sizeof(Uint32),size);
+    values = gfc_allocate_array(sizeof(void *),size);
+    if ((!hashes)||(!keys)||(!values))
+    {
+        slog("failed to resize hashmap");
+        free(hashes);
+        free(keys);
+        free(values);
+        return;
+    }
+    oldHashes = map->hashes;
+    oldKeys = map->keys;
+    oldValues = map->values;
+    oldSize = map->size;
+    map->hashes = hashes;
+    map->keys = keys;
+    map->values = values;
+    map->size = size;
+    if (!oldHashes)return;
+    for (i = 0; i < oldSize;i++)
+    {
+        if (!oldHashes[i])continue;
+        gfc_hashmap_place(map,oldHashes[i],oldKeys[i],oldValues[i]);
+    }
+    free(oldHashes);
+    free(oldKeys);
+    free(oldValues);
+    if (map->arenaDead)
+    {
+        gfc_hashmap_arena_compact(map,map->arenaSize);
     }
-    return h;
 }
 
 void gfc_hashmap_set_seed(GFC_HashMap *map,Uint32 seed)
 {
+    Uint32 i;
     if (!map)return;
     map->seed = seed;
+    if ((!map->hashes)||(!map->count))return;
+    //every stored hash is now stale, recompute them and re-place everything
+    for (i = 0; i < map->size;i++)
+    {
+        if (!map->hashes[i])continue;
+        map->hashes[i] = gfc_hash(map,gfc_hashmap_key(map,i),gfc_hashmap_key_length(map,i));
+    }
+    gfc_hashmap_resize(map,map->size);
+}
+
+void gfc_hashmap_set_hash_func(GFC_HashMap *map,gfc_hash_func *func)
+{
+    if ((!map)||(!func))return;
+    map->hash = func;
+    gfc_hashmap_set_seed(map,map->seed);//rehash everything with the new function
 }
 
 GFC_HashMap *gfc_hashmap_new_size(Uint32 size)
 {
+    Uint32 slots;
     GFC_HashMap *map = NULL;
     map = (GFC_HashMap *)gfc_allocate_array(sizeof(GFC_HashMap),1);
     if (!map)return NULL;
     map->seed = 5381;   //re: Glib did it
-    map->map = gfc_list_new_size(size);
-    map->size = size;
+    map->hash = gfc_hash_fast;
+    for (slots = GFC_HASHMAP_MIN_SIZE;slots < size;slots *= 2);//power of two so we can mask instead of mod
+    gfc_hashmap_resize(map,slots);
+    if (!map->hashes)
+    {
+        free(map);
+        return NULL;
+    }
     return map;
 }
 
 GFC_HashMap *gfc_hashmap_new()
 {
-    return gfc_hashmap_new_size(4);
+    return gfc_hashmap_new_size(GFC_HASHMAP_MIN_SIZE);
+}
+
+void gfc_hashmap_reserve(GFC_HashMap *map,Uint32 count)
+{
+    Uint32 slots;
+    if ((!map)||(!map->hashes))return;
+    for (slots = map->size;gfc_hashmap_over_load(count,slots);slots *= 2);
+    if (slots == map->size)return;
+    gfc_hashmap_resize(map,slots);
+}
+
+GFC_HashMap *gfc_hashmap_new_reserve(Uint32 count)
+{
+    GFC_HashMap *map;
+    map = gfc_hashmap_new_size(GFC_HASHMAP_MIN_SIZE);
+    gfc_hashmap_reserve(map,count);
+    return map;
 }
 
 void gfc_hashmap_free(GFC_HashMap *map)
 {
-    GFC_HashElement *element;
-    int i;
     if (!map)return;
-    //free all the keys
-    // TODO redo this based on how we are using the list
-    if (map->map)
-    {
-        for (i = 0; i < map->map->size; i++)
-        {
-            element = map->map->elements[i].data;
-            if (!element)continue;
-            free(element);
-            map->map->elements[i].data = NULL;
-        }
-        gfc_list_delete(map->map);
-    }
+    free(map->hashes);
+    free(map->keys);
+    free(map->values);
+    free(map->arena);
     free(map);
 }
 
-void gfc_hashmap_rehash(GFC_HashMap *map)
+Sint64 gfc_hashmap_find(GFC_HashMap *map,const char *key,size_t length,Uint32 h)
 {
-    int i;
-    GFC_HashMap *newmap;
-    GFC_HashElement*element;
-    if (!map)return;
-    newmap = gfc_hashmap_new_size(map->size * 2);
-    for (i = 0; i < map->map->size;i++)
+    Uint32 i,dist;
+    Uint32 mask = map->size - 1;
+    i = h & mask;
+    for (dist = 0;dist < map->size;dist++)
     {
-        if (map->map->elements[i].data == NULL)continue;
-        
-        element = map->map->elements[i].data;
-        gfc_hashmap_insert(newmap,element->key,element->data);
-        free(element);
+        if (!map->hashes[i])return -1;//hit an empty slot, the key would have been placed here
+        if (gfc_hashmap_probe_distance(map,map->hashes[i],i) < dist)
+        {
+            return -1;//robin hood invariant: our key would have displaced this one
+        }
+        if ((map->hashes[i] == h)
+            &&(gfc_hashmap_key_length(map,i) == length)
+            &&(memcmp(gfc_hashmap_key(map,i),key,length) == 0))
+        {
+            return i;
+        }
+        i = (i + 1) & mask;
     }
-    gfc_list_delete(map->map);
-    map->map = newmap->map;
-    map->size = newmap->size;
-    map->seed = newmap->seed;
-    newmap->map = NULL;
-    gfc_hashmap_free(newmap);
+    return -1;//not found
 }
 
 void gfc_hashmap_insert(GFC_HashMap *map,const char *key,void *data)
 {
-    Uint32 h,i;
-    GFC_HashElement *element = NULL;
-    GFC_HashElement *collision;
-    if (!map)return;
+    Uint32 h;
+    size_t length;
+    Sint64 index,offset;
+    if ((!map)||(!map->hashes))return;
     if (!key)
     {
         slog("cannot insert into hashmap, no key provided");
         return;
     }
-    element = gfc_allocate_array(sizeof(GFC_HashElement),1);
-    if (!element)return;
-    h = gfc_hash(map,key);
-    h = h %map->size;
-    i = h;
-    while (map->map->elements[i].data != NULL)
-    {   //collision
-        collision = (GFC_HashElement *)map->map->elements[i].data;
-        if (collision->hashValue != h)
+    length = strlen(key);
+    h = gfc_hash(map,key,length);
+    index = gfc_hashmap_find(map,key,length,h);
+    if (index >= 0)
+    {
+        map->values[index] = data;
+        return;
+    }
+    if (gfc_hashmap_over_load(map->count + 1,map->size))
+    {
+        gfc_hashmap_resize(map,map->size * 2);
+    }
+    offset = gfc_hashmap_arena_add(map,key,length);
+    if (offset < 0)return;
+    gfc_hashmap_place(map,h,(Uint32)offset,data);
+    map->count++;
+}
+
+void gfc_hashmap_insert_batch(GFC_HashMap *map,const char **keys,void **values,Uint32 count)
+{
+    Uint32 i,h,keyBytes = 0;
+    size_t length;
+    Sint64 index,offset;
+    if ((!map)||(!map->hashes)||(!keys)||(!count))return;
+    //size everything once up front, then it is one pass of hash and place
+    gfc_hashmap_reserve(map,map->count + count);
+    for (i = 0;i < count;i++)
+    {
+        if (!keys[i])continue;
+        keyBytes += gfc_hashmap_entry_size(strlen(keys[i]));
+    }
+    if (!gfc_hashmap_arena_reserve(map,keyBytes))return;
+    for (i = 0;i < count;i++)
+    {
+        if (!keys[i])continue;
+        length = strlen(keys[i]);
+        h = gfc_hash(map,keys[i],length);
+        index = gfc_hashmap_find(map,keys[i],length,h);
+        if (index >= 0)
         {
-            //no room to chain, we need to expand and rehash.
-            gfc_hashmap_rehash(map);
-            h = gfc_hash(map,key);
-            h = h %map->size;
-            i = h;
-            if (map->map->elements[i].data == NULL)break;
+            map->values[index] = values ? values[i] : NULL;
+            continue;
         }
-        i++;
-        if (i >= map->map->size)
+        if (gfc_hashmap_over_load(map->count + 1,map->size))
         {
-            gfc_hashmap_rehash(map);
-            h = gfc_hash(map,key);
-            h = h %map->size;
-            i = h;
-            if (map->map->elements[i].data == NULL)break;
+            gfc_hashmap_resize(map,map->size * 2);//only if the reserve failed
         }
+        offset = gfc_hashmap_arena_add(map,keys[i],length);
+        if (offset < 0)return;
+        gfc_hashmap_place(map,h,(Uint32)offset,values ? values[i] : NULL);
+        map->count++;
     }
-    element->hashValue = h;
-    element->data = data;
-    gfc_line_cpy(element->key,key);
-    map->map->elements[i].data = element;
 }
 
 Sint64 gfc_hashmap_get_index(GFC_HashMap *map,const char *key)
 {
-    Uint32 h,i;
-    GFC_HashElement *element;
+    size_t length;
     if (!map)return -1;
-    if (!map->map)
+    if (!map->hashes)
     {
         slog("hashmap missing map of values");
         return -1;
     }
     if (!key)return -1;
-    h = gfc_hash(map,key);
-    h = h %map->size;
-    i = h;
-    element = (GFC_HashElement *)map->map->elements[h].data;
-    if (!element)return -1;
-    do
-    {
-        if ((strcmp(key,element->key)==0)&&(strlen(key) == strlen(element->key)))
-        {
-            return i;
-        }
-        //keys don't match, so look at the next element in the array
-        if ((i +1) >= map->size)return -1;// we seeked too far
-        element = (GFC_HashElement *)map->map->elements[++i].data;
-    }
-    while ((element)&&(element->hashValue == h));
-    return -1;//not found
+    length = strlen(key);
+    return gfc_hashmap_find(map,key,length,gfc_hash(map,key,length));
+}
+
+Uint32 gfc_hashmap_hash_key(GFC_HashMap *map,const char *key,size_t *lengthOut)
+{
+    size_t length;
+    if ((!map)||(!key))return 0;
+    length = strlen(key);
+    if (lengthOut)*lengthOut = length;
+    return gfc_hash(map,key,length);
+}
+
+void *gfc_hashmap_get_hashed(GFC_HashMap *map,const char *key,Uint32 hash,size_t length)
+{
+    Sint64 index;
+    if ((!map)||(!map->hashes)||(!key))return NULL;
+    if (!hash)hash = 1;//same fixup gfc_hash applies
+    index = gfc_hashmap_find(map,key,length,hash);
+    if (index < 0)return NULL;
+    return map->values[index];
 }
 
 void *gfc_hashmap_get(GFC_HashMap *map,const char *key)
 {
-    GFC_HashElement *element;
     Sint64 index;
-    if ((!map)||(!map->map)||(!map->map->elements))return NULL;
+    if ((!map)||(!map->hashes))return NULL;
     index = gfc_hashmap_get_index(map,key);
     if (index < 0)return NULL;
     if (index >= map->size)return NULL;
-    element = (GFC_HashElement *)map->map->elements[index].data;
-    return element->data;
+    return map->values[index];
+}
+
+Uint32 gfc_hashmap_get_count(GFC_HashMap *map)
+{
+    if (!map)return 0;
+    return map->count;
 }
 
 void gfc_hashmap_slog(GFC_HashMap *map)
 {
     int i;
-    GFC_HashElement *element;
-    if ((!map) || (!map->map))return;
-    slog("GFC_Hashmap:");
-    for (i = 0; i < map->map->size; i++)
+    if ((!map) || (!map->hashes))return;
+    slog("GFC_Hashmap: %i keys in %i slots, %i key bytes",map->count,map->size,map->arenaUsed - map->arenaDead);
+    for (i = 0; i < map->size; i++)
+    {
+        if (!map->hashes[i])continue;
+        slog("GFC_Hash key: '%s' hashValue: %u, hashIndex: %i, probe distance: %u",
+             gfc_hashmap_key(map,i),
+             map->hashes[i],
+             i,
+             gfc_hashmap_probe_distance(map,map->hashes[i],i));
+    }
+}
+
+void gfc_hashmap_delete_index(GFC_HashMap *map,Uint32 index)
+{
+    Uint32 i,next,mask;
+    map->arenaDead += gfc_hashmap_entry_size(gfc_hashmap_key_length(map,index));
+    map->hashes[index] = 0;
+    map->values[index] = NULL;
+    map->count--;
+    //backward shift: pull the rest of the cluster back one slot so no tombstone is needed
+    mask = map->size - 1;
+    i = index;
+    next = (i + 1) & mask;
+    for (;;)
     {
-        if (map->map->elements[i].data == NULL)continue;
-        element = (GFC_HashElement*)map->map->elements[i].data;
-        slog("GFC_Hash key: '%s' hashValue: %i, hashIndex: %i",element->key,element->hashValue,i);
+        if (!map->hashes[next])return; // cluster has ended
+        if (gfc_hashmap_probe_distance(map,map->hashes[next],next) == 0)return;// already home
+        map->hashes[i] = map->hashes[next];
+        map->keys[i] = map->keys[next];
+        map->values[i] = map->values[next];
+        map->hashes[next] = 0;
+        map->values[next] = NULL;
+        i = next;
+        next = (next + 1) & mask;
     }
 }
 
 void gfc_hashmap_delete_by_key(GFC_HashMap *map,const char *key)
 {
-    GFC_HashElement *element, *target;
     Sint64 index;
-    Uint32 hashValue;
     if (!map)return;
     index = gfc_hashmap_get_index(map,key);
     if (index < 0)return; // not found, nothing to do
-    target = (GFC_HashElement *)map->map->elements[index].data;
-    map->map->elements[index].data = NULL;
-    hashValue = target->hashValue;
-    free(target);
-    while ((index + 1) < map->map->size)
+    gfc_hashmap_delete_index(map,(Uint32)index);
+}
+
+void gfc_hashmap_iter_begin(GFC_HashMap *map,GFC_HashMapIter *iter)
+{
+    Uint32 i;
+    if (!iter)return;
+    memset(iter,0,sizeof(GFC_HashMapIter));
+    if ((!map)||(!map->hashes)||(!map->count))return;
+    // the load factor guarantees an empty slot.  Starting after one means a backward shift
+    // can only ever pull not yet visited elements into the slot we are on
+    for (i = 0; i < map->size;i++)
     {
-        element = (GFC_HashElement *)map->map->elements[index + 1].data;
-        if (!element)return; // chain has ended;
-        if (element->hashValue != hashValue)return; // done, the chain has ended
-        map->map->elements[index].data = map->map->elements[index + 1].data;
-        map->map->elements[index + 1].data = NULL;
-        index++;
+        if (!map->hashes[i])break;
     }
+    iter->map = map;
+    iter->start = i;
+}
+
+static int gfc_hashmap_iter_set(GFC_HashMapIter *iter,Uint32 index)
+{
+    iter->keyOffset = iter->map->keys[index];
+    iter->key = gfc_hashmap_key(iter->map,index);
+    iter->value = iter->map->values[index];
+    return 1;
+}
+
+int gfc_hashmap_iter_next(GFC_HashMapIter *iter)
+{
+    Uint32 i,mask;
+    GFC_HashMap *map;
+    if ((!iter)||(!iter->map))return 0;
+    map = iter->map;
+    mask = map->size - 1;
+    if (iter->key)
+    {
+        i = (iter->start + iter->step) & mask;
+        if ((map->hashes[i])&&(map->keys[i] != iter->keyOffset))
+        {
+            //the current element was deleted and the next one in its cluster shifted into its slot
+            return gfc_hashmap_iter_set(iter,i);
+        }
+    }
+    while (iter->step + 1 < map->size)
+    {
+        iter->step++;
+        i = (iter->start + iter->step) & mask;
+        if (map->hashes[i])return gfc_hashmap_iter_set(iter,i);
+    }
+    iter->key = NULL;
+    iter->value = NULL;
+    iter->map = NULL;
+    return 0;
+}
+
+void gfc_hashmap_iter_delete(GFC_HashMapIter *iter)
+{
+    Uint32 i;
+    if ((!iter)||(!iter->map)||(!iter->key))return;
+    i = (iter->start + iter->step) & (iter->map->size - 1);
+    if ((!iter->map->hashes[i])||(iter->map->keys[i] != iter->keyOffset))return;//already gone
+    gfc_hashmap_delete_index(iter->map,i);
 }
 
 GFC_List *gfc_hashmap_get_all_values(GFC_HashMap *map)
 {
-    int i;
-    GFC_HashElement *element;
+    GFC_HashMapIter it;
     GFC_List *valueList = NULL;
-    if ((!map) || (!map->map))return NULL;
-    valueList = gfc_list_new();
-    for (i = 0; i < map->map->size; i++)
+    if ((!map) || (!map->hashes))return NULL;
+    valueList = gfc_list_new_size(MAX(map->count,1));
+    if (!valueList)return NULL;
+    gfc_hashmap_iter_begin(map,&it);
+    while (gfc_hashmap_iter_next(&it))
     {
-        element = (GFC_HashElement *)map->map->elements[i].data;
-        if (!element)continue;
-        gfc_list_append(valueList,element);
+        gfc_list_append(valueList,it.value);
     }
     return valueList;
 }
 
 void gfc_hashmap_foreach(GFC_HashMap *map, gfc_work_func func)
 {
-    int i,c;
-    void *item;
-    GFC_List *items;
+    GFC_HashMapIter it;
     if ((!map)||(!func))return;
-    items = gfc_hashmap_get_all_values(map);
-    if (!items)return;
-    c = gfc_list_get_count(items);
-    for (i = 0;i < c;i++)
+    gfc_hashmap_iter_begin(map,&it);
+    while (gfc_hashmap_iter_next(&it))
     {
-        item = gfc_list_get_nth(items,i);
-        if (!item)continue;
-        func(item);
+        if (!it.value)continue;
+        func(it.value);
     }
-    gfc_list_delete(items);
 }
 
 void gfc_hashmap_foreach_context(GFC_HashMap *map, gfc_work_func_context func,void *context)
 {
-    int i,c;
-    void *item;
-    GFC_List *items;
+    GFC_HashMapIter it;
     if ((!map)||(!func))return;
-    items = gfc_hashmap_get_all_values(map);
-    if (!items)return;
-    c = gfc_list_get_count(items);
-    for (i = 0;i < c;i++)
+    gfc_hashmap_iter_begin(map,&it);
+    while (gfc_hashmap_iter_next(&it))
+    {
+        if (!it.value)continue;
+        func(it.value,context);
+    }
+}
+
+typedef struct
+{
+    GFC_HashMap *map;
+    gfc_work_func_context *func;
+    void *context;
+}GFC_HashMapParallelJob;
+
+static void gfc_hashmap_foreach_parallel_range(Uint32 start,Uint32 end,void *context)
+{
+    Uint32 i;
+    GFC_HashMapParallelJob *job = context;
+    for (i = start;i < end;i++)
     {
-        item = gfc_list_get_nth(items,i);
-        if (!item)continue;
-        func(item,context);
+        if ((!job->map->hashes[i])||(!job->map->values[i]))continue;
+        job->func(job->map->values[i],job->context);
     }
-    gfc_list_delete(items);
+}
+
+void gfc_hashmap_foreach_parallel(GFC_HashMap *map, gfc_work_func_context func,void *context,Uint32 grainSize)
+{
+    GFC_HashMapParallelJob job;
+    if ((!map)||(!func))return;
+    if (!map->count)return;
+    job.map = map;
+    job.func = func;
+    job.context = context;
+    //split over the slots rather than the elements, empty slots are just skipped
+    gfc_thread_pool_parallel_for(map->size,grainSize,gfc_hashmap_foreach_parallel_range,&job);
 }
 
 
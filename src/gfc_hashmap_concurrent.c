@@ -0,0 +1,295 @@
+#include "simple_logger.h"
+#include "gfc_hashmap_concurrent.h"
+
+#define GFC_CONCURRENT_MIN_SIZE 16
+#define GFC_CONCURRENT_KEY_CHUNK 4096
+// linear probing degrades faster than robin hood, so grow at 3/4 full.  Tombstones count against the load
+#define gfc_concurrent_over_load(count,size) ((count) * 4 > (size) * 3)
+
+/**
+ * @brief key entries are the key length followed by the null terminated key, same as the GFC_HashMap arena
+ */
+#define gfc_concurrent_key_length(entry) (*(Uint32 *)(entry))
+#define gfc_concurrent_key_text(entry) ((const char *)(entry) + sizeof(Uint32))
+
+static Uint32 gfc_hashmap_concurrent_hash(GFC_ConcurrentHashMap *map,const char *key,size_t length)
+{
+    Uint32 h;
+    h = gfc_hash_fast(key,length,map->seed);
+    if (!h)h = 1;
+    return h;
+}
+
+static GFC_ConcurrentTable *gfc_concurrent_table_new(Uint32 size)
+{
+    GFC_ConcurrentTable *table;
+    table = gfc_allocate_array(sizeof(GFC_ConcurrentTable),1);
+    if (!table)return NULL;
+    table->slots = gfc_allocate_array(sizeof(GFC_ConcurrentSlot),size);
+    if (!table->slots)
+    {
+        free(table);
+        return NULL;
+    }
+    table->size = size;
+    return table;
+}
+
+static void gfc_concurrent_table_free(GFC_ConcurrentTable *table)
+{
+    if (!table)return;
+    free(table->slots);
+    free(table);
+}
+
+GFC_ConcurrentHashMap *gfc_hashmap_concurrent_new()
+{
+    GFC_ConcurrentHashMap *map;
+    map = gfc_allocate_array(sizeof(GFC_ConcurrentHashMap),1);
+    if (!map)return NULL;
+    map->seed = 5381;
+    map->lock = SDL_CreateMutex();
+    map->retired = gfc_list_new();
+    map->keyChunks = gfc_list_new();
+    map->table = gfc_concurrent_table_new(GFC_CONCURRENT_MIN_SIZE);
+    if ((!map->lock)||(!map->retired)||(!map->keyChunks)||(!map->table))
+    {
+        slog("failed to create concurrent hashmap");
+        gfc_hashmap_concurrent_free(map);
+        return NULL;
+    }
+    return map;
+}
+
+void gfc_hashmap_concurrent_free(GFC_ConcurrentHashMap *map)
+{
+    if (!map)return;
+    gfc_concurrent_table_free(map->table);
+    if (map->retired)
+    {
+        gfc_list_foreach(map->retired,(gfc_work_func*)gfc_concurrent_table_free);
+        gfc_list_delete(map->retired);
+    }
+    if (map->keyChunks)
+    {
+        gfc_list_foreach(map->keyChunks,free);
+        gfc_list_delete(map->keyChunks);
+    }
+    if (map->lock)SDL_DestroyMutex(map->lock);
+    free(map);
+}
+
+/**
+ * @brief copy a key into chunk storage.  Chunks are never reallocated so published keys stay put
+ * @note must hold the write lock
+ */
+static void *gfc_hashmap_concurrent_key_add(GFC_ConcurrentHashMap *map,const char *key,Uint32 length)
+{
+    Uint32 entrySize,chunkSize;
+    char *chunk;
+    entrySize = (sizeof(Uint32) + length + 1 + 3) & ~3;
+    if (map->chunkUsed + entrySize > map->chunkSize)
+    {
+        chunkSize = MAX(GFC_CONCURRENT_KEY_CHUNK,entrySize);
+        chunk = gfc_allocate_array(sizeof(char),chunkSize);
+        if (!chunk)return NULL;
+        gfc_list_append(map->keyChunks,chunk);
+        map->chunkSize = chunkSize;
+        map->chunkUsed = 0;
+    }
+    chunk = (char *)gfc_list_get_nth(map->keyChunks,gfc_list_get_count(map->keyChunks) - 1);
+    chunk += map->chunkUsed;
+    memcpy(chunk,&length,sizeof(Uint32));
+    memcpy(chunk + sizeof(Uint32),key,length);
+    chunk[sizeof(Uint32) + length] = '\0';
+    map->chunkUsed += entrySize;
+    return chunk;
+}
+
+/**
+ * @brief probe for the key in the table
+ * @return the matching slot or NULL if the probe ran into an empty slot
+ */
+static GFC_ConcurrentSlot *gfc_concurrent_table_find(GFC_ConcurrentTable *table,const char *key,Uint32 length,Uint32 h)
+{
+    Uint32 i,n;
+    Uint32 mask = table->size - 1;
+    void *entry;
+    GFC_ConcurrentSlot *slot;
+    i = h & mask;
+    for (n = 0;n < table->size;n++)
+    {
+        slot = &table->slots[i];
+        entry = SDL_AtomicGetPtr(&slot->key);//acquire: the hash and value written before the key are visible
+        if (!entry)return NULL;
+        if ((slot->hash == h)
+            &&(gfc_concurrent_key_length(entry) == length)
+            &&(memcmp(gfc_concurrent_key_text(entry),key,length) == 0))
+        {
+            return slot;
+        }
+        i = (i + 1) & mask;
+    }
+    return NULL;
+}
+
+static void gfc_hashmap_concurrent_reclaim_locked(GFC_ConcurrentHashMap *map)
+{
+    if (!gfc_list_get_count(map->retired))return;
+    // readers count themselves in before they load the table pointer, and the table was swapped
+    // before we got here, so zero readers means nobody can still be walking a retired table
+    if (SDL_AtomicGet(&map->readers) != 0)return;
+    gfc_list_foreach(map->retired,(gfc_work_func*)gfc_concurrent_table_free);
+    gfc_list_clear(map->retired);
+}
+
+/**
+ * @brief build a bigger table with only the live keys and publish it
+ * @note must hold the write lock
+ */
+static GFC_ConcurrentTable *gfc_hashmap_concurrent_grow(GFC_ConcurrentHashMap *map,GFC_ConcurrentTable *old)
+{
+    Uint32 i,j,size,mask;
+    void *value;
+    GFC_ConcurrentTable *table;
+    //size for twice the live keys, so the new table starts at most 3/8ths full.  Tombstones are dropped
+    for (size = GFC_CONCURRENT_MIN_SIZE;gfc_concurrent_over_load(map->count * 2 + 1,size);size *= 2);
+    table = gfc_concurrent_table_new(size);
+    if (!table)return NULL;
+    mask = table->size - 1;
+    for (i = 0; i < old->size;i++)
+    {
+        value = old->slots[i].value;
+        if ((!old->slots[i].key)||(!value))continue;
+        for (j = old->slots[i].hash & mask;table->slots[j].key;j = (j + 1) & mask);
+        table->slots[j] = old->slots[i];
+        table->used++;
+    }
+    //nobody can see the new table yet, so plain stores were fine above.  Now publish it
+    SDL_AtomicSetPtr(&map->table,table);
+    gfc_list_append(map->retired,old);
+    gfc_hashmap_concurrent_reclaim_locked(map);
+    return table;
+}
+
+void gfc_hashmap_concurrent_insert(GFC_ConcurrentHashMap *map,const char *key,void *data)
+{
+    Uint32 i,mask,length,h;
+    void *entry;
+    GFC_ConcurrentTable *table;
+    GFC_ConcurrentSlot *slot;
+    if (!map)return;
+    if (!key)
+    {
+        slog("cannot insert into hashmap, no key provided");
+        return;
+    }
+    if (!data)
+    {
+        gfc_hashmap_concurrent_delete_by_key(map,key);
+        return;
+    }
+    length = strlen(key);
+    h = gfc_hashmap_concurrent_hash(map,key,length);
+    SDL_LockMutex(map->lock);
+    table = map->table;
+    slot = gfc_concurrent_table_find(table,key,length,h);
+    if (slot)
+    {
+        if (!slot->value)map->count++;//reviving a tombstone
+        SDL_AtomicSetPtr(&slot->value,data);
+        SDL_UnlockMutex(map->lock);
+        return;
+    }
+    if (gfc_concurrent_over_load(table->used + 1,table->size))
+    {
+        table = gfc_hashmap_concurrent_grow(map,table);
+        if (!table)
+        {
+            slog("failed to grow concurrent hashmap");
+            SDL_UnlockMutex(map->lock);
+            return;
+        }
+    }
+    entry = gfc_hashmap_concurrent_key_add(map,key,length);
+    if (!entry)
+    {
+        SDL_UnlockMutex(map->lock);
+        return;
+    }
+    mask = table->size - 1;
+    for (i = h & mask;table->slots[i].key;i = (i + 1) & mask);
+    slot = &table->slots[i];
+    slot->hash = h;
+    SDL_AtomicSetPtr(&slot->value,data);
+    SDL_AtomicSetPtr(&slot->key,entry);//release: the slot is now visible to readers
+    table->used++;
+    map->count++;
+    SDL_UnlockMutex(map->lock);
+}
+
+void *gfc_hashmap_concurrent_get(GFC_ConcurrentHashMap *map,const char *key)
+{
+    Uint32 length;
+    void *value = NULL;
+    GFC_ConcurrentTable *table;
+    GFC_ConcurrentSlot *slot;
+    if ((!map)||(!key))return NULL;
+    length = strlen(key);
+    SDL_AtomicIncRef(&map->readers);
+    table = SDL_AtomicGetPtr(&map->table);
+    slot = gfc_concurrent_table_find(table,key,length,gfc_hashmap_concurrent_hash(map,key,length));
+    if (slot)value = SDL_AtomicGetPtr(&slot->value);
+    SDL_AtomicAdd(&map->readers,-1);
+    return value;
+}
+
+void gfc_hashmap_concurrent_delete_by_key(GFC_ConcurrentHashMap *map,const char *key)
+{
+    Uint32 length;
+    GFC_ConcurrentSlot *slot;
+    if ((!map)||(!key))return;
+    length = strlen(key);
+    SDL_LockMutex(map->lock);
+    slot = gfc_concurrent_table_find(map->table,key,length,gfc_hashmap_concurrent_hash(map,key,length));
+    if ((slot)&&(slot->value))
+    {
+        SDL_AtomicSetPtr(&slot->value,NULL);//leave the key as a tombstone so probes keep walking past it
+        map->count--;
+    }
+    SDL_UnlockMutex(map->lock);
+}
+
+Uint32 gfc_hashmap_concurrent_get_count(GFC_ConcurrentHashMap *map)
+{
+    if (!map)return 0;
+    return map->count;
+}
+
+void gfc_hashmap_concurrent_foreach_context(GFC_ConcurrentHashMap *map, gfc_work_func_context func,void *context)
+{
+    Uint32 i;
+    void *value;
+    GFC_ConcurrentTable *table;
+    if ((!map)||(!func))return;
+    SDL_AtomicIncRef(&map->readers);
+    table = SDL_AtomicGetPtr(&map->table);
+    for (i = 0; i < table->size;i++)
+    {
+        if (!SDL_AtomicGetPtr(&table->slots[i].key))continue;
+        value = SDL_AtomicGetPtr(&table->slots[i].value);
+        if (!value)continue;
+        func(value,context);
+    }
+    SDL_AtomicAdd(&map->readers,-1);
+}
+
+void gfc_hashmap_concurrent_reclaim(GFC_ConcurrentHashMap *map)
+{
+    if (!map)return;
+    SDL_LockMutex(map->lock);
+    gfc_hashmap_concurrent_reclaim_locked(map);
+    SDL_UnlockMutex(map->lock);
+}
+
+/*eol@eof*/
@@ -477,6 +477,7 @@ void gfc_input_command_add_controller_input(const char *commandName,const char *
         if (!command)return;
         command->trigger = GFC_ITT_Any;//default
         gfc_line_cpy(command->name,commandName);
+        command->atom = gfc_intern(commandName);
     }
     button = gfc_controller_get_button_conf(con->map,inputName);
     if (button)
@@ -556,6 +557,7 @@ void gfc_input_command_add_key(const char *commandName,const char *key)
         if (!command)return;
         command->trigger = GFC_ITT_Any;//default
         gfc_line_cpy(command->name,commandName);
+        command->atom = gfc_intern(commandName);
     }
     input = gfc_input_new();
     if (!input)return;
@@ -940,21 +942,46 @@ void gfc_command_update(GFC_Command *command)
     }
 }
 
+GFC_Command *gfc_command_get_by_atom(GFC_Atom atom)
+{
+    Uint32 c,i;
+    GFC_Command *in;
+    if (atom == GFC_ATOM_NONE)return NULL;
+    c = gfc_list_get_count(gfc_input_manager.commandList);
+    for (i = 0;i < c;i++)
+    {
+        in = gfc_list_get_nth(gfc_input_manager.commandList,i);
+        if (!in)continue;
+        if (in->atom == atom)
+        {
+            return in;
+        }
+    }
+    return NULL;
+}
+
 GFC_Command *gfc_command_get_by_name(const char *name)
 {
     Uint32 c,i;
+    GFC_Atom atom;
     GFC_Command *in;
     if (!name)
     {
         return NULL;
     }
+    atom = gfc_intern_find(name);
     c = gfc_list_get_count(gfc_input_manager.commandList);
     for (i = 0;i < c;i++)
     {
         in = gfc_list_get_nth(gfc_input_manager.commandList,i);
         if (!in)continue;
-        if (gfc_line_cmp(in->name,name)==0)
+        if (in->atom != GFC_ATOM_NONE)
+        {
+            if (in->atom == atom)return in;
+        }
+        else if (gfc_strlcmp(in->name,name) == 0)
         {
+            //name was set by hand, never interned
             return in;
         }
     }
@@ -1728,6 +1755,7 @@ GFC_Command *gfc_input_parse_command_json(SJson *command)
     in = gfc_command_new();
     if (!in)return NULL;
     gfc_line_cpy(in->name,buffer);
+    in->atom = gfc_intern(buffer);
     buffer = sj_object_get_string(command,"trigger");
     if (buffer)
     {
@@ -0,0 +1,166 @@
+#include <ctype.h>
+
+#include "simple_logger.h"
+
+#include "gfc_text.h"
+#include "gfc_list.h"
+#include "gfc_hashmap_concurrent.h"
+#include "gfc_intern.h"
+
+typedef struct
+{
+    GFC_ConcurrentHashMap  *atoms;  /**<text to atom, read without locking*/
+    GFC_List               *text;   /**<atom - 1 to text*/
+    SDL_mutex              *lock;   /**<held while adding strings or reading text*/
+    SDL_atomic_t            ready;  /**<set once everything above exists*/
+}GFC_InternTable;
+
+static GFC_InternTable intern_table = {0};
+static SDL_SpinLock intern_init_lock = 0;//needs no setup, so two threads interning first can not both build the table
+
+void gfc_intern_close()
+{
+    SDL_AtomicSet(&intern_table.ready,0);
+    if (intern_table.text)
+    {
+        gfc_list_foreach(intern_table.text,free);
+        gfc_list_delete(intern_table.text);
+    }
+    gfc_hashmap_concurrent_free(intern_table.atoms);
+    if (intern_table.lock)SDL_DestroyMutex(intern_table.lock);
+    memset(&intern_table,0,sizeof(GFC_InternTable));
+}
+
+static int gfc_intern_init()
+{
+    int ready;
+    if (SDL_AtomicGet(&intern_table.ready))return 1;
+    SDL_AtomicLock(&intern_init_lock);
+    if (!SDL_AtomicGet(&intern_table.ready))
+    {
+        intern_table.atoms = gfc_hashmap_concurrent_new();
+        intern_table.text = gfc_list_new();
+        intern_table.lock = SDL_CreateMutex();
+        if ((!intern_table.atoms)||(!intern_table.text)||(!intern_table.lock))
+        {
+            slog("failed to create the intern table");
+            gfc_intern_close();
+        }
+        else
+        {
+            atexit(gfc_intern_close);
+            SDL_AtomicSet(&intern_table.ready,1);//publishes the fields above to the lock free readers
+        }
+    }
+    ready = SDL_AtomicGet(&intern_table.ready);
+    SDL_AtomicUnlock(&intern_init_lock);
+    return ready;
+}
+
+GFC_Atom gfc_intern_find(const char *text)
+{
+    if ((!text)||(!SDL_AtomicGet(&intern_table.ready)))return GFC_ATOM_NONE;
+    return (GFC_Atom)(size_t)gfc_hashmap_concurrent_get(intern_table.atoms,text);
+}
+
+GFC_Atom gfc_intern(const char *text)
+{
+    GFC_Atom atom;
+    size_t length;
+    char *copy;
+    if (!text)return GFC_ATOM_NONE;
+    atom = gfc_intern_find(text);
+    if (atom)return atom;
+    if (!gfc_intern_init())return GFC_ATOM_NONE;
+    SDL_LockMutex(intern_table.lock);
+    //another thread may have added it since we looked
+    atom = (GFC_Atom)(size_t)gfc_hashmap_concurrent_get(intern_table.atoms,text);
+    if (!atom)
+    {
+        length = strlen(text);
+        copy = malloc(length + 1);
+        if (!copy)
+        {
+            slog("failed to allocate memory to intern '%s'",text);
+            SDL_UnlockMutex(intern_table.lock);
+            return GFC_ATOM_NONE;
+        }
+        memcpy(copy,text,length + 1);
+        gfc_list_append(intern_table.text,copy);
+        atom = gfc_list_get_count(intern_table.text);
+        //the text is in place before the atom can be found
+        gfc_hashmap_concurrent_insert(intern_table.atoms,copy,(void *)(size_t)atom);
+    }
+    SDL_UnlockMutex(intern_table.lock);
+    return atom;
+}
+
+/**
+ * @brief lower case text into buffer if it fits, or into a new allocation if it does not
+ * @return the folded text, which must be freed if it is not buffer
+ */
+static char *gfc_intern_fold(const char *text,char *buffer,size_t bufferSize)
+{
+    size_t i,length;
+    char *folded = buffer;
+    length = strlen(text);
+    if (length >= bufferSize)
+    {
+        folded = malloc(length + 1);
+        if (!folded)return NULL;
+    }
+    for (i = 0;i <= length;i++)
+    {
+        folded[i] = tolower((unsigned char)text[i]);
+    }
+    return folded;
+}
+
+GFC_Atom gfc_intern_nocase(const char *text)
+{
+    GFC_Atom atom;
+    GFC_TextLine buffer;
+    char *folded;
+    if (!text)return GFC_ATOM_NONE;
+    folded = gfc_intern_fold(text,buffer,sizeof(buffer));
+    if (!folded)return GFC_ATOM_NONE;
+    atom = gfc_intern(folded);
+    if (folded != buffer)free(folded);
+    return atom;
+}
+
+GFC_Atom gfc_intern_find_nocase(const char *text)
+{
+    GFC_Atom atom;
+    GFC_TextLine buffer;
+    char *folded;
+    if ((!text)||(!SDL_AtomicGet(&intern_table.ready)))return GFC_ATOM_NONE;
+    folded = gfc_intern_fold(text,buffer,sizeof(buffer));
+    if (!folded)return GFC_ATOM_NONE;
+    atom = gfc_intern_find(folded);
+    if (folded != buffer)free(folded);
+    return atom;
+}
+
+const char *gfc_intern_text(GFC_Atom atom)
+{
+    const char *text;
+    if ((atom == GFC_ATOM_NONE)||(!SDL_AtomicGet(&intern_table.ready)))return NULL;
+    //the list can be reallocated by an insert on another thread, the strings themselves never move
+    SDL_LockMutex(intern_table.lock);
+    text = gfc_list_get_nth(intern_table.text,atom - 1);
+    SDL_UnlockMutex(intern_table.lock);
+    return text;
+}
+
+Uint32 gfc_intern_get_count()
+{
+    Uint32 count;
+    if (!SDL_AtomicGet(&intern_table.ready))return 0;
+    SDL_LockMutex(intern_table.lock);
+    count = gfc_list_get_count(intern_table.text);
+    SDL_UnlockMutex(intern_table.lock);
+    return count;
+}
+
+/*eol@eof*/
@@ -0,0 +1,316 @@
+#include "simple_logger.h"
+#include "gfc_intmap.h"
+
+#define GFC_INTMAP_MIN_SIZE 8
+// same load limit as GFC_HashMap
+#define gfc_intmap_over_load(count,size) ((count) * 8 > (size) * 7)
+
+/**
+ * @brief fibonacci hashing: one multiply spreads the key, the top bits are the best mixed
+ */
+static Uint32 gfc_intmap_hash(Uint64 key)
+{
+    Uint32 h;
+    h = (Uint32)((key * 0x9E3779B97F4A7C15ULL) >> 32);
+    if (!h)h = 1;//zero is reserved to mark empty slots
+    return h;
+}
+
+static Uint32 gfc_intmap_probe_distance(GFC_IntMap *map,Uint32 hashValue,Uint32 index)
+{
+    return (index - (hashValue >> map->shift)) & (map->size - 1);
+}
+
+static void gfc_intmap_place(GFC_IntMap *map,Uint32 hashValue,Uint64 key,void *value)
+{
+    Uint32 i,dist,otherDist;
+    Uint32 otherHash;
+    Uint64 otherKey;
+    void *otherValue;
+    Uint32 mask = map->size - 1;
+    i = hashValue >> map->shift;
+    dist = 0;
+    for (;;)
+    {
+        if (!map->hashes[i])
+        {
+            map->hashes[i] = hashValue;
+            map->keys[i] = key;
+            map->values[i] = value;
+            return;
+        }
+        otherDist = gfc_intmap_probe_distance(map,map->hashes[i],i);
+        if (otherDist < dist)
+        {
+            //the resident is closer to home than we are, take its slot and keep placing it instead
+            otherHash = map->hashes[i];
+            otherKey = map->keys[i];
+            otherValue = map->values[i];
+            map->hashes[i] = hashValue;
+            map->keys[i] = key;
+            map->values[i] = value;
+            hashValue = otherHash;
+            key = otherKey;
+            value = otherValue;
+            dist = otherDist;
+        }
+        i = (i + 1) & mask;
+        dist++;
+    }
+}
+
+void gfc_intmap_resize(GFC_IntMap *map,Uint32 size)
+{
+    Uint32 i,oldSize,shift;
+    Uint32 *oldHashes,*hashes;
+    Uint64 *oldKeys,*keys;
+    void **oldValues,**values;
+    if (!map)return;
+    for (shift = 32;(1U << (32 - shift)) < size;shift--);
+    hashes = gfc_allocate_array(sizeof(Uint32),size);
+    keys = gfc_allocate_array(sizeof(Uint64),size);
+    values = gfc_allocate_array(sizeof(void *),size);
+    if ((!hashes)||(!keys)||(!values))
+    {
+        slog("failed to resize intmap");
+        free(hashes);
+        free(keys);
+        free(values);
+        return;
+    }
+    oldHashes = map->hashes;
+    oldKeys = map->keys;
+    oldValues = map->values;
+    oldSize = map->size;
+    map->hashes = hashes;
+    map->keys = keys;
+    map->values = values;
+    map->size = size;
+    map->shift = shift;
+    if (!oldHashes)return;
+    for (i = 0; i < oldSize;i++)
+    {
+        if (!oldHashes[i])continue;
+        gfc_intmap_place(map,oldHashes[i],oldKeys[i],oldValues[i]);
+    }
+    free(oldHashes);
+    free(oldKeys);
+    free(oldValues);
+}
+
+GFC_IntMap *gfc_intmap_new_size(Uint32 count)
+{
+    Uint32 slots;
+    GFC_IntMap *map;
+    map = (GFC_IntMap *)gfc_allocate_array(sizeof(GFC_IntMap),1);
+    if (!map)return NULL;
+    for (slots = GFC_INTMAP_MIN_SIZE;gfc_intmap_over_load(count,slots);slots *= 2);
+    gfc_intmap_resize(map,slots);
+    if (!map->hashes)
+    {
+        free(map);
+        return NULL;
+    }
+    return map;
+}
+
+GFC_IntMap *gfc_intmap_new()
+{
+    return gfc_intmap_new_size(0);
+}
+
+void gfc_intmap_free(GFC_IntMap *map)
+{
+    if (!map)return;
+    free(map->hashes);
+    free(map->keys);
+    free(map->values);
+    free(map);
+}
+
+Sint64 gfc_intmap_find(GFC_IntMap *map,Uint64 key)
+{
+    Uint32 i,dist,h;
+    Uint32 mask;
+    if ((!map)||(!map->hashes))return -1;
+    mask = map->size - 1;
+    h = gfc_intmap_hash(key);
+    i = h >> map->shift;
+    for (dist = 0;dist < map->size;dist++)
+    {
+        if (!map->hashes[i])return -1;
+        if (gfc_intmap_probe_distance(map,map->hashes[i],i) < dist)return -1;
+        if (map->keys[i] == key)return i;
+        i = (i + 1) & mask;
+    }
+    return -1;
+}
+
+void gfc_intmap_insert(GFC_IntMap *map,Uint64 key,void *data)
+{
+    Sint64 index;
+    if ((!map)||(!map->hashes))return;
+    index = gfc_intmap_find(map,key);
+    if (index >= 0)
+    {
+        map->values[index] = data;
+        return;
+    }
+    if (gfc_intmap_over_load(map->count + 1,map->size))
+    {
+        gfc_intmap_resize(map,map->size * 2);
+    }
+    gfc_intmap_place(map,gfc_intmap_hash(key),key,data);
+    map->count++;
+}
+
+void *gfc_intmap_get(GFC_IntMap *map,Uint64 key)
+{
+    Sint64 index;
+    index = gfc_intmap_find(map,key);
+    if (index < 0)return NULL;
+    return map->values[index];
+}
+
+int gfc_intmap_has_key(GFC_IntMap *map,Uint64 key)
+{
+    return gfc_intmap_find(map,key) >= 0;
+}
+
+Uint32 gfc_intmap_get_count(GFC_IntMap *map)
+{
+    if (!map)return 0;
+    return map->count;
+}
+
+void gfc_intmap_delete_index(GFC_IntMap *map,Uint32 index)
+{
+    Uint32 i,next,mask;
+    map->hashes[index] = 0;
+    map->values[index] = NULL;
+    map->count--;
+    //backward shift: pull the rest of the cluster back one slot so no tombstone is needed
+    mask = map->size - 1;
+    i = index;
+    next = (i + 1) & mask;
+    for (;;)
+    {
+        if (!map->hashes[next])return;
+        if (gfc_intmap_probe_distance(map,map->hashes[next],next) == 0)return;
+        map->hashes[i] = map->hashes[next];
+        map->keys[i] = map->keys[next];
+        map->values[i] = map->values[next];
+        map->hashes[next] = 0;
+        map->values[next] = NULL;
+        i = next;
+        next = (next + 1) & mask;
+    }
+}
+
+void gfc_intmap_delete_by_key(GFC_IntMap *map,Uint64 key)
+{
+    Sint64 index;
+    index = gfc_intmap_find(map,key);
+    if (index < 0)return;
+    gfc_intmap_delete_index(map,(Uint32)index);
+}
+
+void gfc_intmap_iter_begin(GFC_IntMap *map,GFC_IntMapIter *iter)
+{
+    Uint32 i;
+    if (!iter)return;
+    memset(iter,0,sizeof(GFC_IntMapIter));
+    if ((!map)||(!map->hashes)||(!map->count))return;
+    for (i = 0; i < map->size;i++)
+    {
+        if (!map->hashes[i])break;
+    }
+    iter->map = map;
+    iter->start = i;
+}
+
+static int gfc_intmap_iter_set(GFC_IntMapIter *iter,Uint32 index)
+{
+    iter->valid = 1;
+    iter->key = iter->map->keys[index];
+    iter->value = iter->map->values[index];
+    return 1;
+}
+
+int gfc_intmap_iter_next(GFC_IntMapIter *iter)
+{
+    Uint32 i,mask;
+    GFC_IntMap *map;
+    if ((!iter)||(!iter->map))return 0;
+    map = iter->map;
+    mask = map->size - 1;
+    if (iter->valid)
+    {
+        i = (iter->start + iter->step) & mask;
+        if ((map->hashes[i])&&(map->keys[i] != iter->key))
+        {
+            //the current element was deleted and the next one in its cluster shifted into its slot
+            return gfc_intmap_iter_set(iter,i);
+        }
+    }
+    while (iter->step + 1 < map->size)
+    {
+        iter->step++;
+        i = (iter->start + iter->step) & mask;
+        if (map->hashes[i])return gfc_intmap_iter_set(iter,i);
+    }
+    iter->valid = 0;
+    iter->value = NULL;
+    iter->map = NULL;
+    return 0;
+}
+
+void gfc_intmap_iter_delete(GFC_IntMapIter *iter)
+{
+    Uint32 i;
+    if ((!iter)||(!iter->map)||(!iter->valid))return;
+    i = (iter->start + iter->step) & (iter->map->size - 1);
+    if ((!iter->map->hashes[i])||(iter->map->keys[i] != iter->key))return;//already gone
+    gfc_intmap_delete_index(iter->map,i);
+}
+
+GFC_List *gfc_intmap_get_all_values(GFC_IntMap *map)
+{
+    GFC_IntMapIter it;
+    GFC_List *valueList = NULL;
+    if ((!map) || (!map->hashes))return NULL;
+    valueList = gfc_list_new_size(MAX(map->count,1));
+    if (!valueList)return NULL;
+    gfc_intmap_iter_begin(map,&it);
+    while (gfc_intmap_iter_next(&it))
+    {
+        gfc_list_append(valueList,it.value);
+    }
+    return valueList;
+}
+
+void gfc_intmap_foreach(GFC_IntMap *map, gfc_work_func func)
+{
+    GFC_IntMapIter it;
+    if ((!map)||(!func))return;
+    gfc_intmap_iter_begin(map,&it);
+    while (gfc_intmap_iter_next(&it))
+    {
+        if (!it.value)continue;
+        func(it.value);
+    }
+}
+
+void gfc_intmap_foreach_context(GFC_IntMap *map, gfc_work_func_context func,void *context)
+{
+    GFC_IntMapIter it;
+    if ((!map)||(!func))return;
+    gfc_intmap_iter_begin(map,&it);
+    while (gfc_intmap_iter_next(&it))
+    {
+        if (!it.value)continue;
+        func(it.value,context);
+    }
+}
+
+/*eol@eof*/
@@ -2,13 +2,16 @@
 
 #include "gfc_types.h"
 #include "gfc_list.h"
+#include "gfc_thread_pool.h"
+
+#define GFC_LIST_DEFAULT_GROWTH 2.0f
 
 void gfc_list_delete(GFC_List *list)
 {
     if (!list)return;
     if (list->elements)
     {
-        free(list->elements);
+        free(list->elements - list->head);//free from the start of the allocation
     }
     free(list);
 }
@@ -25,6 +28,8 @@ GFC_List *gfc_list_copy(GFC_List *old)
     if (old->size <= 0)return NULL;
     new = gfc_list_new_size(old->size);
     if (!new)return NULL;
+    new->growth = old->growth;
+    new->deque = old->deque;
     if (old->count <= 0)return new;
     memcpy(new->elements,old->elements,sizeof(GFC_ListElementData)*old->count);
     new->count = old->count;
@@ -104,29 +109,122 @@ void *gfc_list_get_nth(GFC_List *list,Uint32 n)
     return list->elements[n].data;
 }
 
+/**
+ * @brief move the list into a new allocation with room for head elements in front and size from the first element on
+ */
+int gfc_list_resize(GFC_List *list,Uint32 head,Uint32 size)
+{
+    GFC_ListElementData *elements;
+    if (size < list->count)size = list->count;
+    if ((!head)&&(!list->head)&&(list->elements))
+    {
+        //nothing has to move, let the allocator grow or shrink the block in place if it can
+        elements = realloc(list->elements,sizeof(GFC_ListElementData)*size);
+        if (!elements)
+        {
+            slog("failed to allocate space for list elements");
+            return 0;
+        }
+        if (size > list->size)
+        {
+            memset(&elements[list->size],0,sizeof(GFC_ListElementData)*(size - list->size));
+        }
+        list->elements = elements;
+        list->size = size;
+        return 1;
+    }
+    elements = gfc_allocate_array(sizeof(GFC_ListElementData),head + size);
+    if (!elements)
+    {
+        slog("failed to allocate space for list elements");
+        return 0;
+    }
+    if (list->count > 0)
+    {
+        memcpy(&elements[head],list->elements,sizeof(GFC_ListElementData)*list->count);
+    }
+    if (list->elements)free(list->elements - list->head);
+    list->elements = &elements[head];
+    list->head = head;
+    list->size = size;
+    return 1;
+}
+
+/**
+ * @brief the total number of elements the list should hold after its next growth
+ */
+static Uint32 gfc_list_grown_size(GFC_List *list)
+{
+    Uint32 total,grown;
+    total = list->head + list->size;
+    if (!total)total = 8;
+    grown = (Uint32)(total * (list->growth > 1.0f ? list->growth : GFC_LIST_DEFAULT_GROWTH));
+    if (grown <= total)grown = total + 1;
+    return grown;
+}
+
 int gfc_list_expand(GFC_List *list)
 {
-    GFC_List *l;
+    Uint32 total,head;
     if (!list)
     {
         slog("no list provided");
         return 0;
     }
-    if (!list->size)list->size = 8;
-    l = gfc_list_new_size(list->size * 2);
-    if (!l)
+    if ((list->head)&&(list->head >= list->count))
     {
-        return 0;
+        //lots of space was freed at the front (used as a queue), slide back instead of growing
+        memmove(list->elements - list->head,list->elements,sizeof(GFC_ListElementData)*list->count);
+        list->elements -= list->head;
+        list->size += list->head;
+        list->head = 0;
+        memset(&list->elements[list->count],0,sizeof(GFC_ListElementData)*(list->size - list->count));
+        return 1;
     }
-    if (list->count > 0)
+    total = gfc_list_grown_size(list);
+    head = list->deque ? (total - list->count) / 4 : 0;//in deque mode keep some room at both ends
+    return gfc_list_resize(list,head,total - head);
+}
+
+/**
+ * @brief make room for one more element in front of the first one
+ */
+static int gfc_list_expand_front(GFC_List *list)
+{
+    Uint32 total,head;
+    total = gfc_list_grown_size(list);
+    head = (total - list->count) / 2;//split the new space between both ends
+    return gfc_list_resize(list,head,total - head);
+}
+
+int gfc_list_reserve(GFC_List *list,Uint32 count)
+{
+    if (!list)
     {
-        memcpy(l->elements,list->elements,sizeof(GFC_ListElementData)*list->count);
+        slog("no list provided");
+        return 0;
     }
-    list->size = l->size;// update the new size
-    free(list->elements);//free the old data
-    list->elements = l->elements;//point to new memory address
-    free(l);//free the temp list
-    return 1;
+    if (count <= list->size)return 1;
+    return gfc_list_resize(list,list->head,count);
+}
+
+void gfc_list_set_growth(GFC_List *list,float growth)
+{
+    if (!list)return;
+    list->growth = growth;
+}
+
+void gfc_list_set_deque(GFC_List *list,Uint8 deque)
+{
+    if (!list)return;
+    list->deque = deque;
+}
+
+void gfc_list_shrink_to_fit(GFC_List *list)
+{
+    if (!list)return;
+    if ((!list->head)&&(list->size == MAX(list->count,1)))return;
+    gfc_list_resize(list,0,MAX(list->count,1));
 }
 
 
@@ -152,20 +250,25 @@ void gfc_list_append(GFC_List *list,void *data)
 
 GFC_List *gfc_list_concat(GFC_List *a,GFC_List *b)
 {
-    int i,count;
-    void *data;
+    Uint32 count;
     if ((!a) || (!b))
     {
         slog("missing list data");
         return NULL;
     }
-    count = gfc_list_get_count(b);
-    for (i = 0; i < count;i++)
+    count = b->count;
+    if (!count)return a;
+    if (a->count + count > a->size)
     {
-        data = gfc_list_get_nth(b,i);
-        gfc_list_append(a,data);
-        if (a == NULL)return NULL;
+        //grow once, but not less than a normal expansion so repeated concats stay amortized
+        if (!gfc_list_reserve(a,MAX(a->count + count,gfc_list_grown_size(a) - a->head)))
+        {
+            slog("concat failed due to lack of memory");
+            return NULL;
+        }
     }
+    memcpy(&a->elements[a->count],b->elements,sizeof(GFC_ListElementData)*count);
+    a->count += count;
     return a;
 }
 
@@ -179,6 +282,29 @@ GFC_List *gfc_list_concat_free(GFC_List *a,GFC_List *b)
 
 void gfc_list_prepend(GFC_List *list,void *data)
 {
+    if (!list)
+    {
+        slog("no list provided");
+        return;
+    }
+    if ((!list->head)&&(list->deque))
+    {
+        if (!gfc_list_expand_front(list))
+        {
+            slog("prepend failed due to lack of memory");
+            return;
+        }
+    }
+    if (list->head)
+    {
+        //room in front, just step the start of the list back one
+        list->elements--;
+        list->head--;
+        list->size++;
+        list->elements[0].data = data;
+        list->count++;
+        return;
+    }
     gfc_list_insert(list,data,0);
 }
 
@@ -189,11 +315,16 @@ void gfc_list_insert(GFC_List *list,void *data,Uint32 n)
         slog("no list provided");
         return;
     }
-    if (n > list->size + 1)
+    if (n > list->count)
     {
         slog("attempting to insert element beyond length of list");
         return;
     }
+    if ((n == 0)&&((list->head)||(list->deque)))
+    {
+        gfc_list_prepend(list,data);
+        return;
+    }
     if (list->count >= list->size)
     {
         gfc_list_expand(list);
@@ -211,6 +342,16 @@ int gfc_list_delete_first(GFC_List *list)
     return gfc_list_delete_nth(list,0);
 }
 
+void *gfc_list_pop_first(GFC_List *list)
+{
+    void *data;
+    if (!list)return NULL;
+    if (!list->count)return NULL;
+    data = list->elements[0].data;
+    gfc_list_delete_nth(list,0);
+    return data;
+}
+
 int gfc_list_delete_last(GFC_List *list)
 {
     if (!list)
@@ -265,13 +406,16 @@ int gfc_list_delete_data(GFC_List *list,void *data)
 void gfc_list_clear(GFC_List *list)
 {
     if (!list)return;
-    memset(list->elements,0,list->size);//zero out all the data;
+    //reclaim any room left at the front
+    list->elements -= list->head;
+    list->size += list->head;
+    list->head = 0;
+    memset(list->elements,0,sizeof(GFC_ListElementData)*list->size);//zero out all the data;
     list->count = 0;
 }
 
 int gfc_list_delete_nth(GFC_List *list,Uint32 n)
 {
-    int i;
     if (!list)
     {
         slog("no list provided");
@@ -288,103 +432,274 @@ int gfc_list_delete_nth(GFC_List *list,Uint32 n)
         list->elements[n].data = NULL;
         return 0;
     }
-    for (i = n; i < (list->count - 1);i++)
+    if (n < list->count / 2)
     {
-        list->elements[i].data = list->elements[i+1].data;
+        //closer to the front: shift the front half up one and start the list one later
+        memmove(&list->elements[1],&list->elements[0],sizeof(GFC_ListElementData)*n);
+        list->elements[0].data = NULL;
+        list->elements++;
+        list->head++;
+        list->size--;
+        list->count--;
+        return 0;
     }
-    if (i+1 < list->count)list->elements[i+1].data = NULL;
+    memmove(&list->elements[n],&list->elements[n+1],sizeof(GFC_ListElementData)*(list->count - n - 1));
     list->count--;
+    list->elements[list->count].data = NULL;
     return 0;
 }
 
+int gfc_list_delete_nth_unordered(GFC_List *list,Uint32 n)
+{
+    if (!list)
+    {
+        slog("no list provided");
+        return -1;
+    }
+    if (n >= list->count)
+    {
+        slog("attempting to delete beyond the length of the list");
+        return -1;
+    }
+    list->count--;
+    list->elements[n].data = list->elements[list->count].data;
+    list->elements[list->count].data = NULL;
+    return 0;
+}
+
+int gfc_list_delete_data_unordered(GFC_List *list,void *data)
+{
+    int i;
+    if (!list)
+    {
+        slog("no list provided");
+        return -1;
+    }
+    if (!data)return 0;
+    for (i = 0; i < list->count;i++)
+    {
+        if (list->elements[i].data == data)
+        {
+            return gfc_list_delete_nth_unordered(list,i);
+        }
+    }
+    return -1;
+}
+
+Uint32 gfc_list_remove_if(GFC_List *list,gfc_predicate_func *predicate,void *context)
+{
+    Uint32 i,kept = 0,removed;
+    if ((!list)||(!predicate))return 0;
+    for (i = 0; i < list->count;i++)
+    {
+        if (predicate(list->elements[i].data,context))continue;
+        list->elements[kept++].data = list->elements[i].data;
+    }
+    removed = list->count - kept;
+    if (removed)
+    {
+        memset(&list->elements[kept],0,sizeof(GFC_ListElementData)*removed);
+    }
+    list->count = kept;
+    return removed;
+}
+
 Uint32 gfc_list_get_count(GFC_List *list)
 {
     if (!list)return 0;
     return list->count;
 }
 
-void gfc_list_split(GFC_List *base,GFC_List **leftOut,GFC_List **rightOut)
+#define GFC_LIST_SORT_SMALL 16
+
+typedef struct
+{
+    gfc_compare_func *compare;
+}GFC_ListCompareAdapter;
+
+static int gfc_list_compare_adapter(void *a,void *b,void *context)
+{
+    return ((GFC_ListCompareAdapter *)context)->compare(a,b);
+}
+
+static void gfc_list_insertion_sort(GFC_ListElementData *e,Uint32 n,gfc_compare_func_context *compare,void *context)
+{
+    Uint32 i,j;
+    void *item;
+    for (i = 1; i < n;i++)
+    {
+        item = e[i].data;
+        for (j = i;(j > 0)&&(compare(e[j - 1].data,item,context) > 0);j--)
+        {
+            e[j].data = e[j - 1].data;
+        }
+        e[j].data = item;
+    }
+}
+
+static void gfc_list_sift_down(GFC_ListElementData *e,Uint32 root,Uint32 n,gfc_compare_func_context *compare,void *context)
+{
+    Uint32 child;
+    void *item = e[root].data;
+    while ((child = root * 2 + 1) < n)
+    {
+        if ((child + 1 < n)&&(compare(e[child].data,e[child + 1].data,context) < 0))child++;
+        if (compare(item,e[child].data,context) >= 0)break;
+        e[root].data = e[child].data;
+        root = child;
+    }
+    e[root].data = item;
+}
+
+static void gfc_list_heap_sort(GFC_ListElementData *e,Uint32 n,gfc_compare_func_context *compare,void *context)
 {
-    Uint32 halfway;
     Uint32 i;
-    GFC_List *left,*right;
-    if ((!base)||(!leftOut)||(!rightOut))return;
-    if (base->count < 2)return;//nothing to do
-    halfway = base->count / 2;
-    left = gfc_list_new_size(halfway + 1);//pad for an extra
-    right = gfc_list_new_size(halfway + 1);//pad for an extra
-    for (i =0; i < halfway;i++)
+    void *item;
+    for (i = n / 2; i > 0;i--)
     {
-        gfc_list_append(left,gfc_list_get_nth(base,i));
+        gfc_list_sift_down(e,i - 1,n,compare,context);
     }
-    for (;i < base->count;i++)
+    for (i = n - 1; i > 0;i--)
     {
-        gfc_list_append(right,gfc_list_get_nth(base,i));
+        item = e[0].data;
+        e[0].data = e[i].data;
+        e[i].data = item;
+        gfc_list_sift_down(e,0,i,compare,context);
     }
-    *leftOut = left;
-    *rightOut = right;
 }
 
-//plan: merge sort.  First split the list into two smaller lists, and then recursively have each one sort
-void gfc_list_sort(GFC_List *list,int (*compare)(void *a,void *b))
+//plan: introsort.  Quicksort with a median of three pivot, falling back to heap sort if the recursion gets
+//too deep (so the worst case stays n log n) and finishing small partitions with insertion sort.
+static void gfc_list_introsort(GFC_ListElementData *e,Uint32 n,Uint32 depth,gfc_compare_func_context *compare,void *context)
 {
-    int l,r;
-    void *leftItem,*rightItem;
-    GFC_List *left,*right;
-    if ((!list)||(!compare))return;//no list or no compare function, so stop
-    if (list->count <= 1)return;//not enough to sort
-    //now split it
-    gfc_list_split(list,&left,&right);
-    if ((left == NULL)||(right == NULL))
-    {
-        return;//nothing left to do
-    }
-    //sort each half
-    gfc_list_sort(left,compare);
-    gfc_list_sort(right,compare);
-    //now merge the halves
-    //for each element in each list (until one of them 
-    l = 0;
-    r = 0;
-    //clear the original list
-    gfc_list_clear(list);
-    //using the count getter in case either list is NULL
-    while((l < gfc_list_get_count(left))&&(r < gfc_list_get_count(right)))
-    {
-        leftItem = gfc_list_get_nth(left,l);
-        rightItem = gfc_list_get_nth(right,r);
-        if ((!leftItem)||(!rightItem))break;//nothing left to compare;
-        if (compare(leftItem,rightItem) <= 0)
+    Uint32 i,j,mid;
+    void *pivot,*temp;
+    while (n > GFC_LIST_SORT_SMALL)
+    {
+        if (!depth)
+        {
+            gfc_list_heap_sort(e,n,compare,context);
+            return;
+        }
+        depth--;
+        //order first, middle and last, then use the middle as the pivot
+        mid = n / 2;
+        if (compare(e[mid].data,e[0].data,context) < 0)
+        {
+            temp = e[mid].data;e[mid].data = e[0].data;e[0].data = temp;
+        }
+        if (compare(e[n - 1].data,e[mid].data,context) < 0)
         {
-            gfc_list_append(list,leftItem);
-            l++;//advance our trek through the left list
+            temp = e[mid].data;e[mid].data = e[n - 1].data;e[n - 1].data = temp;
+            if (compare(e[mid].data,e[0].data,context) < 0)
+            {
+                temp = e[mid].data;e[mid].data = e[0].data;e[0].data = temp;
+            }
+        }
+        pivot = e[mid].data;
+        //hoare partition, the ordered ends act as sentinels
+        i = 0;
+        j = n - 1;
+        for (;;)
+        {
+            while (compare(e[i].data,pivot,context) < 0)i++;
+            while (compare(pivot,e[j].data,context) < 0)j--;
+            if (i >= j)break;
+            temp = e[i].data;e[i].data = e[j].data;e[j].data = temp;
+            i++;
+            j--;
+        }
+        //recurse into the smaller side, loop on the larger so the stack stays log n
+        if (j + 1 < n - j - 1)
+        {
+            gfc_list_introsort(e,j + 1,depth,compare,context);
+            e += j + 1;
+            n -= j + 1;
         }
         else
         {
-            gfc_list_append(list,rightItem);
-            r++;//advance our trek through the right list
+            gfc_list_introsort(&e[j + 1],n - j - 1,depth,compare,context);
+            n = j + 1;
         }
     }
-    if (l < gfc_list_get_count(left))
+    gfc_list_insertion_sort(e,n,compare,context);
+}
+
+void gfc_list_sort_context(GFC_List *list,gfc_compare_func_context *compare,void *context)
+{
+    Uint32 n,depth = 0;
+    if ((!list)||(!compare))return;//no list or no compare function, so stop
+    if (list->count <= 1)return;//not enough to sort
+    for (n = list->count;n > 1;n >>= 1)depth += 2;//2 * log2(n)
+    gfc_list_introsort(list->elements,list->count,depth,compare,context);
+}
+
+void gfc_list_sort(GFC_List *list,int (*compare)(void *a,void *b))
+{
+    GFC_ListCompareAdapter adapter;
+    if (!compare)return;
+    adapter.compare = compare;
+    gfc_list_sort_context(list,gfc_list_compare_adapter,&adapter);
+}
+
+//plan: bottom up merge sort.  Insertion sort small runs in place, then merge runs of doubling width back
+//and forth between the list and one scratch buffer.  Every step keeps equal items in their original order.
+void gfc_list_sort_stable_context(GFC_List *list,gfc_compare_func_context *compare,void *context)
+{
+    Uint32 n,i,width,mid,end,l,r,k;
+    GFC_ListElementData *src,*dst,*temp,*scratch;
+    if ((!list)||(!compare))return;
+    n = list->count;
+    if (n <= 1)return;
+    for (i = 0; i < n;i += GFC_LIST_SORT_SMALL)
+    {
+        gfc_list_insertion_sort(&list->elements[i],MIN(GFC_LIST_SORT_SMALL,n - i),compare,context);
+    }
+    if (n <= GFC_LIST_SORT_SMALL)return;
+    scratch = malloc(sizeof(GFC_ListElementData) * n);
+    if (!scratch)
     {
-        //finish with the remaining left
-        for (;l < gfc_list_get_count(left);l++)
-        {
-            gfc_list_append(list,gfc_list_get_nth(left,l));
-        }
+        slog("not enough memory for a stable merge, falling back to insertion sort");
+        gfc_list_insertion_sort(list->elements,n,compare,context);
+        return;
     }
-    else if (r < gfc_list_get_count(right))//these should be mutually exclusive and no more than 1 item
+    src = list->elements;
+    dst = scratch;
+    for (width = GFC_LIST_SORT_SMALL;width < n;width *= 2)
     {
-        //finish with the remaining right
-        for (;r < gfc_list_get_count(right);r++)
+        for (i = 0; i < n;i += width * 2)
         {
-            gfc_list_append(list,gfc_list_get_nth(right,r));
+            mid = MIN(i + width,n);
+            end = MIN(i + width * 2,n);
+            l = i;
+            r = mid;
+            k = i;
+            while ((l < mid)&&(r < end))
+            {
+                //take from the left on ties, that is what keeps it stable
+                if (compare(src[r].data,src[l].data,context) < 0)dst[k++] = src[r++];
+                else dst[k++] = src[l++];
+            }
+            while (l < mid)dst[k++] = src[l++];
+            while (r < end)dst[k++] = src[r++];
         }
+        temp = src;
+        src = dst;
+        dst = temp;
     }
-    //at this point the main list should be sorted in place
-    //cleanup
-    gfc_list_delete(left);
-    gfc_list_delete(right);
+    if (src != list->elements)
+    {
+        memcpy(list->elements,src,sizeof(GFC_ListElementData) * n);
+    }
+    free(scratch);
+}
+
+void gfc_list_sort_stable(GFC_List *list,int (*compare)(void *a,void *b))
+{
+    GFC_ListCompareAdapter adapter;
+    if (!compare)return;
+    adapter.compare = compare;
+    gfc_list_sort_stable_context(list,gfc_list_compare_adapter,&adapter);
 }
 
 void gfc_list_foreach(GFC_List *list,void (*function)(void *data))
@@ -422,4 +737,40 @@ void gfc_list_foreach_context(GFC_List *list,void (*function)(void *data,void *c
     }
 }
 
+typedef struct
+{
+    GFC_List *list;
+    gfc_work_func_context *function;
+    void *contextData;
+}GFC_ListParallelJob;
+
+static void gfc_list_foreach_parallel_range(Uint32 start,Uint32 end,void *context)
+{
+    Uint32 i;
+    GFC_ListParallelJob *job = context;
+    for (i = start;i < end;i++)
+    {
+        job->function(job->list->elements[i].data,job->contextData);
+    }
+}
+
+void gfc_list_foreach_parallel(GFC_List *list,gfc_work_func_context *function,void *contextData,Uint32 grainSize)
+{
+    GFC_ListParallelJob job;
+    if (!list)
+    {
+        slog("no list provided");
+        return;
+    }
+    if (!function)
+    {
+        slog("no function provided");
+        return;
+    }
+    job.list = list;
+    job.function = function;
+    job.contextData = contextData;
+    gfc_thread_pool_parallel_for(list->count,grainSize,gfc_list_foreach_parallel_range,&job);
+}
+
 /*eol@eof*/
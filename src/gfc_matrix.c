@@ -3,6 +3,8 @@
 #include <math.h>
 
 #include "gfc_matrix.h"
+#include "gfc_quaternion.h"
+#include "gfc_simd.h"
 #include "simple_logger.h"
 
 /*
@@ -11,8 +13,8 @@
 GFC_Vector3D gfc_unproject(GFC_Vector3D in,GFC_Matrix4 view, GFC_Matrix4 proj,GFC_Vector2D viewport)
 {
     GFC_Vector3D out = {0,0,0};
-    GFC_Matrix4 InvProj = {0},InvView = {0};
-    GFC_Vector4D tmp,obj,eye;
+    GFC_Matrix4 viewProj,inverse;
+    GFC_Vector4D tmp,obj;
     
     if ((!viewport.x)||(!viewport.y))
     {
@@ -20,23 +22,23 @@ GFC_Vector3D gfc_unproject(GFC_Vector3D in,GFC_Matrix4 view, GFC_Matrix4 proj,GF
         return out;
     }
     
-    gfc_matrix4_invert(InvProj,proj);
-    gfc_matrix4_invert(InvView,view);
+    //InvProj * (InvView * v) is the same as (view * proj)^-1 * v, which needs only one inversion
+    gfc_matrix4_multiply(viewProj,view,proj);
+    if (!gfc_matrix4_invert(inverse,viewProj))
+    {
+        slog("cannot unproject with a singular view or projection matrix");
+        return out;
+    }
     
     tmp.x =(2.0f*((in.x)/viewport.x))-1.0f,
     tmp.y =(2.0f*((in.y)/viewport.y))-1.0f,
     tmp.z = (in.z * 2) -1;
     tmp.w = 1;
         
-    gfc_matrix4_multiply_v(
-        &eye,
-        InvView,
-        tmp);
-
     gfc_matrix4_multiply_v(
         &obj,
-        InvProj,
-        eye);
+        inverse,
+        tmp);
     
     
     if (!obj.w)
@@ -114,11 +116,9 @@ void gfc_matrix4_from_vectors(
     GFC_Vector3D rotation,
     GFC_Vector3D scale)
 {
-    gfc_matrix4_identity(out);
-    
-    gfc_matrix4_scale(out,out,scale);
-    gfc_matrix4_rotate_by_vector(out,out,rotation);
-    gfc_matrix4_translate(out,out,translation);
+    //the euler rotation as a quaternion gives the same matrix as gfc_matrix4_rotate_by_vector,
+    //without the three 4x4 multiplies
+    gfc_matrix4_from_vectors_q(out,translation,gfc_quaternion_from_euler(rotation),scale);
 }
 
 void gfc_matrix4_to_matrix16(float m16[16],GFC_Matrix4 m4)
@@ -165,127 +165,54 @@ void gfc_matrix16_to_matrix4(GFC_Matrix4 m4,float m16[16])
 Uint8 gfc_matrix16_invert(float m[16], float invOut[16])
 {
     float inv[16], det;
+    float s0,s1,s2,s3,s4,s5;
+    float c0,c1,c2,c3,c4,c5;
     int i;
-    
-    inv[0] = m[5]  * m[10] * m[15] - 
-             m[5]  * m[11] * m[14] - 
-             m[9]  * m[6]  * m[15] + 
-             m[9]  * m[7]  * m[14] +
-             m[13] * m[6]  * m[11] - 
-             m[13] * m[7]  * m[10];
-
-    inv[4] = -m[4]  * m[10] * m[15] + 
-              m[4]  * m[11] * m[14] + 
-              m[8]  * m[6]  * m[15] - 
-              m[8]  * m[7]  * m[14] - 
-              m[12] * m[6]  * m[11] + 
-              m[12] * m[7]  * m[10];
-
-    inv[8] = m[4]  * m[9] * m[15] - 
-             m[4]  * m[11] * m[13] - 
-             m[8]  * m[5] * m[15] + 
-             m[8]  * m[7] * m[13] + 
-             m[12] * m[5] * m[11] - 
-             m[12] * m[7] * m[9];
-
-    inv[12] = -m[4]  * m[9] * m[14] + 
-               m[4]  * m[10] * m[13] +
-               m[8]  * m[5] * m[14] - 
-               m[8]  * m[6] * m[13] - 
-               m[12] * m[5] * m[10] + 
-               m[12] * m[6] * m[9];
-
-    inv[1] = -m[1]  * m[10] * m[15] + 
-              m[1]  * m[11] * m[14] + 
-              m[9]  * m[2] * m[15] - 
-              m[9]  * m[3] * m[14] - 
-              m[13] * m[2] * m[11] + 
-              m[13] * m[3] * m[10];
-
-    inv[5] = m[0]  * m[10] * m[15] - 
-             m[0]  * m[11] * m[14] - 
-             m[8]  * m[2] * m[15] + 
-             m[8]  * m[3] * m[14] + 
-             m[12] * m[2] * m[11] - 
-             m[12] * m[3] * m[10];
-
-    inv[9] = -m[0]  * m[9] * m[15] + 
-              m[0]  * m[11] * m[13] + 
-              m[8]  * m[1] * m[15] - 
-              m[8]  * m[3] * m[13] - 
-              m[12] * m[1] * m[11] + 
-              m[12] * m[3] * m[9];
-
-    inv[13] = m[0]  * m[9] * m[14] - 
-              m[0]  * m[10] * m[13] - 
-              m[8]  * m[1] * m[14] + 
-              m[8]  * m[2] * m[13] + 
-              m[12] * m[1] * m[10] - 
-              m[12] * m[2] * m[9];
-
-    inv[2] = m[1]  * m[6] * m[15] - 
-             m[1]  * m[7] * m[14] - 
-             m[5]  * m[2] * m[15] + 
-             m[5]  * m[3] * m[14] + 
-             m[13] * m[2] * m[7] - 
-             m[13] * m[3] * m[6];
-
-    inv[6] = -m[0]  * m[6] * m[15] + 
-              m[0]  * m[7] * m[14] + 
-              m[4]  * m[2] * m[15] - 
-              m[4]  * m[3] * m[14] - 
-              m[12] * m[2] * m[7] + 
-              m[12] * m[3] * m[6];
-
-    inv[10] = m[0]  * m[5] * m[15] - 
-              m[0]  * m[7] * m[13] - 
-              m[4]  * m[1] * m[15] + 
-              m[4]  * m[3] * m[13] + 
-              m[12] * m[1] * m[7] - 
-              m[12] * m[3] * m[5];
-
-    inv[14] = -m[0]  * m[5] * m[14] + 
-               m[0]  * m[6] * m[13] + 
-               m[4]  * m[1] * m[14] - 
-               m[4]  * m[2] * m[13] - 
-               m[12] * m[1] * m[6] + 
-               m[12] * m[2] * m[5];
-
-    inv[3] = -m[1] * m[6] * m[11] + 
-              m[1] * m[7] * m[10] + 
-              m[5] * m[2] * m[11] - 
-              m[5] * m[3] * m[10] - 
-              m[9] * m[2] * m[7] + 
-              m[9] * m[3] * m[6];
-
-    inv[7] = m[0] * m[6] * m[11] - 
-             m[0] * m[7] * m[10] - 
-             m[4] * m[2] * m[11] + 
-             m[4] * m[3] * m[10] + 
-             m[8] * m[2] * m[7] - 
-             m[8] * m[3] * m[6];
-
-    inv[11] = -m[0] * m[5] * m[11] + 
-               m[0] * m[7] * m[9] + 
-               m[4] * m[1] * m[11] - 
-               m[4] * m[3] * m[9] - 
-               m[8] * m[1] * m[7] + 
-               m[8] * m[3] * m[5];
-
-    inv[15] = m[0] * m[5] * m[10] - 
-              m[0] * m[6] * m[9] - 
-              m[4] * m[1] * m[10] + 
-              m[4] * m[2] * m[9] + 
-              m[8] * m[1] * m[6] - 
-              m[8] * m[2] * m[5];
-
-    det = m[0] * inv[0] + m[1] * inv[4] + m[2] * inv[8] + m[3] * inv[12];
+
+    //expand along the 2x2 sub determinants of the top and bottom row pairs,
+    //each is shared by several cofactors so it is only computed once
+    s0 = m[0] * m[5] - m[4] * m[1];
+    s1 = m[0] * m[6] - m[4] * m[2];
+    s2 = m[0] * m[7] - m[4] * m[3];
+    s3 = m[1] * m[6] - m[5] * m[2];
+    s4 = m[1] * m[7] - m[5] * m[3];
+    s5 = m[2] * m[7] - m[6] * m[3];
+
+    c5 = m[10] * m[15] - m[14] * m[11];
+    c4 = m[9]  * m[15] - m[13] * m[11];
+    c3 = m[9]  * m[14] - m[13] * m[10];
+    c2 = m[8]  * m[15] - m[12] * m[11];
+    c1 = m[8]  * m[14] - m[12] * m[10];
+    c0 = m[8]  * m[13] - m[12] * m[9];
+
+    det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
 
     if (det == 0)
         return false;
 
-    det = 1.0 / det;
+    inv[0]  =  m[5]  * c5 - m[6]  * c4 + m[7]  * c3;
+    inv[1]  = -m[1]  * c5 + m[2]  * c4 - m[3]  * c3;
+    inv[2]  =  m[13] * s5 - m[14] * s4 + m[15] * s3;
+    inv[3]  = -m[9]  * s5 + m[10] * s4 - m[11] * s3;
+
+    inv[4]  = -m[4]  * c5 + m[6]  * c2 - m[7]  * c1;
+    inv[5]  =  m[0]  * c5 - m[2]  * c2 + m[3]  * c1;
+    inv[6]  = -m[12] * s5 + m[14] * s2 - m[15] * s1;
+    inv[7]  =  m[8]  * s5 - m[10] * s2 + m[11] * s1;
+
+    inv[8]  =  m[4]  * c4 - m[5]  * c2 + m[7]  * c0;
+    inv[9]  = -m[0]  * c4 + m[1]  * c2 - m[3]  * c0;
+    inv[10] =  m[12] * s4 - m[13] * s2 + m[15] * s0;
+    inv[11] = -m[8]  * s4 + m[9]  * s2 - m[11] * s0;
+
+    inv[12] = -m[4]  * c3 + m[5]  * c1 - m[6]  * c0;
+    inv[13] =  m[0]  * c3 - m[1]  * c1 + m[2]  * c0;
+    inv[14] = -m[12] * s3 + m[13] * s1 - m[14] * s0;
+    inv[15] =  m[8]  * s3 - m[9]  * s1 + m[10] * s0;
 
+    det = 1.0f / det;
+
+    //all of m has been read, so invOut may be m
     for (i = 0; i < 16; i++)
         invOut[i] = inv[i] * det;
     return true;
@@ -293,14 +220,63 @@ Uint8 gfc_matrix16_invert(float m[16], float invOut[16])
 
 Uint8 gfc_matrix4_invert(GFC_Matrix4 mOut, GFC_Matrix4 mIn)
 {
-    float m[16];
-    gfc_matrix4_to_matrix16(m,mIn);
-    
-    if (!gfc_matrix16_invert(m,m))return 0;
-    gfc_matrix16_to_matrix4(mOut,m);
+    //a GFC_Matrix4 is 16 contiguous floats in the same order as a matrix16, so no conversion is needed
+    return gfc_matrix16_invert(&mIn[0][0],&mOut[0][0]);
+}
+
+Uint8 gfc_matrix4_invert_affine(GFC_Matrix4 out, GFC_Matrix4 in)
+{
+    float a00 = in[0][0],a01 = in[0][1],a02 = in[0][2];
+    float a10 = in[1][0],a11 = in[1][1],a12 = in[1][2];
+    float a20 = in[2][0],a21 = in[2][1],a22 = in[2][2];
+    float tx = in[3][0],ty = in[3][1],tz = in[3][2];
+    float b00,b01,b02,b10,b11,b12,b20,b21,b22;
+    float det;
+
+    b00 = a11 * a22 - a12 * a21;
+    b10 = a12 * a20 - a10 * a22;
+    b20 = a10 * a21 - a11 * a20;
+    det = a00 * b00 + a01 * b10 + a02 * b20;
+    if (det == 0)return 0;
+    det = 1.0f / det;
+    b00 *= det;
+    b10 *= det;
+    b20 *= det;
+    b01 = (a02 * a21 - a01 * a22) * det;
+    b11 = (a00 * a22 - a02 * a20) * det;
+    b21 = (a01 * a20 - a00 * a21) * det;
+    b02 = (a01 * a12 - a02 * a11) * det;
+    b12 = (a02 * a10 - a00 * a12) * det;
+    b22 = (a00 * a11 - a01 * a10) * det;
+
+    out[0][0] = b00; out[0][1] = b01; out[0][2] = b02; out[0][3] = 0;
+    out[1][0] = b10; out[1][1] = b11; out[1][2] = b12; out[1][3] = 0;
+    out[2][0] = b20; out[2][1] = b21; out[2][2] = b22; out[2][3] = 0;
+    //the translation is undone by moving back through the inverted rotation and scale
+    out[3][0] = -(tx * b00 + ty * b10 + tz * b20);
+    out[3][1] = -(tx * b01 + ty * b11 + tz * b21);
+    out[3][2] = -(tx * b02 + ty * b12 + tz * b22);
+    out[3][3] = 1;
     return 1;
 }
 
+void gfc_matrix4_invert_rigid(GFC_Matrix4 out, GFC_Matrix4 in)
+{
+    float a00 = in[0][0],a01 = in[0][1],a02 = in[0][2];
+    float a10 = in[1][0],a11 = in[1][1],a12 = in[1][2];
+    float a20 = in[2][0],a21 = in[2][1],a22 = in[2][2];
+    float tx = in[3][0],ty = in[3][1],tz = in[3][2];
+
+    //the inverse of a pure rotation is its transpose
+    out[0][0] = a00; out[0][1] = a10; out[0][2] = a20; out[0][3] = 0;
+    out[1][0] = a01; out[1][1] = a11; out[1][2] = a21; out[1][3] = 0;
+    out[2][0] = a02; out[2][1] = a12; out[2][2] = a22; out[2][3] = 0;
+    out[3][0] = -(tx * a00 + ty * a01 + tz * a02);
+    out[3][1] = -(tx * a10 + ty * a11 + tz * a12);
+    out[3][2] = -(tx * a20 + ty * a21 + tz * a22);
+    out[3][3] = 1;
+}
+
 
 void gfc_matrix2_copy(GFC_Matrix2 d,GFC_Matrix2 s)
 {
@@ -326,6 +302,14 @@ void gfc_matrix4_copy(GFC_Matrix4 d,GFC_Matrix4 s)
 
 void gfc_matrix4_multiply_scalar(GFC_Matrix4 out,GFC_Matrix4 m1,float s)
 {
+#if GFC_SIMD_ENABLED
+    int i;
+    GFC_Simd4f scale = gfc_simd_set1(s);
+    for (i = 0; i < 4; i++)
+    {
+        gfc_simd_store(out[i],gfc_simd_mul(gfc_simd_load(m1[i]),scale));
+    }
+#else
     GFC_Matrix4 temp;
     temp[0][0] = s*m1[0][0];
     temp[0][1] = s*m1[0][1];
@@ -347,6 +331,7 @@ void gfc_matrix4_multiply_scalar(GFC_Matrix4 out,GFC_Matrix4 m1,float s)
     temp[3][2] = s*m1[3][2];
     temp[3][3] = s*m1[3][3];
     gfc_matrix4_copy(out,temp);
+#endif
 }
 
 void gfc_matrix3_multiply_scalar(GFC_Matrix3 out,GFC_Matrix3 m1,float s)
@@ -377,32 +362,112 @@ void gfc_matrix2_multiply_scalar(GFC_Matrix2 out,GFC_Matrix2 m1,float s)
     gfc_matrix2_copy(out,temp);
 }
 
+#if !GFC_SIMD_ENABLED
+/**
+ * @brief out = row * m, row is read in full before out is written so they may be the same
+ */
+static void gfc_matrix4_row_multiply(float out[4],const float row[4],GFC_Matrix4 m)
+{
+    float x = row[0],y = row[1],z = row[2],w = row[3];
+    out[0] = x * m[0][0] + y * m[1][0] + z * m[2][0] + w * m[3][0];
+    out[1] = x * m[0][1] + y * m[1][1] + z * m[2][1] + w * m[3][1];
+    out[2] = x * m[0][2] + y * m[1][2] + z * m[2][2] + w * m[3][2];
+    out[3] = x * m[0][3] + y * m[1][3] + z * m[2][3] + w * m[3][3];
+}
+#endif
+
 void gfc_matrix4_multiply(
     GFC_Matrix4 out,
     GFC_Matrix4 m2,
     GFC_Matrix4 m1)
 {
-    GFC_Matrix4 out1;//just in case its the same matrix
-    out1[0][0] = m2[0][0]*m1[0][0] + m2[0][1]*m1[1][0] + m2[0][2]*m1[2][0] + m2[0][3]*m1[3][0];
-    out1[0][1] = m2[0][0]*m1[0][1] + m2[0][1]*m1[1][1] + m2[0][2]*m1[2][1] + m2[0][3]*m1[3][1];
-    out1[0][2] = m2[0][0]*m1[0][2] + m2[0][1]*m1[1][2] + m2[0][2]*m1[2][2] + m2[0][3]*m1[3][2];
-    out1[0][3] = m2[0][0]*m1[0][3] + m2[0][1]*m1[1][3] + m2[0][2]*m1[2][3] + m2[0][3]*m1[3][3];
+#if GFC_SIMD_ENABLED
+    int i;
+    GFC_Simd4f r0,r1,r2,r3,row,res[4];
+    r0 = gfc_simd_load(m1[0]);
+    r1 = gfc_simd_load(m1[1]);
+    r2 = gfc_simd_load(m1[2]);
+    r3 = gfc_simd_load(m1[3]);
+    //each output row is the rows of m1 weighted by the matching row of m2
+    for (i = 0; i < 4; i++)
+    {
+        row = gfc_simd_load(m2[i]);
+        res[i] = gfc_simd_mul(gfc_simd_splat(row,0),r0);
+        res[i] = gfc_simd_madd(gfc_simd_splat(row,1),r1,res[i]);
+        res[i] = gfc_simd_madd(gfc_simd_splat(row,2),r2,res[i]);
+        res[i] = gfc_simd_madd(gfc_simd_splat(row,3),r3,res[i]);
+    }
+    //all of m1 and m2 has been read, so out may be either of them
+    for (i = 0; i < 4; i++)
+    {
+        gfc_simd_store(out[i],res[i]);
+    }
+#else
+    int i;
+    GFC_Matrix4 temp;
+    if (out == m1)
+    {
+        //every output row needs all of m1, so it cannot be overwritten as we go
+        gfc_matrix4_copy(temp,m1);
+        m1 = temp;
+    }
+    //output row i only needs row i of m2, so out may be m2
+    for (i = 0; i < 4; i++)
+    {
+        gfc_matrix4_row_multiply(out[i],m2[i],m1);
+    }
+#endif
+}
 
-    out1[1][0] = m2[1][0]*m1[0][0] + m2[1][1]*m1[1][0] + m2[1][2]*m1[2][0] + m2[1][3]*m1[3][0];
-    out1[1][1] = m2[1][0]*m1[0][1] + m2[1][1]*m1[1][1] + m2[1][2]*m1[2][1] + m2[1][3]*m1[3][1];
-    out1[1][2] = m2[1][0]*m1[0][2] + m2[1][1]*m1[1][2] + m2[1][2]*m1[2][2] + m2[1][3]*m1[3][2];
-    out1[1][3] = m2[1][0]*m1[0][3] + m2[1][1]*m1[1][3] + m2[1][2]*m1[2][3] + m2[1][3]*m1[3][3];
-        
-    out1[2][0] = m2[2][0]*m1[0][0] + m2[2][1]*m1[1][0] + m2[2][2]*m1[2][0] + m2[2][3]*m1[3][0];
-    out1[2][1] = m2[2][0]*m1[0][1] + m2[2][1]*m1[1][1] + m2[2][2]*m1[2][1] + m2[2][3]*m1[3][1];
-    out1[2][2] = m2[2][0]*m1[0][2] + m2[2][1]*m1[1][2] + m2[2][2]*m1[2][2] + m2[2][3]*m1[3][2];
-    out1[2][3] = m2[2][0]*m1[0][3] + m2[2][1]*m1[1][3] + m2[2][2]*m1[2][3] + m2[2][3]*m1[3][3];
-        
-    out1[3][0] = m2[3][0]*m1[0][0] + m2[3][1]*m1[1][0] + m2[3][2]*m1[2][0] + m2[3][3]*m1[3][0];
-    out1[3][1] = m2[3][0]*m1[0][1] + m2[3][1]*m1[1][1] + m2[3][2]*m1[2][1] + m2[3][3]*m1[3][1];
-    out1[3][2] = m2[3][0]*m1[0][2] + m2[3][1]*m1[1][2] + m2[3][2]*m1[2][2] + m2[3][3]*m1[3][2];
-    out1[3][3] = m2[3][0]*m1[0][3] + m2[3][1]*m1[1][3] + m2[3][2]*m1[2][3] + m2[3][3]*m1[3][3];
-    gfc_matrix4_copy(out,out1);
+void gfc_matrix4_multiply_chain(GFC_Matrix4 out,GFC_Matrix4 **matrices,Uint32 count)
+{
+    Uint32 k;
+    int i;
+#if GFC_SIMD_ENABLED
+    GFC_Simd4f acc[4],b0,b1,b2,b3;
+#else
+    GFC_Matrix4 acc;
+#endif
+    if ((!out)||(!matrices)||(!count))
+    {
+        if (out)gfc_matrix4_identity(out);
+        return;
+    }
+    //the running product stays in registers (or one local), a row at a time, so nothing is copied between steps
+#if GFC_SIMD_ENABLED
+    for (i = 0; i < 4; i++)
+    {
+        acc[i] = gfc_simd_load((*matrices[0])[i]);
+    }
+    for (k = 1; k < count; k++)
+    {
+        b0 = gfc_simd_load((*matrices[k])[0]);
+        b1 = gfc_simd_load((*matrices[k])[1]);
+        b2 = gfc_simd_load((*matrices[k])[2]);
+        b3 = gfc_simd_load((*matrices[k])[3]);
+        for (i = 0; i < 4; i++)
+        {
+            acc[i] = gfc_simd_madd(gfc_simd_splat(acc[i],3),b3,
+                     gfc_simd_madd(gfc_simd_splat(acc[i],2),b2,
+                     gfc_simd_madd(gfc_simd_splat(acc[i],1),b1,
+                     gfc_simd_mul(gfc_simd_splat(acc[i],0),b0))));
+        }
+    }
+    for (i = 0; i < 4; i++)
+    {
+        gfc_simd_store(out[i],acc[i]);
+    }
+#else
+    memcpy(acc,*matrices[0],sizeof(GFC_Matrix4));
+    for (k = 1; k < count; k++)
+    {
+        for (i = 0; i < 4; i++)
+        {
+            gfc_matrix4_row_multiply(acc[i],acc[i],*matrices[k]);
+        }
+    }
+    memcpy(out,acc,sizeof(GFC_Matrix4));
+#endif
 }
 
 void gfc_matrix3_multiply(
@@ -442,6 +507,16 @@ void gfc_matrix2_multiply(
 
 void gfc_matrix4_v_multiply(GFC_Vector4D *out,GFC_Vector4D vec,GFC_Matrix4 mat)
 {
+#if GFC_SIMD_ENABLED
+  GFC_Simd4f v,res;
+  if (!out)return;
+  v = gfc_simd_load(&vec.x);
+  res = gfc_simd_mul(gfc_simd_splat(v,0),gfc_simd_load(mat[0]));
+  res = gfc_simd_madd(gfc_simd_splat(v,1),gfc_simd_load(mat[1]),res);
+  res = gfc_simd_madd(gfc_simd_splat(v,2),gfc_simd_load(mat[2]),res);
+  res = gfc_simd_madd(gfc_simd_splat(v,3),gfc_simd_load(mat[3]),res);
+  gfc_simd_store(&out->x,res);
+#else
   float ox,oy,oz,ow;
   if (!out)return;
   ox=vec.x*mat[0][0] + vec.y*mat[1][0] + mat[2][0]*vec.z + mat[3][0]*vec.w;
@@ -452,6 +527,7 @@ void gfc_matrix4_v_multiply(GFC_Vector4D *out,GFC_Vector4D vec,GFC_Matrix4 mat)
   out->y = oy;
   out->z = oz;
   out->w = ow;
+#endif
 }
 
 void gfc_matrix3_v_multiply(GFC_Vector3D *out,GFC_Vector3D vec,GFC_Matrix3 mat)
@@ -479,6 +555,18 @@ void gfc_matrix2_v_multiply(GFC_Vector2D *out,GFC_Vector2D vec,GFC_Matrix2 mat)
 
 void gfc_matrix4_multiply_v(GFC_Vector4D * out,GFC_Matrix4 mat,GFC_Vector4D vec)
 {
+#if GFC_SIMD_ENABLED
+  GFC_Simd4f v,r0,r1,r2,r3;
+  if (!out)return;
+  v = gfc_simd_load(&vec.x);
+  //multiply each row by the vector, then transpose so the four row sums can be added lane by lane
+  r0 = gfc_simd_mul(gfc_simd_load(mat[0]),v);
+  r1 = gfc_simd_mul(gfc_simd_load(mat[1]),v);
+  r2 = gfc_simd_mul(gfc_simd_load(mat[2]),v);
+  r3 = gfc_simd_mul(gfc_simd_load(mat[3]),v);
+  gfc_simd_transpose4(r0,r1,r2,r3);
+  gfc_simd_store(&out->x,gfc_simd_add(gfc_simd_add(r0,r1),gfc_simd_add(r2,r3)));
+#else
   float ox,oy,oz,ow;
   if (!out)return;
   ox=vec.x*mat[0][0] + vec.y*mat[0][1] + mat[0][2]*vec.z + mat[0][3]*vec.w;
@@ -489,6 +577,51 @@ void gfc_matrix4_multiply_v(GFC_Vector4D * out,GFC_Matrix4 mat,GFC_Vector4D vec)
   out->y = oy;
   out->z = oz;
   out->w = ow;
+#endif
+}
+
+#define GFC_MATRIX_BATCH_BLOCK 64
+
+/**
+ * @brief shared body of the batch transforms, w is 1 for points and 0 for directions
+ */
+static void gfc_vector3d_batch_transform_w(GFC_Vector3DBatch out,GFC_Vector3DBatch in,GFC_Matrix4 mat,float w,Uint32 count)
+{
+    Uint32 i,start,n;
+    float *ox,*oy,*oz;
+    float x[GFC_MATRIX_BATCH_BLOCK],y[GFC_MATRIX_BATCH_BLOCK],z[GFC_MATRIX_BATCH_BLOCK];
+    //copy the matrix into locals so the compiler knows writing to out cannot change it
+    float m00 = mat[0][0],m01 = mat[0][1],m02 = mat[0][2];
+    float m10 = mat[1][0],m11 = mat[1][1],m12 = mat[1][2];
+    float m20 = mat[2][0],m21 = mat[2][1],m22 = mat[2][2];
+    float t0 = mat[3][0] * w,t1 = mat[3][1] * w,t2 = mat[3][2] * w;
+    for (start = 0; start < count; start += n)
+    {
+        //stage a block of input so each loop below writes one array and reads only locals, which vectorizes
+        //without overlap checks and keeps in place transforms correct
+        n = MIN(count - start,GFC_MATRIX_BATCH_BLOCK);
+        memcpy(x,&in.x[start],sizeof(float) * n);
+        memcpy(y,&in.y[start],sizeof(float) * n);
+        memcpy(z,&in.z[start],sizeof(float) * n);
+        ox = &out.x[start];
+        oy = &out.y[start];
+        oz = &out.z[start];
+        for (i = 0; i < n; i++)ox[i] = x[i] * m00 + y[i] * m10 + z[i] * m20 + t0;
+        for (i = 0; i < n; i++)oy[i] = x[i] * m01 + y[i] * m11 + z[i] * m21 + t1;
+        for (i = 0; i < n; i++)oz[i] = x[i] * m02 + y[i] * m12 + z[i] * m22 + t2;
+    }
+}
+
+void gfc_vector3d_batch_transform(GFC_Vector3DBatch out,GFC_Vector3DBatch in,GFC_Matrix4 mat,Uint32 count)
+{
+    if (!mat)return;
+    gfc_vector3d_batch_transform_w(out,in,mat,1.0f,count);
+}
+
+void gfc_vector3d_batch_transform_direction(GFC_Vector3DBatch out,GFC_Vector3DBatch in,GFC_Matrix4 mat,Uint32 count)
+{
+    if (!mat)return;
+    gfc_vector3d_batch_transform_w(out,in,mat,0.0f,count);
 }
 
 void gfc_matrix3_multiply_v(GFC_Vector3D * out,GFC_Matrix3 mat,GFC_Vector3D vec)
@@ -758,21 +891,18 @@ void gfc_matrix4_from_vectors_q(
     GFC_Vector3D scale
 )
 {
-    GFC_Matrix4 rotateM;
-        
-    //M = T * R * S
-    
-    gfc_matrix4_identity(out);
-    gfc_matrix4_scale(out,out,scale);
-
-    gfc_matrix4_from_quaternion(rotateM,quaternion);
-    gfc_matrix4_multiply(
-            out,
-            out,
-            rotateM
-        );
-    
-    gfc_matrix4_translate(out,out,translation);
+    int i;
+    //M = S * R * T, built directly: scale each row of the rotation, then put the translation in the bottom row
+    gfc_matrix4_from_quaternion(out,quaternion);
+    for (i = 0; i < 3; i++)
+    {
+        out[0][i] *= scale.x;
+        out[1][i] *= scale.y;
+        out[2][i] *= scale.z;
+    }
+    out[3][0] = translation.x;
+    out[3][1] = translation.y;
+    out[3][2] = translation.z;
 }
 
 void gfc_matrix4_from_quaternion(
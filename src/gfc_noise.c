@@ -1,3 +1,4 @@
+#include "gfc_fast_math.h"
 #include "gfc_noise.h"
 
 float interpolate(float a0, float a1, float w)
@@ -20,7 +21,7 @@ GFC_Vector2D randomGradient(int ix, int iy) {
     a ^= b << s | b >> (w-s);
     a *= 2048419325;
     random = a * (3.14159265 / ~(~0u >> 1)); // in [0, 2*Pi]
-    v.x = cos(random); v.y = sin(random);
+    gfc_math_sincos(random,&v.y,&v.x);
     return v;
 }
 
@@ -0,0 +1,232 @@
+#include <math.h>
+
+#include "simple_logger.h"
+
+#include "gfc_quaternion.h"
+
+#define GFC_QUATERNION_SLERP_THRESHOLD 0.9995f
+
+GFC_Quaternion gfc_quaternion(float x,float y,float z,float w)
+{
+    GFC_Quaternion q;
+    q.x = x;
+    q.y = y;
+    q.z = z;
+    q.w = w;
+    return q;
+}
+
+GFC_Quaternion gfc_quaternion_identity()
+{
+    return gfc_quaternion(0,0,0,1);
+}
+
+GFC_Quaternion gfc_quaternion_from_axis_angle(GFC_Vector3D axis,float radians)
+{
+    float length,s;
+    length = sqrtf(axis.x * axis.x + axis.y * axis.y + axis.z * axis.z);
+    if (length == 0)return gfc_quaternion_identity();
+    s = sinf(radians * 0.5f) / length;
+    return gfc_quaternion(axis.x * s,axis.y * s,axis.z * s,cosf(radians * 0.5f));
+}
+
+void gfc_quaternion_to_axis_angle(GFC_Quaternion q,GFC_Vector3D *axis,float *radians)
+{
+    float s;
+    q = gfc_quaternion_normalize(q);
+    s = sqrtf(q.x * q.x + q.y * q.y + q.z * q.z);
+    if (radians)*radians = 2.0f * atan2f(s,q.w);
+    if (!axis)return;
+    if (s < GFC_EPSILON)
+    {
+        //no rotation, any axis will do
+        *axis = gfc_vector3d(0,0,1);
+        return;
+    }
+    *axis = gfc_vector3d(q.x / s,q.y / s,q.z / s);
+}
+
+GFC_Quaternion gfc_quaternion_from_euler(GFC_Vector3D rotation)
+{
+    //gfc_matrix4_rotate_by_vector turns about x by rotation.y, then about y by rotation.x, then about z by rotation.z
+    GFC_Quaternion qx,qy,qz;
+    qx = gfc_quaternion_from_axis_angle(gfc_vector3d(1,0,0),rotation.y);
+    qy = gfc_quaternion_from_axis_angle(gfc_vector3d(0,1,0),rotation.x);
+    qz = gfc_quaternion_from_axis_angle(gfc_vector3d(0,0,1),rotation.z);
+    return gfc_quaternion_multiply(qz,gfc_quaternion_multiply(qy,qx));
+}
+
+GFC_Quaternion gfc_quaternion_from_matrix4(GFC_Matrix4 mat)
+{
+    float trace,s;
+    GFC_Quaternion q;
+    //matrices here are applied as v * M, so they are the transpose of the textbook form
+    trace = mat[0][0] + mat[1][1] + mat[2][2];
+    if (trace > 0)
+    {
+        s = sqrtf(trace + 1.0f) * 2.0f;
+        q.w = 0.25f * s;
+        q.x = (mat[1][2] - mat[2][1]) / s;
+        q.y = (mat[2][0] - mat[0][2]) / s;
+        q.z = (mat[0][1] - mat[1][0]) / s;
+    }
+    else if ((mat[0][0] > mat[1][1])&&(mat[0][0] > mat[2][2]))
+    {
+        s = sqrtf(1.0f + mat[0][0] - mat[1][1] - mat[2][2]) * 2.0f;
+        q.w = (mat[1][2] - mat[2][1]) / s;
+        q.x = 0.25f * s;
+        q.y = (mat[0][1] + mat[1][0]) / s;
+        q.z = (mat[0][2] + mat[2][0]) / s;
+    }
+    else if (mat[1][1] > mat[2][2])
+    {
+        s = sqrtf(1.0f + mat[1][1] - mat[0][0] - mat[2][2]) * 2.0f;
+        q.w = (mat[2][0] - mat[0][2]) / s;
+        q.x = (mat[0][1] + mat[1][0]) / s;
+        q.y = 0.25f * s;
+        q.z = (mat[1][2] + mat[2][1]) / s;
+    }
+    else
+    {
+        s = sqrtf(1.0f + mat[2][2] - mat[0][0] - mat[1][1]) * 2.0f;
+        q.w = (mat[0][1] - mat[1][0]) / s;
+        q.x = (mat[0][2] + mat[2][0]) / s;
+        q.y = (mat[1][2] + mat[2][1]) / s;
+        q.z = 0.25f * s;
+    }
+    return gfc_quaternion_normalize(q);
+}
+
+void gfc_quaternion_to_matrix4(GFC_Matrix4 out,GFC_Quaternion q)
+{
+    gfc_matrix4_from_quaternion(out,q);
+}
+
+GFC_Quaternion gfc_quaternion_multiply(GFC_Quaternion a,GFC_Quaternion b)
+{
+    GFC_Quaternion q;
+    q.x = a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y;
+    q.y = a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x;
+    q.z = a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w;
+    q.w = a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z;
+    return q;
+}
+
+GFC_Quaternion gfc_quaternion_conjugate(GFC_Quaternion q)
+{
+    return gfc_quaternion(-q.x,-q.y,-q.z,q.w);
+}
+
+float gfc_quaternion_dot(GFC_Quaternion a,GFC_Quaternion b)
+{
+    return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+}
+
+GFC_Quaternion gfc_quaternion_inverse(GFC_Quaternion q)
+{
+    float d;
+    d = gfc_quaternion_dot(q,q);
+    if (d == 0)return gfc_quaternion_identity();
+    d = 1.0f / d;
+    return gfc_quaternion(-q.x * d,-q.y * d,-q.z * d,q.w * d);
+}
+
+GFC_Quaternion gfc_quaternion_normalize(GFC_Quaternion q)
+{
+    float d;
+    d = gfc_quaternion_dot(q,q);
+    if (d == 0)return gfc_quaternion_identity();
+    d = 1.0f / sqrtf(d);
+    return gfc_quaternion(q.x * d,q.y * d,q.z * d,q.w * d);
+}
+
+GFC_Vector3D gfc_quaternion_rotate_vector(GFC_Quaternion q,GFC_Vector3D v)
+{
+    GFC_Vector3D t;
+    //v + w * t + u x t, where u is the vector part and t = 2(u x v)
+    t.x = 2.0f * (q.y * v.z - q.z * v.y);
+    t.y = 2.0f * (q.z * v.x - q.x * v.z);
+    t.z = 2.0f * (q.x * v.y - q.y * v.x);
+    return gfc_vector3d(
+        v.x + q.w * t.x + (q.y * t.z - q.z * t.y),
+        v.y + q.w * t.y + (q.z * t.x - q.x * t.z),
+        v.z + q.w * t.z + (q.x * t.y - q.y * t.x));
+}
+
+GFC_Quaternion gfc_quaternion_nlerp(GFC_Quaternion a,GFC_Quaternion b,float t)
+{
+    float wa,wb;
+    wa = 1.0f - t;
+    wb = t;
+    //q and -q are the same rotation, pick the one on the near side of a
+    if (gfc_quaternion_dot(a,b) < 0)wb = -wb;
+    return gfc_quaternion_normalize(gfc_quaternion(
+        a.x * wa + b.x * wb,
+        a.y * wa + b.y * wb,
+        a.z * wa + b.z * wb,
+        a.w * wa + b.w * wb));
+}
+
+GFC_Quaternion gfc_quaternion_slerp(GFC_Quaternion a,GFC_Quaternion b,float t)
+{
+    float d,theta,s,wa,wb;
+    d = gfc_quaternion_dot(a,b);
+    if (d < 0)
+    {
+        d = -d;
+        b = gfc_quaternion(-b.x,-b.y,-b.z,-b.w);
+    }
+    if (d > GFC_QUATERNION_SLERP_THRESHOLD)
+    {
+        //sin(theta) is too close to zero to divide by, and the arc is nearly straight anyway
+        return gfc_quaternion_nlerp(a,b,t);
+    }
+    theta = acosf(d);
+    s = 1.0f / sinf(theta);
+    wa = sinf((1.0f - t) * theta) * s;
+    wb = sinf(t * theta) * s;
+    return gfc_quaternion(
+        a.x * wa + b.x * wb,
+        a.y * wa + b.y * wb,
+        a.z * wa + b.z * wb,
+        a.w * wa + b.w * wb);
+}
+
+void gfc_quaternion_batch_multiply(GFC_Quaternion *out,const GFC_Quaternion *a,const GFC_Quaternion *b,Uint32 count)
+{
+    Uint32 i;
+    if ((!out)||(!a)||(!b))return;
+    for (i = 0; i < count; i++)
+    {
+        out[i] = gfc_quaternion_multiply(a[i],b[i]);
+    }
+}
+
+void gfc_quaternion_batch_nlerp(GFC_Quaternion *out,const GFC_Quaternion *a,const GFC_Quaternion *b,float t,Uint32 count)
+{
+    Uint32 i;
+    if ((!out)||(!a)||(!b))return;
+    for (i = 0; i < count; i++)
+    {
+        out[i] = gfc_quaternion_nlerp(a[i],b[i],t);
+    }
+}
+
+void gfc_quaternion_batch_slerp(GFC_Quaternion *out,const GFC_Quaternion *a,const GFC_Quaternion *b,float t,Uint32 count)
+{
+    Uint32 i;
+    if ((!out)||(!a)||(!b))return;
+    for (i = 0; i < count; i++)
+    {
+        out[i] = gfc_quaternion_slerp(a[i],b[i],t);
+    }
+}
+
+void gfc_quaternion_batch_rotate(GFC_Vector3DBatch out,GFC_Vector3DBatch in,GFC_Quaternion q,Uint32 count)
+{
+    GFC_Matrix4 mat;
+    gfc_matrix4_from_quaternion(mat,q);
+    gfc_vector3d_batch_transform_direction(out,in,mat,count);
+}
+
+/*eol@eof*/
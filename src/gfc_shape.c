@@ -1498,6 +1498,40 @@ GFC_List *gfc_shape_get_bezier_point_list_3d(GFC_Vector3D p0, GFC_Vector3D p1, G
     return points;
 }
 
+GFC_Array *gfc_shape_get_bezier_point_array_2d(GFC_Vector2D p0, GFC_Vector2D p1, GFC_Vector2D p2,Uint32 count)
+{
+    Uint32 i;
+    GFC_Array *points;
+    GFC_Vector2D *point;
+    if (!count)count = 1;
+    points = gfc_array_new_size(sizeof(GFC_Vector2D),count + 1);
+    if (!points)return NULL;
+    for (i = 0; i <= count;i++)
+    {
+        point = gfc_array_append(points,NULL);
+        if (!point)break;
+        *point = gfc_shape_get_bezier_point_2d(p0,p1,p2,i / (float)count);
+    }
+    return points;
+}
+
+GFC_Array *gfc_shape_get_bezier_point_array_3d(GFC_Vector3D p0, GFC_Vector3D p1, GFC_Vector3D p2,Uint32 count)
+{
+    Uint32 i;
+    GFC_Array *points;
+    GFC_Vector3D *point;
+    if (!count)count = 1;
+    points = gfc_array_new_size(sizeof(GFC_Vector3D),count + 1);
+    if (!points)return NULL;
+    for (i = 0; i <= count;i++)
+    {
+        point = gfc_array_append(points,NULL);
+        if (!point)break;
+        *point = gfc_shape_get_bezier_point_3d(p0,p1,p2,i / (float)count);
+    }
+    return points;
+}
+
 void gfc_shape_point_list_free(GFC_List *list)
 {
     if (!list)return;
@@ -1505,4 +1539,577 @@ void gfc_shape_point_list_free(GFC_List *list)
     gfc_list_delete(list);
 }
 
+#define GFC_SHAPE_BATCH_BLOCK 64
+
+GFC_ShapeBatch *gfc_shape_batch_new()
+{
+    return gfc_allocate_array(sizeof(GFC_ShapeBatch),1);
+}
+
+void gfc_shape_batch_free(GFC_ShapeBatch *batch)
+{
+    if (!batch)return;
+    free(batch->rects.id);
+    free(batch->rects.x);
+    free(batch->rects.y);
+    free(batch->rects.w);
+    free(batch->rects.h);
+    free(batch->circles.id);
+    free(batch->circles.x);
+    free(batch->circles.y);
+    free(batch->circles.r);
+    free(batch->edges.id);
+    free(batch->edges.x1);
+    free(batch->edges.y1);
+    free(batch->edges.x2);
+    free(batch->edges.y2);
+    free(batch);
+}
+
+void gfc_shape_batch_clear(GFC_ShapeBatch *batch)
+{
+    if (!batch)return;
+    batch->rects.count = 0;
+    batch->circles.count = 0;
+    batch->edges.count = 0;
+}
+
+Uint32 gfc_shape_batch_get_count(GFC_ShapeBatch *batch)
+{
+    if (!batch)return 0;
+    return batch->rects.count + batch->circles.count + batch->edges.count;
+}
+
+/**
+ * @brief make room for one more shape in a set of parallel arrays
+ * @param id the id array
+ * @param fields the coordinate arrays
+ * @param fieldCount how many coordinate arrays there are
+ * @param count how many shapes are in the arrays now
+ * @param size how many shapes fit now, updated on success
+ * @return 0 on memory error, 1 otherwise.  On error the arrays that did grow are kept, so nothing leaks
+ */
+static int gfc_shape_batch_grow(Uint32 **id,float **fields[],int fieldCount,Uint32 count,Uint32 *size)
+{
+    int i;
+    Uint32 newSize;
+    void *data;
+    if (count < *size)return 1;
+    newSize = *size ? *size * 2 : 16;
+    data = realloc(*id,sizeof(Uint32) * newSize);
+    if (!data)
+    {
+        slog("failed to grow shape batch to %i shapes",newSize);
+        return 0;
+    }
+    *id = data;
+    for (i = 0; i < fieldCount; i++)
+    {
+        data = realloc(*fields[i],sizeof(float) * newSize);
+        if (!data)
+        {
+            slog("failed to grow shape batch to %i shapes",newSize);
+            return 0;
+        }
+        *fields[i] = data;
+    }
+    *size = newSize;
+    return 1;
+}
+
+int gfc_shape_batch_add(GFC_ShapeBatch *batch,GFC_Shape shape,Uint32 id)
+{
+    Uint32 n;
+    if (!batch)return 0;
+    switch (shape.type)
+    {
+        case ST_RECT:
+        {
+            GFC_RectBatch *rects = &batch->rects;
+            float **fields[] = {&rects->x,&rects->y,&rects->w,&rects->h};
+            if (!gfc_shape_batch_grow(&rects->id,fields,4,rects->count,&rects->size))return 0;
+            n = rects->count++;
+            rects->id[n] = id;
+            rects->x[n] = shape.s.r.x;
+            rects->y[n] = shape.s.r.y;
+            rects->w[n] = shape.s.r.w;
+            rects->h[n] = shape.s.r.h;
+            return 1;
+        }
+        case ST_CIRCLE:
+        {
+            GFC_CircleBatch *circles = &batch->circles;
+            float **fields[] = {&circles->x,&circles->y,&circles->r};
+            if (!gfc_shape_batch_grow(&circles->id,fields,3,circles->count,&circles->size))return 0;
+            n = circles->count++;
+            circles->id[n] = id;
+            circles->x[n] = shape.s.c.x;
+            circles->y[n] = shape.s.c.y;
+            circles->r[n] = shape.s.c.r;
+            return 1;
+        }
+        case ST_EDGE:
+        {
+            GFC_EdgeBatch *edges = &batch->edges;
+            float **fields[] = {&edges->x1,&edges->y1,&edges->x2,&edges->y2};
+            if (!gfc_shape_batch_grow(&edges->id,fields,4,edges->count,&edges->size))return 0;
+            n = edges->count++;
+            edges->id[n] = id;
+            edges->x1[n] = shape.s.e.x1;
+            edges->y1[n] = shape.s.e.y1;
+            edges->x2[n] = shape.s.e.x2;
+            edges->y2[n] = shape.s.e.y2;
+            return 1;
+        }
+    }
+    slog("cannot add unknown shape type %i to batch",shape.type);
+    return 0;
+}
+
+/**
+ * @brief fill flags for a block of rects, 1 where the rect overlaps the query shape
+ * @note the loops only compare and combine, no branches or early outs, so they vectorize
+ */
+static void gfc_shape_batch_test_rects(GFC_RectBatch *rects,Uint32 start,Uint32 n,GFC_Shape shape,int *flags)
+{
+    Uint32 i;
+    const float *x = &rects->x[start],*y = &rects->y[start],*w = &rects->w[start],*h = &rects->h[start];
+    float qx,qy,qw,qh,qr,px,py,dx,dy;
+    if (shape.type == ST_RECT)
+    {
+        qx = shape.s.r.x;
+        qy = shape.s.r.y;
+        qw = qx + shape.s.r.w;
+        qh = qy + shape.s.r.h;
+        for (i = 0; i < n; i++)
+        {
+            flags[i] = (qx <= x[i] + w[i]) & (x[i] <= qw) & (qy <= y[i] + h[i]) & (y[i] <= qh);
+        }
+        return;
+    }
+    //circle: find the closest point of the rect to the center
+    qx = shape.s.c.x;
+    qy = shape.s.c.y;
+    qr = shape.s.c.r * shape.s.c.r;
+    for (i = 0; i < n; i++)
+    {
+        px = (qx < x[i]) ? x[i] : qx;
+        px = (px > x[i] + w[i]) ? x[i] + w[i] : px;
+        py = (qy < y[i]) ? y[i] : qy;
+        py = (py > y[i] + h[i]) ? y[i] + h[i] : py;
+        dx = qx - px;
+        dy = qy - py;
+        flags[i] = (dx * dx + dy * dy <= qr);
+    }
+}
+
+/**
+ * @brief fill flags for a block of circles, 1 where the circle overlaps the query shape
+ */
+static void gfc_shape_batch_test_circles(GFC_CircleBatch *circles,Uint32 start,Uint32 n,GFC_Shape shape,int *flags)
+{
+    Uint32 i;
+    const float *x = &circles->x[start],*y = &circles->y[start],*r = &circles->r[start];
+    float qx,qy,qw,qh,qr,px,py,dx,dy;
+    if (shape.type == ST_CIRCLE)
+    {
+        qx = shape.s.c.x;
+        qy = shape.s.c.y;
+        qr = shape.s.c.r;
+        for (i = 0; i < n; i++)
+        {
+            dx = qx - x[i];
+            dy = qy - y[i];
+            flags[i] = (dx * dx + dy * dy <= (qr + r[i]) * (qr + r[i]));
+        }
+        return;
+    }
+    //rect: find the closest point of the rect to each center
+    qx = shape.s.r.x;
+    qy = shape.s.r.y;
+    qw = qx + shape.s.r.w;
+    qh = qy + shape.s.r.h;
+    for (i = 0; i < n; i++)
+    {
+        px = (x[i] < qx) ? qx : x[i];
+        px = (px > qw) ? qw : px;
+        py = (y[i] < qy) ? qy : y[i];
+        py = (py > qh) ? qh : py;
+        dx = x[i] - px;
+        dy = y[i] - py;
+        flags[i] = (dx * dx + dy * dy <= r[i] * r[i]);
+    }
+}
+
+/**
+ * @brief copy the ids of the flagged shapes into hits
+ * @return the new hit count
+ */
+static Uint32 gfc_shape_batch_gather(const Uint32 *id,const int *flags,Uint32 n,Uint32 *hits,Uint32 hitCount,Uint32 maxHits)
+{
+    Uint32 i;
+    for (i = 0; (i < n)&&(hitCount < maxHits); i++)
+    {
+        if (flags[i])hits[hitCount++] = id[i];
+    }
+    return hitCount;
+}
+
+Uint32 gfc_shape_batch_overlap(GFC_ShapeBatch *batch,GFC_Shape shape,Uint32 *hits,Uint32 maxHits)
+{
+    Uint32 i,start,n,hitCount = 0;
+    int flags[GFC_SHAPE_BATCH_BLOCK];
+    if ((!batch)||(!hits)||(!maxHits))return 0;
+    if (shape.type == ST_EDGE)
+    {
+        for (i = 0; (i < batch->rects.count)&&(hitCount < maxHits); i++)
+        {
+            if (gfc_shape_overlap(shape,gfc_shape_rect(batch->rects.x[i],batch->rects.y[i],batch->rects.w[i],batch->rects.h[i])))
+            {
+                hits[hitCount++] = batch->rects.id[i];
+            }
+        }
+        for (i = 0; (i < batch->circles.count)&&(hitCount < maxHits); i++)
+        {
+            if (gfc_shape_overlap(shape,gfc_shape_circle(batch->circles.x[i],batch->circles.y[i],batch->circles.r[i])))
+            {
+                hits[hitCount++] = batch->circles.id[i];
+            }
+        }
+    }
+    else
+    {
+        for (start = 0; (start < batch->rects.count)&&(hitCount < maxHits); start += n)
+        {
+            n = MIN(batch->rects.count - start,GFC_SHAPE_BATCH_BLOCK);
+            gfc_shape_batch_test_rects(&batch->rects,start,n,shape,flags);
+            hitCount = gfc_shape_batch_gather(&batch->rects.id[start],flags,n,hits,hitCount,maxHits);
+        }
+        for (start = 0; (start < batch->circles.count)&&(hitCount < maxHits); start += n)
+        {
+            n = MIN(batch->circles.count - start,GFC_SHAPE_BATCH_BLOCK);
+            gfc_shape_batch_test_circles(&batch->circles,start,n,shape,flags);
+            hitCount = gfc_shape_batch_gather(&batch->circles.id[start],flags,n,hits,hitCount,maxHits);
+        }
+    }
+    for (i = 0; (i < batch->edges.count)&&(hitCount < maxHits); i++)
+    {
+        if (gfc_shape_overlap(shape,gfc_shape_edge(batch->edges.x1[i],batch->edges.y1[i],batch->edges.x2[i],batch->edges.y2[i])))
+        {
+            hits[hitCount++] = batch->edges.id[i];
+        }
+    }
+    return hitCount;
+}
+
+#define GFC_RAYCAST_MISS 2.0f      /**<any fraction past 1 is a miss, this one is for marking them*/
+#define GFC_RAYCAST_HUGE 1e30f     /**<stands in for 1 / 0 in the slab test*/
+
+/**
+ * @brief a ray in the form the per shape tests want, worked out once per ray
+ */
+typedef struct
+{
+    float ox,oy;    /**<where the ray starts*/
+    float dx,dy;    /**<from the start to the end*/
+    float ix,iy;    /**<1 / dx and 1 / dy, or a huge number where those are 0*/
+    float dd;       /**<dx * dx + dy * dy*/
+}GFC_RayInfo;
+
+static GFC_RayInfo gfc_ray_info(GFC_Edge2D ray)
+{
+    GFC_RayInfo info;
+    info.ox = ray.x1;
+    info.oy = ray.y1;
+    info.dx = ray.x2 - ray.x1;
+    info.dy = ray.y2 - ray.y1;
+    info.ix = (info.dx != 0) ? 1.0f / info.dx : GFC_RAYCAST_HUGE;
+    info.iy = (info.dy != 0) ? 1.0f / info.dy : GFC_RAYCAST_HUGE;
+    info.dd = info.dx * info.dx + info.dy * info.dy;
+    return info;
+}
+
+/*
+ * The per shape tests below return the fraction along the ray of the hit, or GFC_RAYCAST_MISS.
+ * They select with ?: rather than branching so the block loops that call them vectorize
+ */
+
+/**
+ * @brief where a ray first crosses the border of a rect, by clipping it against the x and y slabs
+ */
+static inline float gfc_ray_rect_fraction(GFC_RayInfo ray,float x,float y,float w,float h)
+{
+    float tx1,tx2,ty1,ty2,txn,txf,tyn,tyf,tn,tf,t;
+    tx1 = (x - ray.ox) * ray.ix;
+    tx2 = (x + w - ray.ox) * ray.ix;
+    ty1 = (y - ray.oy) * ray.iy;
+    ty2 = (y + h - ray.oy) * ray.iy;
+    txn = MIN(tx1,tx2);
+    txf = MAX(tx1,tx2);
+    tyn = MIN(ty1,ty2);
+    tyf = MAX(ty1,ty2);
+    tn = MAX(txn,tyn);
+    tf = MIN(txf,tyf);
+    //starting inside, the ray crosses the border on its way out
+    t = (tn >= 0) ? tn : tf;
+    return ((tn <= tf) & (t >= 0) & (t <= 1)) ? t : GFC_RAYCAST_MISS;
+}
+
+/**
+ * @brief where a ray crosses an edge, same math as gfc_edge_intersect_poc
+ */
+static inline float gfc_ray_edge_fraction(GFC_RayInfo ray,float x1,float y1,float x2,float y2)
+{
+    float ex,ey,den,inv,ua,ub;
+    ex = x2 - x1;
+    ey = y2 - y1;
+    den = ey * ray.dx - ex * ray.dy;
+    //den is 0 when parallel, which can't hit.  Guarding the divide would stop the loop vectorizing,
+    //so let it make infinities and NaNs and reject those lanes afterwards
+    inv = 1.0f / den;
+    ua = (ex * (ray.oy - y1) - ey * (ray.ox - x1)) * inv;
+    ub = (ray.dx * (ray.oy - y1) - ray.dy * (ray.ox - x1)) * inv;
+    return ((den != 0) & (ua >= 0) & (ua <= 1) & (ub >= 0) & (ub <= 1)) ? ua : GFC_RAYCAST_MISS;
+}
+
+/**
+ * @brief could a ray meet a circle before limit, worked out without a square root so it vectorizes.
+ * Lets through every circle gfc_ray_circle_fraction would hit nearer than limit, and a few it would not
+ */
+static inline int gfc_ray_circle_candidate(GFC_RayInfo ray,float x,float y,float r,float limit)
+{
+    float fx,fy,b,c,det,k;
+    fx = ray.ox - x;
+    fy = ray.oy - y;
+    b = fx * ray.dx + fy * ray.dy;
+    c = fx * fx + fy * fy - r * r;
+    det = b * b - ray.dd * c;
+    k = -b - limit * ray.dd;
+    //the line meets the circle, the far crossing is not behind the start, and the near one is not past limit
+    return (det >= 0) & ((b <= 0) | (c <= 0)) & ((k <= 0) | (det >= k * k));
+}
+
+/**
+ * @brief where a ray first crosses a circle
+ */
+static inline float gfc_ray_circle_fraction(GFC_RayInfo ray,float x,float y,float r)
+{
+    float fx,fy,b,c,det,s,t;
+    fx = ray.ox - x;
+    fy = ray.oy - y;
+    b = fx * ray.dx + fy * ray.dy;
+    c = fx * fx + fy * fy - r * r;
+    det = b * b - ray.dd * c;
+    if ((det < 0)||(ray.dd == 0))return GFC_RAYCAST_MISS;
+    s = sqrtf(det);
+    t = (-b - s) / ray.dd;
+    if (t < 0)t = (-b + s) / ray.dd;//starting inside, the ray crosses on its way out
+    if ((t < 0)||(t > 1))return GFC_RAYCAST_MISS;
+    return t;
+}
+
+static float gfc_ray_shape_fraction(GFC_RayInfo ray,GFC_Shape shape)
+{
+    switch (shape.type)
+    {
+        case ST_RECT:
+            return gfc_ray_rect_fraction(ray,shape.s.r.x,shape.s.r.y,shape.s.r.w,shape.s.r.h);
+        case ST_CIRCLE:
+            return gfc_ray_circle_fraction(ray,shape.s.c.x,shape.s.c.y,shape.s.c.r);
+        case ST_EDGE:
+            return gfc_ray_edge_fraction(ray,shape.s.e.x1,shape.s.e.y1,shape.s.e.x2,shape.s.e.y2);
+    }
+    return GFC_RAYCAST_MISS;
+}
+
+/**
+ * @brief fill in the point of contact and normal for a hit at fraction t
+ */
+static void gfc_ray_fill_hit(GFC_RayInfo ray,GFC_Shape shape,float t,GFC_RaycastHit *hit)
+{
+    float d,best;
+    memset(hit,0,sizeof(GFC_RaycastHit));
+    hit->hit = 1;
+    hit->fraction = t;
+    hit->poc = gfc_vector2d(ray.ox + ray.dx * t,ray.oy + ray.dy * t);
+    switch (shape.type)
+    {
+        case ST_RECT:
+            //the face the contact is on
+            best = fabsf(hit->poc.x - shape.s.r.x);
+            hit->normal = gfc_vector2d(-1,0);
+            d = fabsf(hit->poc.x - (shape.s.r.x + shape.s.r.w));
+            if (d < best)
+            {
+                best = d;
+                hit->normal = gfc_vector2d(1,0);
+            }
+            d = fabsf(hit->poc.y - shape.s.r.y);
+            if (d < best)
+            {
+                best = d;
+                hit->normal = gfc_vector2d(0,-1);
+            }
+            d = fabsf(hit->poc.y - (shape.s.r.y + shape.s.r.h));
+            if (d < best)
+            {
+                hit->normal = gfc_vector2d(0,1);
+            }
+            break;
+        case ST_CIRCLE:
+            hit->normal = gfc_vector2d(hit->poc.x - shape.s.c.x,hit->poc.y - shape.s.c.y);
+            if ((hit->normal.x == 0)&&(hit->normal.y == 0))hit->normal = gfc_vector2d(-ray.dx,-ray.dy);
+            gfc_vector2d_normalize(&hit->normal);
+            break;
+        case ST_EDGE:
+            hit->normal = gfc_vector2d(shape.s.e.y1 - shape.s.e.y2,shape.s.e.x2 - shape.s.e.x1);
+            if (hit->normal.x * ray.dx + hit->normal.y * ray.dy > 0)
+            {
+                hit->normal.x = -hit->normal.x;
+                hit->normal.y = -hit->normal.y;
+            }
+            gfc_vector2d_normalize(&hit->normal);
+            break;
+    }
+}
+
+Uint8 gfc_raycast_shape(GFC_Edge2D ray,GFC_Shape shape,GFC_RaycastHit *hit)
+{
+    float t;
+    GFC_RayInfo info;
+    info = gfc_ray_info(ray);
+    t = gfc_ray_shape_fraction(info,shape);
+    if (t > 1)return 0;
+    if (hit)gfc_ray_fill_hit(info,shape,t,hit);
+    return 1;
+}
+
+static void gfc_raycast_rect_block(GFC_RayInfo ray,GFC_RectBatch *rects,Uint32 start,Uint32 n,float *t)
+{
+    Uint32 i;
+    const float *x = &rects->x[start],*y = &rects->y[start],*w = &rects->w[start],*h = &rects->h[start];
+    for (i = 0; i < n; i++)
+    {
+        t[i] = gfc_ray_rect_fraction(ray,x[i],y[i],w[i],h[i]);
+    }
+}
+
+static void gfc_raycast_edge_block(GFC_RayInfo ray,GFC_EdgeBatch *edges,Uint32 start,Uint32 n,float *t)
+{
+    Uint32 i;
+    const float *x1 = &edges->x1[start],*y1 = &edges->y1[start],*x2 = &edges->x2[start],*y2 = &edges->y2[start];
+    for (i = 0; i < n; i++)
+    {
+        t[i] = gfc_ray_edge_fraction(ray,x1[i],y1[i],x2[i],y2[i]);
+    }
+}
+
+/**
+ * @brief sqrtf keeps the circle test from vectorizing, so the vectorized pass only picks out the circles the ray
+ * can reach before limit, and the exact test runs on those alone
+ */
+static void gfc_raycast_circle_block(GFC_RayInfo ray,GFC_CircleBatch *circles,Uint32 start,Uint32 n,float limit,float *t)
+{
+    Uint32 i;
+    int flags[GFC_SHAPE_BATCH_BLOCK];
+    const float *x = &circles->x[start],*y = &circles->y[start],*r = &circles->r[start];
+    for (i = 0; i < n; i++)
+    {
+        flags[i] = gfc_ray_circle_candidate(ray,x[i],y[i],r[i],limit);
+    }
+    for (i = 0; i < n; i++)
+    {
+        t[i] = flags[i] ? gfc_ray_circle_fraction(ray,x[i],y[i],r[i]) : GFC_RAYCAST_MISS;
+    }
+}
+
+/**
+ * @brief find the nearest hit in a block that beats best
+ * @param t the fractions of the block
+ * @param n how many there are
+ * @param best the nearest hit so far, updated if one in the block is nearer
+ * @param index set to the index within the block of the new nearest
+ * @return 1 if the block had a nearer hit, 0 otherwise
+ */
+static int gfc_raycast_block_nearest(const float *t,Uint32 n,float *best,Uint32 *index)
+{
+    Uint32 i;
+    int nearer = 0;
+    float b = *best;
+    //vectorized check first, most blocks have nothing nearer than the best so far
+    for (i = 0; i < n; i++)
+    {
+        nearer |= (t[i] < b);
+    }
+    if (!nearer)return 0;
+    for (i = 0; i < n; i++)
+    {
+        if (t[i] < b)
+        {
+            b = t[i];
+            *index = i;
+        }
+    }
+    *best = b;
+    return 1;
+}
+
+static Uint8 gfc_raycast_batch_ray(GFC_Edge2D ray,GFC_ShapeBatch *shapes,GFC_RaycastHit *hit)
+{
+    float t[GFC_SHAPE_BATCH_BLOCK];
+    float best = GFC_RAYCAST_MISS;
+    Uint32 start,n,index = 0,bestId = 0;
+    GFC_Shape shape = {0};
+    GFC_RayInfo info;
+    info = gfc_ray_info(ray);
+    for (start = 0; start < shapes->rects.count; start += n)
+    {
+        n = MIN(shapes->rects.count - start,GFC_SHAPE_BATCH_BLOCK);
+        gfc_raycast_rect_block(info,&shapes->rects,start,n,t);
+        if (!gfc_raycast_block_nearest(t,n,&best,&index))continue;
+        index += start;
+        bestId = shapes->rects.id[index];
+        shape = gfc_shape_rect(shapes->rects.x[index],shapes->rects.y[index],shapes->rects.w[index],shapes->rects.h[index]);
+    }
+    for (start = 0; start < shapes->circles.count; start += n)
+    {
+        n = MIN(shapes->circles.count - start,GFC_SHAPE_BATCH_BLOCK);
+        gfc_raycast_circle_block(info,&shapes->circles,start,n,MIN(best,1),t);
+        if (!gfc_raycast_block_nearest(t,n,&best,&index))continue;
+        index += start;
+        bestId = shapes->circles.id[index];
+        shape = gfc_shape_circle(shapes->circles.x[index],shapes->circles.y[index],shapes->circles.r[index]);
+    }
+    for (start = 0; start < shapes->edges.count; start += n)
+    {
+        n = MIN(shapes->edges.count - start,GFC_SHAPE_BATCH_BLOCK);
+        gfc_raycast_edge_block(info,&shapes->edges,start,n,t);
+        if (!gfc_raycast_block_nearest(t,n,&best,&index))continue;
+        index += start;
+        bestId = shapes->edges.id[index];
+        shape = gfc_shape_edge(shapes->edges.x1[index],shapes->edges.y1[index],shapes->edges.x2[index],shapes->edges.y2[index]);
+    }
+    if (best > 1)return 0;
+    gfc_ray_fill_hit(info,shape,best,hit);
+    hit->id = bestId;
+    return 1;
+}
+
+Uint32 gfc_raycast_batch(const GFC_Edge2D *rays,Uint32 rayCount,GFC_ShapeBatch *shapes,GFC_RaycastHit *hits)
+{
+    Uint32 i,hitCount = 0;
+    if ((!rays)||(!hits))return 0;
+    for (i = 0; i < rayCount; i++)
+    {
+        if ((shapes)&&(gfc_raycast_batch_ray(rays[i],shapes,&hits[i])))
+        {
+            hitCount++;
+            continue;
+        }
+        memset(&hits[i],0,sizeof(GFC_RaycastHit));
+        hits[i].fraction = 1;
+    }
+    return hitCount;
+}
+
 /*eol@eof*/
@@ -0,0 +1,434 @@
+#include "simple_logger.h"
+
+#include "gfc_spatial_hash.h"
+
+typedef struct
+{
+    Sint32  x,y;        /**<which cell this is*/
+    Uint32  listIndex;  /**<where the cell is in cellList*/
+    Uint32  count;
+    Uint32  size;
+    Uint32 *bodies;     /**<handles of the bodies touching this cell*/
+}GFC_SpatialHashCell;
+
+typedef struct
+{
+    GFC_SpatialHash2D          *hash;
+    gfc_spatial_hash_pair_func *func;
+    void                       *context;
+}GFC_SpatialHashOverlapContext;
+
+#define gfc_spatial_hash_cell_key(x,y) (((Uint64)(Uint32)(x) << 32) | (Uint64)(Uint32)(y))
+#define gfc_spatial_hash_body(hash,handle) (&gfc_array_nth_as((hash)->bodies,GFC_SpatialHashBody,(handle) - 1))
+
+GFC_SpatialHash2D *gfc_spatial_hash_new(float cellSize)
+{
+    GFC_SpatialHash2D *hash;
+    if (cellSize <= 0)
+    {
+        slog("spatial hash cell size must be greater than zero");
+        return NULL;
+    }
+    hash = gfc_allocate_array(sizeof(GFC_SpatialHash2D),1);
+    if (!hash)return NULL;
+    hash->cellSize = cellSize;
+    hash->invCellSize = 1.0f / cellSize;
+    hash->bodies = gfc_array_new(sizeof(GFC_SpatialHashBody));
+    hash->cells = gfc_intmap_new();
+    hash->cellList = gfc_list_new();
+    hash->cellPool = gfc_list_new();
+    if ((!hash->bodies)||(!hash->cells)||(!hash->cellList)||(!hash->cellPool))
+    {
+        gfc_spatial_hash_free(hash);
+        return NULL;
+    }
+    return hash;
+}
+
+static void gfc_spatial_hash_free_cell_list(GFC_List *list)
+{
+    Uint32 i,c;
+    GFC_SpatialHashCell *cell;
+    if (!list)return;
+    c = gfc_list_get_count(list);
+    for (i = 0; i < c; i++)
+    {
+        cell = gfc_list_get_nth(list,i);
+        if (!cell)continue;
+        free(cell->bodies);
+        free(cell);
+    }
+    gfc_list_clear(list);
+}
+
+static void gfc_spatial_hash_free_cells(GFC_SpatialHash2D *hash)
+{
+    gfc_spatial_hash_free_cell_list(hash->cellList);
+    gfc_spatial_hash_free_cell_list(hash->cellPool);
+}
+
+void gfc_spatial_hash_free(GFC_SpatialHash2D *hash)
+{
+    if (!hash)return;
+    gfc_spatial_hash_free_cells(hash);
+    gfc_list_delete(hash->cellList);
+    gfc_list_delete(hash->cellPool);
+    gfc_intmap_free(hash->cells);
+    gfc_array_delete(hash->bodies);
+    free(hash);
+}
+
+void gfc_spatial_hash_clear(GFC_SpatialHash2D *hash)
+{
+    if (!hash)return;
+    gfc_spatial_hash_free_cells(hash);
+    gfc_intmap_free(hash->cells);
+    hash->cells = gfc_intmap_new();
+    gfc_array_clear(hash->bodies);
+    hash->freeHead = GFC_SPATIAL_HASH_NONE;
+    hash->count = 0;
+}
+
+static GFC_SpatialHashBody *gfc_spatial_hash_get_body(GFC_SpatialHash2D *hash,Uint32 handle)
+{
+    GFC_SpatialHashBody *body;
+    if ((!hash)||(handle == GFC_SPATIAL_HASH_NONE)||(handle > gfc_array_get_count(hash->bodies)))return NULL;
+    body = gfc_spatial_hash_body(hash,handle);
+    if (!body->inUse)return NULL;
+    return body;
+}
+
+/**
+ * @brief floor to an int.  The cast truncates toward zero, so step negative fractions down by one.
+ * floorf is a library call on targets without SSE4.1, and this runs four times per body update
+ */
+static inline Sint32 gfc_spatial_hash_floor(float v)
+{
+    Sint32 i = (Sint32)v;
+    return i - (v < (float)i);
+}
+
+/**
+ * @brief work out which cells a rect covers
+ */
+static void gfc_spatial_hash_cell_range(GFC_SpatialHash2D *hash,GFC_Rect r,Sint32 *x1,Sint32 *y1,Sint32 *x2,Sint32 *y2)
+{
+    *x1 = gfc_spatial_hash_floor(r.x * hash->invCellSize);
+    *y1 = gfc_spatial_hash_floor(r.y * hash->invCellSize);
+    *x2 = gfc_spatial_hash_floor((r.x + r.w) * hash->invCellSize);
+    *y2 = gfc_spatial_hash_floor((r.y + r.h) * hash->invCellSize);
+}
+
+/**
+ * @brief take an empty cell out of the grid and put it in the pool, so cells a body has passed through
+ * are not kept and walked forever
+ */
+static void gfc_spatial_hash_cell_release(GFC_SpatialHash2D *hash,GFC_SpatialHashCell *cell,Uint64 key)
+{
+    GFC_SpatialHashCell *moved;
+    gfc_intmap_delete_by_key(hash->cells,key);
+    //the last cell in the list moves into this one's place
+    gfc_list_delete_nth_unordered(hash->cellList,cell->listIndex);
+    moved = gfc_list_get_nth(hash->cellList,cell->listIndex);
+    if (moved)moved->listIndex = cell->listIndex;
+    gfc_list_append(hash->cellPool,cell);
+}
+
+static int gfc_spatial_hash_cell_add(GFC_SpatialHash2D *hash,Sint32 x,Sint32 y,Uint32 handle)
+{
+    Uint64 key;
+    Uint32 *bodies;
+    GFC_SpatialHashCell *cell;
+    key = gfc_spatial_hash_cell_key(x,y);
+    cell = gfc_intmap_get(hash->cells,key);
+    if (!cell)
+    {
+        //reuse an emptied cell, and its bodies array, before allocating a new one
+        cell = gfc_list_get_nth(hash->cellPool,gfc_list_get_count(hash->cellPool) - 1);
+        if (cell)gfc_list_delete_last(hash->cellPool);
+        else cell = gfc_allocate_array(sizeof(GFC_SpatialHashCell),1);
+        if (!cell)return 0;
+        cell->x = x;
+        cell->y = y;
+        cell->count = 0;
+        cell->listIndex = gfc_list_get_count(hash->cellList);
+        gfc_intmap_insert(hash->cells,key,cell);
+        gfc_list_append(hash->cellList,cell);
+    }
+    if (cell->count >= cell->size)
+    {
+        bodies = realloc(cell->bodies,sizeof(Uint32) * (cell->size ? cell->size * 2 : 4));
+        if (!bodies)
+        {
+            slog("failed to grow spatial hash cell");
+            if (!cell->count)gfc_spatial_hash_cell_release(hash,cell,key);
+            return 0;
+        }
+        cell->bodies = bodies;
+        cell->size = cell->size ? cell->size * 2 : 4;
+    }
+    cell->bodies[cell->count++] = handle;
+    return 1;
+}
+
+static void gfc_spatial_hash_cell_remove(GFC_SpatialHash2D *hash,Sint32 x,Sint32 y,Uint32 handle)
+{
+    Uint32 i;
+    Uint64 key;
+    GFC_SpatialHashCell *cell;
+    key = gfc_spatial_hash_cell_key(x,y);
+    cell = gfc_intmap_get(hash->cells,key);
+    if (!cell)return;
+    for (i = 0; i < cell->count; i++)
+    {
+        if (cell->bodies[i] != handle)continue;
+        //order within a cell does not matter
+        cell->bodies[i] = cell->bodies[--cell->count];
+        if (!cell->count)gfc_spatial_hash_cell_release(hash,cell,key);
+        return;
+    }
+}
+
+static void gfc_spatial_hash_unlink(GFC_SpatialHash2D *hash,GFC_SpatialHashBody *body,Uint32 handle)
+{
+    Sint32 x,y;
+    for (y = body->cellY1; y <= body->cellY2; y++)
+    {
+        for (x = body->cellX1; x <= body->cellX2; x++)
+        {
+            gfc_spatial_hash_cell_remove(hash,x,y,handle);
+        }
+    }
+}
+
+static void gfc_spatial_hash_link(GFC_SpatialHash2D *hash,GFC_SpatialHashBody *body,Uint32 handle)
+{
+    Sint32 x,y;
+    for (y = body->cellY1; y <= body->cellY2; y++)
+    {
+        for (x = body->cellX1; x <= body->cellX2; x++)
+        {
+            gfc_spatial_hash_cell_add(hash,x,y,handle);
+        }
+    }
+}
+
+Uint32 gfc_spatial_hash_insert(GFC_SpatialHash2D *hash,GFC_Shape shape,void *data)
+{
+    Uint32 handle;
+    GFC_SpatialHashBody *body;
+    if (!hash)return GFC_SPATIAL_HASH_NONE;
+    if (hash->freeHead != GFC_SPATIAL_HASH_NONE)
+    {
+        handle = hash->freeHead;
+        body = gfc_spatial_hash_body(hash,handle);
+        hash->freeHead = body->nextFree;
+    }
+    else
+    {
+        body = gfc_array_append(hash->bodies,NULL);
+        if (!body)return GFC_SPATIAL_HASH_NONE;
+        handle = gfc_array_get_count(hash->bodies);
+    }
+    memset(body,0,sizeof(GFC_SpatialHashBody));
+    body->inUse = 1;
+    body->shape = shape;
+    body->data = data;
+    body->bounds = gfc_shape_get_bounds(shape);
+    gfc_spatial_hash_cell_range(hash,body->bounds,&body->cellX1,&body->cellY1,&body->cellX2,&body->cellY2);
+    gfc_spatial_hash_link(hash,body,handle);
+    hash->count++;
+    return handle;
+}
+
+void gfc_spatial_hash_remove(GFC_SpatialHash2D *hash,Uint32 handle)
+{
+    GFC_SpatialHashBody *body;
+    body = gfc_spatial_hash_get_body(hash,handle);
+    if (!body)return;
+    gfc_spatial_hash_unlink(hash,body,handle);
+    body->inUse = 0;
+    body->data = NULL;
+    body->nextFree = hash->freeHead;
+    hash->freeHead = handle;
+    hash->count--;
+}
+
+void gfc_spatial_hash_update(GFC_SpatialHash2D *hash,Uint32 handle,GFC_Shape shape)
+{
+    Sint32 x1,y1,x2,y2;
+    GFC_SpatialHashBody *body;
+    body = gfc_spatial_hash_get_body(hash,handle);
+    if (!body)return;
+    body->shape = shape;
+    body->bounds = gfc_shape_get_bounds(shape);
+    gfc_spatial_hash_cell_range(hash,body->bounds,&x1,&y1,&x2,&y2);
+    if ((x1 == body->cellX1)&&(y1 == body->cellY1)&&(x2 == body->cellX2)&&(y2 == body->cellY2))
+    {
+        return;//still in the same cells, the common case for small moves
+    }
+    gfc_spatial_hash_unlink(hash,body,handle);
+    body->cellX1 = x1;
+    body->cellY1 = y1;
+    body->cellX2 = x2;
+    body->cellY2 = y2;
+    gfc_spatial_hash_link(hash,body,handle);
+}
+
+void gfc_spatial_hash_move(GFC_SpatialHash2D *hash,Uint32 handle,GFC_Vector2D move)
+{
+    GFC_Shape shape;
+    GFC_SpatialHashBody *body;
+    body = gfc_spatial_hash_get_body(hash,handle);
+    if (!body)return;
+    shape = body->shape;
+    gfc_shape_move(&shape,move);
+    gfc_spatial_hash_update(hash,handle,shape);
+}
+
+void *gfc_spatial_hash_get_data(GFC_SpatialHash2D *hash,Uint32 handle)
+{
+    GFC_SpatialHashBody *body;
+    body = gfc_spatial_hash_get_body(hash,handle);
+    if (!body)return NULL;
+    return body->data;
+}
+
+GFC_Shape *gfc_spatial_hash_get_shape(GFC_SpatialHash2D *hash,Uint32 handle)
+{
+    GFC_SpatialHashBody *body;
+    body = gfc_spatial_hash_get_body(hash,handle);
+    if (!body)return NULL;
+    return &body->shape;
+}
+
+Uint32 gfc_spatial_hash_get_count(GFC_SpatialHash2D *hash)
+{
+    if (!hash)return 0;
+    return hash->count;
+}
+
+static Uint8 gfc_spatial_hash_bounds_overlap(GFC_Rect a,GFC_Rect b)
+{
+    return (a.x <= b.x + b.w)&&(b.x <= a.x + a.w)&&(a.y <= b.y + b.h)&&(b.y <= a.y + a.h);
+}
+
+/**
+ * @brief test the bodies of one cell against a query, adding new hits to handles
+ * @return the new hit count
+ */
+static Uint32 gfc_spatial_hash_query_cell(
+    GFC_SpatialHash2D *hash,
+    GFC_SpatialHashCell *cell,
+    GFC_Shape shape,
+    GFC_Rect bounds,
+    Uint32 *handles,
+    Uint32 found,
+    Uint32 maxHandles)
+{
+    Uint32 i;
+    GFC_SpatialHashBody *body;
+    for (i = 0; (i < cell->count)&&(found < maxHandles); i++)
+    {
+        body = gfc_spatial_hash_body(hash,cell->bodies[i]);
+        if (body->stamp == hash->stamp)continue;//already tested from another cell
+        body->stamp = hash->stamp;
+        if (!gfc_spatial_hash_bounds_overlap(bounds,body->bounds))continue;
+        if (!gfc_shape_overlap(shape,body->shape))continue;
+        handles[found++] = cell->bodies[i];
+    }
+    return found;
+}
+
+Uint32 gfc_spatial_hash_query_shape(GFC_SpatialHash2D *hash,GFC_Shape shape,Uint32 *handles,Uint32 maxHandles)
+{
+    Sint32 x,y,x1,y1,x2,y2;
+    Uint32 i,c,found = 0;
+    GFC_Rect bounds;
+    GFC_SpatialHashCell *cell;
+    if ((!hash)||(!handles)||(!maxHandles)||(!hash->count))return 0;
+    hash->stamp++;
+    bounds = gfc_shape_get_bounds(shape);
+    gfc_spatial_hash_cell_range(hash,bounds,&x1,&y1,&x2,&y2);
+    c = gfc_list_get_count(hash->cellList);
+    if ((double)(x2 - x1 + 1) * (double)(y2 - y1 + 1) > c)
+    {
+        //the query covers more cells than exist, cheaper to walk the ones that do
+        for (i = 0; (i < c)&&(found < maxHandles); i++)
+        {
+            cell = gfc_list_get_nth(hash->cellList,i);
+            if ((cell->x < x1)||(cell->x > x2)||(cell->y < y1)||(cell->y > y2))continue;
+            found = gfc_spatial_hash_query_cell(hash,cell,shape,bounds,handles,found,maxHandles);
+        }
+        return found;
+    }
+    for (y = y1; (y <= y2)&&(found < maxHandles); y++)
+    {
+        for (x = x1; (x <= x2)&&(found < maxHandles); x++)
+        {
+            cell = gfc_intmap_get(hash->cells,gfc_spatial_hash_cell_key(x,y));
+            if (!cell)continue;
+            found = gfc_spatial_hash_query_cell(hash,cell,shape,bounds,handles,found,maxHandles);
+        }
+    }
+    return found;
+}
+
+Uint32 gfc_spatial_hash_query_rect(GFC_SpatialHash2D *hash,GFC_Rect rect,Uint32 *handles,Uint32 maxHandles)
+{
+    return gfc_spatial_hash_query_shape(hash,gfc_shape_from_rect(rect),handles,maxHandles);
+}
+
+Uint32 gfc_spatial_hash_query_circle(GFC_SpatialHash2D *hash,GFC_Circle circle,Uint32 *handles,Uint32 maxHandles)
+{
+    return gfc_spatial_hash_query_shape(hash,gfc_shape_from_circle(circle),handles,maxHandles);
+}
+
+void gfc_spatial_hash_foreach_pair(GFC_SpatialHash2D *hash,gfc_spatial_hash_pair_func *func,void *context)
+{
+    Uint32 i,j,n,c;
+    Sint32 x,y;
+    GFC_SpatialHashCell *cell;
+    GFC_SpatialHashBody *a,*b;
+    if ((!hash)||(!func))return;
+    c = gfc_list_get_count(hash->cellList);
+    for (n = 0; n < c; n++)
+    {
+        cell = gfc_list_get_nth(hash->cellList,n);
+        if (cell->count < 2)continue;
+        x = cell->x;
+        y = cell->y;
+        for (i = 0; i < cell->count; i++)
+        {
+            a = gfc_spatial_hash_body(hash,cell->bodies[i]);
+            for (j = i + 1; j < cell->count; j++)
+            {
+                b = gfc_spatial_hash_body(hash,cell->bodies[j]);
+                //two bodies can share several cells, only the first cell of their overlap reports them
+                if (MAX(a->cellX1,b->cellX1) != x)continue;
+                if (MAX(a->cellY1,b->cellY1) != y)continue;
+                if (!gfc_spatial_hash_bounds_overlap(a->bounds,b->bounds))continue;
+                func(cell->bodies[i],cell->bodies[j],context);
+            }
+        }
+    }
+}
+
+static void gfc_spatial_hash_overlap_pair(Uint32 a,Uint32 b,void *context)
+{
+    GFC_SpatialHashOverlapContext *overlap = context;
+    if (!gfc_shape_overlap(gfc_spatial_hash_body(overlap->hash,a)->shape,gfc_spatial_hash_body(overlap->hash,b)->shape))return;
+    overlap->func(a,b,overlap->context);
+}
+
+void gfc_spatial_hash_foreach_overlap(GFC_SpatialHash2D *hash,gfc_spatial_hash_pair_func *func,void *context)
+{
+    GFC_SpatialHashOverlapContext overlap;
+    if ((!hash)||(!func))return;
+    overlap.hash = hash;
+    overlap.func = func;
+    overlap.context = context;
+    gfc_spatial_hash_foreach_pair(hash,gfc_spatial_hash_overlap_pair,&overlap);
+}
+
+/*eol@eof*/
@@ -6,11 +6,11 @@
 #include "gfc_text.h"
 #include "gfc_string.h"
 
-#define GFC_STRING_DEFAULT_LENGTH 256
+#define GFC_STRING_BUILDER_CHUNK 4096
 
 GFC_String *gfc_string_new()
 {
-    return gfc_string_new_size(GFC_STRING_DEFAULT_LENGTH);
+    return gfc_string_new_size(GFC_STRING_LOCAL_SIZE);
 }
 
 GFC_String *gfc_string_new_size(Uint32 size)
@@ -23,6 +23,12 @@ GFC_String *gfc_string_new_size(Uint32 size)
         slog("failed to allocate memory for a new GFC_String");
         return NULL;
     }
+    if (size <= GFC_STRING_LOCAL_SIZE)
+    {
+        string->buffer = string->local;
+        string->size = GFC_STRING_LOCAL_SIZE;
+        return string;
+    }
     string->buffer = gfc_allocate_array(sizeof(char),size);
     if (!string->buffer)
     {
@@ -38,24 +44,87 @@ GFC_String *gfc_string_new_size(Uint32 size)
 void gfc_string_free(GFC_String *string)
 {
     if (!string)return;
-    if (string->buffer)
+    if ((string->buffer)&&(string->buffer != string->local))
     {
         free(string->buffer);
     }
     free(string);
 }
 
+/**
+ * @brief make sure the string has room for length characters plus the null terminator
+ * @return 0 on memory error, 1 otherwise
+ */
+static int gfc_string_reserve(GFC_String *string,size_t length)
+{
+    char *buffer;
+    size_t size;
+    if (length < string->size)return 1;
+    for (size = MAX(string->size,GFC_STRING_LOCAL_SIZE) * 2;length >= size;size*=2);//make sure we can fit
+    if (string->buffer == string->local)
+    {
+        buffer = malloc(size);
+        if (buffer)memcpy(buffer,string->local,string->length + 1);
+    }
+    else buffer = realloc(string->buffer,size);
+    if (!buffer)
+    {
+        slog("failed to allocate memory to grow GFC_String");
+        return 0;
+    }
+    string->buffer = buffer;
+    string->size = size;
+    return 1;
+}
+
+static void gfc_string_append_length(GFC_String *string,const char *text,size_t length)
+{
+    if (!gfc_string_reserve(string,string->length + length))return;
+    memcpy(&string->buffer[string->length],text,length);
+    string->length += length;
+    string->buffer[string->length] = '\0';
+}
+
+/**
+ * @brief print the format onto the end of the string.  Tries to print straight into the free space,
+ * and only when that is too small grows once to the exact size and prints again
+ */
+static void gfc_string_vappendf(GFC_String *string,const char *format,va_list ap)
+{
+    int r;
+    size_t space;
+    va_list copy;
+    space = string->size - string->length;
+    va_copy(copy,ap);
+    r = vsnprintf(&string->buffer[string->length],space,format,copy);
+    va_end(copy);
+    if (r < 0)
+    {
+        slog("failed to format text for GFC_String");
+        string->buffer[string->length] = '\0';
+        return;
+    }
+    if ((size_t)r >= space)
+    {
+        if (!gfc_string_reserve(string,string->length + r))
+        {
+            string->buffer[string->length] = '\0';
+            return;
+        }
+        vsnprintf(&string->buffer[string->length],r + 1,format,ap);
+    }
+    string->length += r;
+}
+
 GFC_String *gfc_string(const char *text)
 {
     GFC_String *string;
-    Uint32 length,size;
+    size_t length;
     if (!text)return gfc_string_new();
     length = strlen(text);
-    if (!length)return gfc_string_new();
-    for (size = GFC_STRING_DEFAULT_LENGTH;length > size;size*=2);//find the needed buffer size for the string length
-    string = gfc_string_new_size(size);
+    string = gfc_string_new_size(length + 1);
     if (!string)return NULL;
-    strcpy(string->buffer,text);
+    memcpy(string->buffer,text,length + 1);
     string->length = length;
     return string;
 }
@@ -63,58 +132,28 @@ GFC_String *gfc_string(const char *text)
 char *gfc_string_get_formated_text(size_t *sizeOut,const char *format,va_list ap)
 {
     int r;
-    size_t size;
     char *buffer;
-    buffer = gfc_allocate_array(sizeof(char),GFC_STRING_DEFAULT_LENGTH);
+    va_list copy;
+    va_copy(copy,ap);
+    r = vsnprintf(NULL,0,format,copy);
+    va_end(copy);
+    if (r < 0)return NULL;
+    buffer = gfc_allocate_array(sizeof(char),r + 1);
     if (!buffer)return NULL;
-    size = GFC_STRING_DEFAULT_LENGTH;
-    while ((r = vsprintf(buffer,format,ap)) < 0)
-    {
-        size *= 2;
-        if (buffer)free(buffer);
-        buffer = gfc_allocate_array(sizeof(char),size);
-        if (!buffer)
-        {
-            return NULL;
-        }
-    }
-    if (sizeOut)*sizeOut = size;
+    vsnprintf(buffer,r + 1,format,ap);
+    if (sizeOut)*sizeOut = r + 1;
     return buffer;
 }
 
 GFC_String *gfc_stringf(const char * text,...)
 {
     va_list ap;
-    size_t size = GFC_STRING_DEFAULT_LENGTH;
-    char *buffer;
     GFC_String *string;
-    if (!text)return gfc_string_new();
-    buffer = gfc_allocate_array(sizeof(char),size);
-    if (!buffer)return NULL;
+    string = gfc_string_new();
+    if ((!string)||(!text))return string;
     va_start(ap,text);
-    while (vsprintf(buffer,text,ap) < 0)
-    {
-        size *= 2;
-        if (buffer)free(buffer);
-        buffer = gfc_allocate_array(sizeof(char),size);
-        if (!buffer)
-        {
-            return NULL;
-        }
-        va_end(ap);
-        va_start(ap,text);
-    }
+    gfc_string_vappendf(string,text,ap);
     va_end(ap);
-    string = gfc_allocate_array(sizeof(GFC_String),1);
-    if (!string)
-    {
-        slog("failed to allocated memory for GFC_String");
-        free(buffer);
-        return NULL;
-    }
-    string->buffer = buffer;
-    string->size = size;
-    string->length = strlen(buffer);
     return string;
 }
 
@@ -126,95 +165,45 @@ const char *gfc_string_text(GFC_String *string)
 
 void gfc_string_append(GFC_String *string,const char *text)
 {
-    char *buffer;
-    size_t newlength,size;
     if ((!string)||(!text))return;
-    newlength = strlen(text) + string->length;
-    for (size = string->size;newlength > size;size*=2);//make sure we can fit
-    if (size > string->size)
-    {
-        //we need to expand;
-        buffer = gfc_allocate_array(sizeof(char),size);
-        sprintf(buffer,"%s%s",string->buffer,text);
-        free(string->buffer);
-        string->buffer = buffer;
-        string->length = newlength;
-        string->size = size;
-        return;
-    }
-    buffer = &string->buffer[string->length];
-    strcpy(buffer,text);
-    string->length = newlength;
+    gfc_string_append_length(string,text,strlen(text));
 }
 
 void gfc_string_appendf(GFC_String *string,const char *format,...)
 {
     va_list ap;
-    char *buffer;
-    int size;
     if ((!format)||(!string))return;
-    
     va_start(ap, format);
-    size = vsnprintf(NULL, 0, format, ap);
+    gfc_string_vappendf(string,format,ap);
     va_end(ap);
-    
-    if (size <= 0)return;
-    
-    buffer = (char *)gfc_allocate_array(sizeof(char),size + 1);
-    
-    if (!buffer)return;
-        
-    va_start(ap, format);
-    vsprintf(buffer, format, ap);
-    va_end(ap);
-    
-    gfc_string_append(string,buffer);
-    free(buffer);
 }
 
 void gfc_string_concat(GFC_String *string,const GFC_String *add)
 {
     if ((!string)||(!add)||(!string->buffer)||(!add->buffer))return;
-    gfc_string_append(string,add->buffer);
+    gfc_string_append_length(string,add->buffer,add->length);
 }
 
 void gfc_string_prepend(GFC_String *string,const char *text)
 {
-    char *buffer;
-    size_t newlength,size;
+    size_t length;
     if ((!string)||(!text))return;
-    newlength = strlen(text) + string->length;
-    for (size = string->size;newlength > size;size*=2);//make sure we can fit
-    buffer = gfc_allocate_array(sizeof(char),size);
-    sprintf(buffer,"%s%s",text,string->buffer);
-    free(string->buffer);
-    string->buffer = buffer;
-    string->length = newlength;
-    string->size = size;
+    length = strlen(text);
+    if (!gfc_string_reserve(string,string->length + length))return;
+    memmove(&string->buffer[length],string->buffer,string->length + 1);
+    memcpy(string->buffer,text,length);
+    string->length += length;
 }
 
 void gfc_string_prependf(GFC_String *string,const char *format,...)
 {
     va_list ap;
-    size_t size = GFC_STRING_DEFAULT_LENGTH;
     char *buffer;
-    if (!format)return;
-    buffer = gfc_allocate_array(sizeof(char),size);
-    if (!buffer)return;
+    if ((!format)||(!string))return;
     va_start(ap,format);
-    while (vsprintf(buffer,format,ap) < 0)
-    {
-        size *= 2;
-        if (buffer)free(buffer);
-        buffer = gfc_allocate_array(sizeof(char),size);
-        if (!buffer)
-        {
-            return;
-        }
-        va_end(ap);
-        va_start(ap,format);
-    }
+    buffer = gfc_string_get_formated_text(NULL,format,ap);
     va_end(ap);
+    if (!buffer)return;
     gfc_string_prepend(string,buffer);
     free(buffer);
 }
@@ -243,4 +232,182 @@ int gfc_string_l_cmp(GFC_String *string1,GFC_String *string2)
     return gfc_strlcmp(string1->buffer,string2->buffer);
 }
 
+typedef struct
+{
+    size_t  used;
+    size_t  size;
+    char    text[];
+}GFC_StringChunk;
+
+static GFC_StringChunk *gfc_string_builder_add_chunk(GFC_StringBuilder *builder,size_t size)
+{
+    GFC_StringChunk *chunk;
+    size = MAX(size,GFC_STRING_BUILDER_CHUNK);
+    chunk = malloc(sizeof(GFC_StringChunk) + size);
+    if (!chunk)
+    {
+        slog("failed to allocate memory for string builder chunk");
+        return NULL;
+    }
+    chunk->used = 0;
+    chunk->size = size;
+    gfc_list_append(builder->chunks,chunk);
+    return chunk;
+}
+
+static GFC_StringChunk *gfc_string_builder_last_chunk(GFC_StringBuilder *builder)
+{
+    Uint32 c;
+    c = gfc_list_get_count(builder->chunks);
+    if (!c)return NULL;
+    return gfc_list_get_nth(builder->chunks,c - 1);
+}
+
+GFC_StringBuilder *gfc_string_builder_new()
+{
+    GFC_StringBuilder *builder;
+    builder = gfc_allocate_array(sizeof(GFC_StringBuilder),1);
+    if (!builder)return NULL;
+    builder->chunks = gfc_list_new();
+    if (!builder->chunks)
+    {
+        free(builder);
+        return NULL;
+    }
+    return builder;
+}
+
+void gfc_string_builder_free(GFC_StringBuilder *builder)
+{
+    if (!builder)return;
+    gfc_list_foreach(builder->chunks,free);
+    gfc_list_delete(builder->chunks);
+    free(builder);
+}
+
+void gfc_string_builder_clear(GFC_StringBuilder *builder)
+{
+    GFC_StringChunk *first;
+    Uint32 i,c;
+    if (!builder)return;
+    c = gfc_list_get_count(builder->chunks);
+    if (!c)return;
+    first = gfc_list_get_nth(builder->chunks,0);
+    for (i = 1;i < c;i++)
+    {
+        free(gfc_list_get_nth(builder->chunks,i));
+    }
+    gfc_list_clear(builder->chunks);
+    first->used = 0;
+    gfc_list_append(builder->chunks,first);
+    builder->length = 0;
+}
+
+void gfc_string_builder_append(GFC_StringBuilder *builder,const char *text)
+{
+    size_t length,space;
+    GFC_StringChunk *chunk;
+    if ((!builder)||(!text))return;
+    length = strlen(text);
+    chunk = gfc_string_builder_last_chunk(builder);
+    while (length)
+    {
+        if ((!chunk)||(chunk->used >= chunk->size))
+        {
+            chunk = gfc_string_builder_add_chunk(builder,length);
+            if (!chunk)return;
+        }
+        //fill whatever is left of this chunk and carry the rest over to the next
+        space = MIN(length,chunk->size - chunk->used);
+        memcpy(&chunk->text[chunk->used],text,space);
+        chunk->used += space;
+        builder->length += space;
+        text += space;
+        length -= space;
+    }
+}
+
+void gfc_string_builder_appendf(GFC_StringBuilder *builder,const char *format,...)
+{
+    int r;
+    size_t space = 0;
+    va_list ap;
+    GFC_StringChunk *chunk;
+    if ((!builder)||(!format))return;
+    chunk = gfc_string_builder_last_chunk(builder);
+    if (chunk)space = chunk->size - chunk->used;
+    //chunks are not null terminated, but vsnprintf needs room for one, so a fit means r < space
+    va_start(ap,format);
+    r = vsnprintf(chunk ? &chunk->text[chunk->used] : NULL,space,format,ap);
+    va_end(ap);
+    if (r < 0)
+    {
+        slog("failed to format text for string builder");
+        return;
+    }
+    if ((size_t)r < space)
+    {
+        chunk->used += r;
+        builder->length += r;
+        return;
+    }
+    //did not fit, print the whole thing into a fresh chunk
+    chunk = gfc_string_builder_add_chunk(builder,r + 1);
+    if (!chunk)return;
+    va_start(ap,format);
+    vsnprintf(chunk->text,chunk->size,format,ap);
+    va_end(ap);
+    chunk->used = r;
+    builder->length += r;
+}
+
+size_t gfc_string_builder_get_length(GFC_StringBuilder *builder)
+{
+    if (!builder)return 0;
+    return builder->length;
+}
+
+/**
+ * @brief copy all chunks into dst, which must have room for length + 1 characters
+ */
+static void gfc_string_builder_copy(GFC_StringBuilder *builder,char *dst)
+{
+    Uint32 i,c;
+    GFC_StringChunk *chunk;
+    c = gfc_list_get_count(builder->chunks);
+    for (i = 0;i < c;i++)
+    {
+        chunk = gfc_list_get_nth(builder->chunks,i);
+        memcpy(dst,chunk->text,chunk->used);
+        dst += chunk->used;
+    }
+    *dst = '\0';
+}
+
+char *gfc_string_builder_flatten(GFC_StringBuilder *builder,size_t *lengthOut)
+{
+    char *buffer;
+    if (!builder)return NULL;
+    buffer = malloc(builder->length + 1);
+    if (!buffer)
+    {
+        slog("failed to allocate memory to flatten string builder");
+        return NULL;
+    }
+    gfc_string_builder_copy(builder,buffer);
+    if (lengthOut)*lengthOut = builder->length;
+    return buffer;
+}
+
+GFC_String *gfc_string_builder_to_string(GFC_StringBuilder *builder)
+{
+    GFC_String *string;
+    if (!builder)return NULL;
+    string = gfc_string_new_size(builder->length + 1);
+    if (!string)return NULL;
+    gfc_string_builder_copy(builder,string->buffer);
+    string->length = builder->length;
+    return string;
+}
+
 /*eol@eof*/
@@ -2,85 +2,132 @@
 #include "simple_logger.h"
 #include "gfc_text.h"
 
-int gfc_strlcmp(const char *a,const char *b)
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+//ascii only case folding, the same rule the SSE2 path applies 16 bytes at a time
+#define gfc_ascii_lower(c) ((((c) >= 'A')&&((c) <= 'Z')) ? (c) + ('a' - 'A') : (c))
+
+#ifdef __SSE2__
+
+static inline __m128i gfc_text_lower_16(__m128i v)
 {
-    if ((!a)||(!b))return -3;
-    if (strlen(a)!=strlen(b))return -2;
-    return strcmp(a,b);
+    __m128i upper;
+    //bytes >= 0x80 are negative as signed chars, so they fall outside A-Z and are left alone
+    upper = _mm_and_si128(_mm_cmpgt_epi8(v,_mm_set1_epi8('A' - 1)),_mm_cmplt_epi8(v,_mm_set1_epi8('Z' + 1)));
+    return _mm_or_si128(v,_mm_and_si128(upper,_mm_set1_epi8('a' - 'A')));
 }
 
-int gfc_stricmp(const char *a,const char *b)
+/**
+ * @brief find the first index where a and b differ or a ends, comparing 16 bytes per step.
+ * Both lengths are found first (strnlen is itself vectorized), so the wide loads never touch a byte past
+ * either terminator.  That keeps the loads inside the strings, which ASan and valgrind both check
+ * @param fold if true, compare ignoring ascii case
+ * @param limit stop after this many characters
+ * @return the index of the first difference or terminator, or limit if none was found before it
+ */
+static size_t gfc_text_mismatch(const char *a,const char *b,size_t limit,int fold)
 {
-    int i,v = 0;
-    const char *A,*B;
-    char bufferA[1025];
-    char bufferB[1025];
-    A = a;
-    B = b;
-    do
+    size_t i = 0,span,lengthB;
+    unsigned int mask;
+    __m128i va,vb;
+    unsigned char ca,cb;
+    span = strnlen(a,limit);
+    lengthB = strnlen(b,span);
+    if (lengthB < span)span = lengthB;
+    //every byte before span is a character in both strings
+    for (;i + 16 <= span;i += 16)
     {
-        memset(bufferA,0,sizeof(bufferA));
-        memset(bufferB,0,sizeof(bufferB));
-        for (i = 0; (i < 1024) && (*B != '\0') && (*A != '\0');i++,A++,B++)
+        va = _mm_loadu_si128((const __m128i *)&a[i]);
+        vb = _mm_loadu_si128((const __m128i *)&b[i]);
+        if (fold)
         {
-            bufferA[i] = tolower(*A);
-            bufferB[i] = tolower(*B);
+            va = gfc_text_lower_16(va);
+            vb = gfc_text_lower_16(vb);
         }
-        if ((*B == '\0')||(*A == '\0'))
+        //a bit is set for every byte that differs
+        mask = ~_mm_movemask_epi8(_mm_cmpeq_epi8(va,vb)) & 0xffff;
+        if (mask)return i + __builtin_ctz(mask);
+    }
+    for (;i < span;i++)
+    {
+        ca = a[i];
+        cb = b[i];
+        if (fold)
         {
-            v = strcmp(bufferA,bufferB) + (tolower(*A) - tolower(*B));
-            return v;
+            ca = gfc_ascii_lower(ca);
+            cb = gfc_ascii_lower(cb);
         }
-        v = strcmp(bufferA,bufferB);
+        if (ca != cb)return i;
     }
-    while(v == 0);
-    return v;
+    //one of them ends here, or we reached the limit
+    return span;
 }
 
-/**
- * @brief case insensitive number string compare
- * @param a one of the strings to compare
- * @param b one of the strings to compare
- * @param n how many characters to compare
- * @returns strcmp results
- */
-int gfc_strincmp(const char *a,const char *b,int n)
+#else
+
+static size_t gfc_text_mismatch(const char *a,const char *b,size_t limit,int fold)
 {
-    int i,v = 0,c = 0;
-    const char *A,*B;
-    char bufferA[1025];
-    char bufferB[1025];
-    A = a;
-    B = b;
-    do
+    size_t i;
+    unsigned char ca,cb;
+    for (i = 0;i < limit;i++)
     {
-        memset(bufferA,0,sizeof(bufferA));
-        memset(bufferB,0,sizeof(bufferB));
-        for (i = 0; (i < 1024) && (*B != '\0') && (*A != '\0') && (c < n);i++,A++,B++,c++)
-        {
-            bufferA[i] = tolower(*A);
-            bufferB[i] = tolower(*B);
-        }
-        if ((*B == '\0')||(*A == '\0'))
+        ca = a[i];
+        cb = b[i];
+        if (fold)
         {
-            v = strcmp(bufferA,bufferB) + (tolower(*A) - tolower(*B));
-            return v;
+            ca = gfc_ascii_lower(ca);
+            cb = gfc_ascii_lower(cb);
         }
-        v = strcmp(bufferA,bufferB);
+        if ((ca != cb)||(!ca))return i;
     }
-    while((v == 0) && (c < n));
-    return v;
+    return limit;
+}
+
+#endif
+
+int gfc_strlcmp(const char *a,const char *b)
+{
+    size_t length;
+    if ((!a)||(!b))return -3;
+    //the lengths decide most calls, and once they match memcmp compares in wide blocks with no terminator checks
+    length = strlen(a);
+    if (strlen(b) != length)return -2;
+    return memcmp(a,b,length);
+}
+
+int gfc_stricmp(const char *a,const char *b)
+{
+    size_t i;
+    unsigned char ca,cb;
+    i = gfc_text_mismatch(a,b,(size_t)-1,1);
+    ca = a[i];
+    cb = b[i];
+    return gfc_ascii_lower(ca) - gfc_ascii_lower(cb);
+}
+
+int gfc_strincmp(const char *a,const char *b,int n)
+{
+    size_t i;
+    unsigned char ca,cb;
+    if (n <= 0)return 0;
+    i = gfc_text_mismatch(a,b,(size_t)n,1);
+    if (i >= (size_t)n)return 0;
+    ca = a[i];
+    cb = b[i];
+    return gfc_ascii_lower(ca) - gfc_ascii_lower(cb);
 }
 
 int gfc_str_suffix(const char *str, const char *suffix)
 {
-    // credit stack overflow
     size_t lenstr,lensuffix;
     if (!str || !suffix)
         return 0;
     lenstr = strlen(str);
     lensuffix = strlen(suffix);
     if (lensuffix >  lenstr)return 0;
-    return strncmp(str + (lenstr - lensuffix), suffix, lensuffix) == 0;
+    //lengths are known, so memcmp can compare in wide blocks without looking for terminators
+    return memcmp(str + (lenstr - lensuffix), suffix, lensuffix) == 0;
 }
 /*eol@eof*/
@@ -0,0 +1,171 @@
+#include "simple_logger.h"
+
+#include "gfc_types.h"
+#include "gfc_thread_pool.h"
+
+typedef struct
+{
+    SDL_Thread    **threads;
+    Uint32          threadCount;
+    SDL_mutex      *lock;           /**<protects the job description and the counters below*/
+    SDL_cond       *wake;           /**<signaled when a new job is posted or when closing*/
+    SDL_cond       *done;           /**<signaled when the last worker finishes a job*/
+    SDL_atomic_t    busy;           /**<1 while a job is running, so only one runs at a time*/
+    Uint32          generation;     /**<incremented for each job posted*/
+    Uint32          active;         /**<how many workers are still on the current job*/
+    Uint8           quit;
+    //the current job
+    gfc_range_func *func;
+    void           *context;
+    Uint32          count;
+    Uint32          grainSize;
+    SDL_atomic_t    next;           /**<the next index to hand out*/
+}GFC_ThreadPool;
+
+static GFC_ThreadPool thread_pool = {0};
+
+static void gfc_thread_pool_run_chunks()
+{
+    Uint32 start,end;
+    for (;;)
+    {
+        start = (Uint32)SDL_AtomicAdd(&thread_pool.next,(int)thread_pool.grainSize);
+        if (start >= thread_pool.count)return;
+        end = MIN(start + thread_pool.grainSize,thread_pool.count);
+        thread_pool.func(start,end,thread_pool.context);
+    }
+}
+
+static int gfc_thread_pool_worker(void *data)
+{
+    Uint32 seen = 0;
+    SDL_LockMutex(thread_pool.lock);
+    for (;;)
+    {
+        while ((!thread_pool.quit)&&(thread_pool.generation == seen))
+        {
+            SDL_CondWait(thread_pool.wake,thread_pool.lock);
+        }
+        if (thread_pool.quit)break;
+        seen = thread_pool.generation;
+        SDL_UnlockMutex(thread_pool.lock);
+        gfc_thread_pool_run_chunks();
+        SDL_LockMutex(thread_pool.lock);
+        thread_pool.active--;
+        if (!thread_pool.active)SDL_CondSignal(thread_pool.done);
+    }
+    SDL_UnlockMutex(thread_pool.lock);
+    return 0;
+}
+
+void gfc_thread_pool_close()
+{
+    Uint32 i;
+    if (thread_pool.threads)
+    {
+        SDL_LockMutex(thread_pool.lock);
+        thread_pool.quit = 1;
+        SDL_CondBroadcast(thread_pool.wake);
+        SDL_UnlockMutex(thread_pool.lock);
+        for (i = 0; i < thread_pool.threadCount;i++)
+        {
+            if (thread_pool.threads[i])SDL_WaitThread(thread_pool.threads[i],NULL);
+        }
+        free(thread_pool.threads);
+    }
+    if (thread_pool.wake)SDL_DestroyCond(thread_pool.wake);
+    if (thread_pool.done)SDL_DestroyCond(thread_pool.done);
+    if (thread_pool.lock)SDL_DestroyMutex(thread_pool.lock);
+    memset(&thread_pool,0,sizeof(GFC_ThreadPool));
+}
+
+void gfc_thread_pool_init(Uint32 threadCount)
+{
+    Uint32 i;
+    if (thread_pool.threads)
+    {
+        slog("thread pool already initialized");
+        return;
+    }
+    if (!threadCount)
+    {
+        threadCount = SDL_GetCPUCount() > 1 ? SDL_GetCPUCount() - 1 : 1;
+    }
+    thread_pool.lock = SDL_CreateMutex();
+    thread_pool.wake = SDL_CreateCond();
+    thread_pool.done = SDL_CreateCond();
+    thread_pool.threads = gfc_allocate_array(sizeof(SDL_Thread *),threadCount);
+    if ((!thread_pool.lock)||(!thread_pool.wake)||(!thread_pool.done)||(!thread_pool.threads))
+    {
+        slog("failed to create thread pool: %s",SDL_GetError());
+        gfc_thread_pool_close();
+        return;
+    }
+    for (i = 0; i < threadCount;i++)
+    {
+        thread_pool.threads[i] = SDL_CreateThread(gfc_thread_pool_worker,"gfc_worker",NULL);
+        if (!thread_pool.threads[i])
+        {
+            slog("failed to create worker thread: %s",SDL_GetError());
+            break;
+        }
+    }
+    thread_pool.threadCount = i;
+    if (!thread_pool.threadCount)
+    {
+        gfc_thread_pool_close();
+        return;
+    }
+    atexit(gfc_thread_pool_close);
+}
+
+Uint32 gfc_thread_pool_get_thread_count()
+{
+    return thread_pool.threadCount;
+}
+
+void gfc_thread_pool_parallel_for(Uint32 count,Uint32 grainSize,gfc_range_func *func,void *context)
+{
+    if ((!func)||(!count))return;
+    if (!grainSize)
+    {
+        //aim for a few chunks per thread so uneven work still balances
+        grainSize = MAX(count / ((thread_pool.threadCount + 1) * 4),1);
+    }
+    if ((!thread_pool.threadCount)||(count <= grainSize))
+    {
+        func(0,count,context);
+        return;
+    }
+    if (!SDL_AtomicCAS(&thread_pool.busy,0,1))
+    {
+        //another job is running, most likely we were called from inside it.  Waiting could deadlock.
+        //a mutex can't tell us this: SDL mutexes are recursive, so the thread running the job would get it again
+        func(0,count,context);
+        return;
+    }
+    SDL_LockMutex(thread_pool.lock);
+    thread_pool.func = func;
+    thread_pool.context = context;
+    thread_pool.count = count;
+    thread_pool.grainSize = grainSize;
+    SDL_AtomicSet(&thread_pool.next,0);
+    thread_pool.active = thread_pool.threadCount;
+    thread_pool.generation++;
+    SDL_CondBroadcast(thread_pool.wake);
+    SDL_UnlockMutex(thread_pool.lock);
+
+    gfc_thread_pool_run_chunks();//pitch in rather than sit idle
+
+    SDL_LockMutex(thread_pool.lock);
+    while (thread_pool.active)
+    {
+        SDL_CondWait(thread_pool.done,thread_pool.lock);
+    }
+    thread_pool.func = NULL;
+    thread_pool.context = NULL;
+    SDL_UnlockMutex(thread_pool.lock);
+    SDL_AtomicSet(&thread_pool.busy,0);
+}
+
+/*eol@eof*/
@@ -2,6 +2,13 @@
 #include <stdlib.h>
 #include <math.h>
 #include "gfc_vector.h"
+#include "gfc_simd.h"
+#include "gfc_fast_math.h"
+
+#if GFC_SIMD_ENABLED
+//the simd paths load a GFC_Vector4D straight into a register, so it must be exactly four packed floats
+typedef char gfc_vector4d_is_packed[(sizeof(GFC_Vector4D) == sizeof(float) * 4) ? 1 : -1];
+#endif
 
 GFC_Vector2D gfc_vector2i2d(GFC_Vector2I i)
 {
@@ -127,7 +134,13 @@ GFC_Vector3D gfc_vector3d_multiply(GFC_Vector3D a, GFC_Vector3D b)
 
 GFC_Vector4D gfc_vector4d_multiply(GFC_Vector4D a, GFC_Vector4D b)
 {
+#if GFC_SIMD_ENABLED
+    GFC_Vector4D out;
+    gfc_simd_store(&out.x,gfc_simd_mul(gfc_simd_load(&a.x),gfc_simd_load(&b.x)));
+    return out;
+#else
     return gfc_vector4d(a.x * b.x, a.y * b.y, a.z * b.z, a.w * b.w);
+#endif
 }
 
 Bool gfc_vector2d_distance_between_less_than(GFC_Vector2D p1,GFC_Vector2D p2,float size)
@@ -160,7 +173,7 @@ float gfc_vector3d_magnitude (GFC_Vector3D V)
 
 float gfc_vector4d_magnitude (GFC_Vector4D V)
 {
-  return sqrt (V.x * V.x + V.y * V.y + V.z * V.z + V.w * V.w);
+  return sqrt (gfc_vector4d_magnitude_squared(V));
 }
 
 float gfc_vector2d_magnitude_squared(GFC_Vector2D V)
@@ -175,7 +188,12 @@ float gfc_vector3d_magnitude_squared(GFC_Vector3D V)
 
 float gfc_vector4d_magnitude_squared(GFC_Vector4D V)
 {
+#if GFC_SIMD_ENABLED
+  GFC_Simd4f v = gfc_simd_load(&V.x);
+  return gfc_simd_dot4(v,v);
+#else
   return (V.x * V.x + V.y * V.y + V.z * V.z + V.w * V.w);
+#endif
 }
 
 void gfc_vector2d_set_magnitude(GFC_Vector2D * V,float magnitude)
@@ -279,15 +297,13 @@ int gfc_vector4d_magnitude_compare(GFC_Vector4D V,float size)
 void gfc_vector3d_set_angle_by_radians(GFC_Vector3D *out,float radians)
 {
   if(!out)return;
-  out->x = cos(radians);
-  out->y = sin(radians);
+  gfc_math_sincos(radians,&out->y,&out->x);
 }
 
 void gfc_vector4d_set_angle_by_radians(GFC_Vector4D *out,float radians)
 {
   if(!out)return;
-  out->x = cos(radians);
-  out->y = sin(radians);
+  gfc_math_sincos(radians,&out->y,&out->x);
 }
 
 GFC_Vector2D gfc_vector2d_get_normal(GFC_Vector2D v)
@@ -343,12 +359,12 @@ void gfc_vector2d_normalize (GFC_Vector2D *V)
 {
   float M;
   if (!V)return;
-  M = gfc_vector2d_magnitude (*V);
+  M = gfc_vector2d_magnitude_squared (*V);
   if (M == 0.0f)
   {
     return;
   }
-  M = 1/M;
+  M = gfc_math_rsqrt(M);
   V->x *= M;
   V->y *= M;
 }
@@ -357,12 +373,12 @@ void gfc_vector3d_normalize (GFC_Vector3D *V)
 {
   float M;
   if (!V)return;
-  M= gfc_vector3d_magnitude (*V);
+  M = gfc_vector3d_magnitude_squared (*V);
   if (M == 0.0f)
   {
     return;
   }
-  M = 1/M;
+  M = gfc_math_rsqrt(M);
   V->x *= M;
   V->y *= M;
   V->z *= M;
@@ -372,16 +388,20 @@ void gfc_vector4d_normalize (GFC_Vector4D *V)
 {
   float M;
   if (!V)return;
-  M = gfc_vector4d_magnitude (*V);
+  M = gfc_vector4d_magnitude_squared (*V);
   if (M == 0.0f)
   {
     return;
   }
-  M = 1/M;
+  M = gfc_math_rsqrt(M);
+#if GFC_SIMD_ENABLED
+  gfc_simd_store(&V->x,gfc_simd_mul(gfc_simd_load(&V->x),gfc_simd_set1(M)));
+#else
   V->x *= M;
   V->y *= M;
   V->z *= M;
   V->w *= M;
+#endif
 }
 
 GFC_Vector2D *gfc_vector2d_dup(GFC_Vector2D old)
@@ -588,10 +608,9 @@ void gfc_vector3d_rotate_about_vector(GFC_Vector3D *dst, GFC_Vector3D dir, GFC_V
   memset( zrot, 0, sizeof( zrot ) );
   zrot[0][0] = zrot[1][1] = zrot[2][2] = 1.0F;
   
-  zrot[0][0] = cos( ( degrees*GFC_DEGTORAD ) );
-  zrot[0][1] = sin( ( degrees*GFC_DEGTORAD ) );
-  zrot[1][0] = -sin( ( degrees*GFC_DEGTORAD ) );
-  zrot[1][1] = cos( ( degrees*GFC_DEGTORAD ) );
+  gfc_math_sincos(degrees*GFC_DEGTORAD,&zrot[0][1],&zrot[0][0]);
+  zrot[1][0] = -zrot[0][1];
+  zrot[1][1] = zrot[0][0];
   
   rotation_concacenate( m, zrot, tmpmat );
   rotation_concacenate( tmpmat, im, rot );
@@ -604,11 +623,13 @@ void gfc_vector3d_rotate_about_vector(GFC_Vector3D *dst, GFC_Vector3D dir, GFC_V
 void gfc_vector3d_rotate_about_x(GFC_Vector3D *vect, float angle)
 {
   GFC_Vector3D temp;
+  GFC_MathReal s,c;
   if (!vect)return;
+  gfc_math_sincos(angle,&s,&c);
 
   temp.x=vect->x;
-  temp.y=(vect->y*cos(angle))-(vect->z*sin(angle));
-  temp.z=(vect->y*sin(angle))+(vect->z*cos(angle));
+  temp.y=(vect->y*c)-(vect->z*s);
+  temp.z=(vect->y*s)+(vect->z*c);
   
   vect->x=temp.x;
   vect->y=temp.y;
@@ -618,11 +639,13 @@ void gfc_vector3d_rotate_about_x(GFC_Vector3D *vect, float angle)
 void gfc_vector3d_rotate_about_y(GFC_Vector3D *vect, float angle)
 {
   GFC_Vector3D temp;
+  GFC_MathReal s,c;
   if (!vect)return;
+  gfc_math_sincos(angle,&s,&c);
     
   temp.y=vect->y;
-  temp.x=(vect->x*cos(angle))+(vect->z*sin(angle));
-  temp.z=(vect->x*sin(angle)*(-1))+(vect->z*cos(angle));
+  temp.x=(vect->x*c)+(vect->z*s);
+  temp.z=(vect->x*s*(-1))+(vect->z*c);
   
   vect->x=temp.x;
   vect->y=temp.y;
@@ -632,11 +655,13 @@ void gfc_vector3d_rotate_about_y(GFC_Vector3D *vect, float angle)
 void gfc_vector3d_rotate_about_z(GFC_Vector3D *vect, float angle)
 {
   GFC_Vector3D temp;
+  GFC_MathReal s,c;
   if (!vect)return;
+  gfc_math_sincos(angle,&s,&c);
     
   temp.z=vect->z;
-  temp.x=(vect->x*cos(angle))-(vect->y*sin(angle));
-  temp.y=(vect->x*sin(angle))+(vect->y*cos(angle));
+  temp.x=(vect->x*c)-(vect->y*s);
+  temp.y=(vect->x*s)+(vect->y*c);
   
   vect->x=temp.x;
   vect->y=temp.y;
@@ -760,14 +785,11 @@ void gfc_vector3d_angle_vectors2(GFC_Vector3D angles, GFC_Vector3D *forward, GFC
   float sr, sp, sy, cr, cp, cy;
   
   angle = angles.z;
-  sy = sin(angle);
-  cy = cos(angle);
+  gfc_math_sincos(angle,&sy,&cy);
   angle = angles.x;
-  sp = sin(angle);
-  cp = cos(angle);
+  gfc_math_sincos(angle,&sp,&cp);
   angle = angles.y;
-  sr = sin(angle);
-  cr = cos(angle);
+  gfc_math_sincos(angle,&sr,&cr);
   
   if(forward)
   {
@@ -803,7 +825,13 @@ int gfc_vector2d_scale_flip_rotation(GFC_Vector2D scale)
 
 GFC_Vector2D gfc_vector2d_from_angle(float angle)
 {
-    return gfc_vector2d_rotate(gfc_vector2d(0,1), angle);
+    //(0,1) rotated by angle
+    GFC_Vector2D out;
+    GFC_MathReal s,c;
+    gfc_math_sincos(angle,&s,&c);
+    out.x = -s;
+    out.y = c;
+    return out;
 }
 
 GFC_Vector2D gfc_vector2d_rotate_around_center(GFC_Vector2D point,float angle, GFC_Vector2D center)
@@ -819,14 +847,16 @@ GFC_Vector2D gfc_vector2d_rotate_around_center(GFC_Vector2D point,float angle, G
 GFC_Vector2D gfc_vector2d_rotate(GFC_Vector2D in, float angle)
 {
     GFC_Vector2D out;
-    out.x = in.x * cos(angle) - in.y * sin(angle); // now x is something different than original gfc_vector x
-    out.y = in.x * sin(angle) + in.y * cos(angle);
+    GFC_MathReal s,c;
+    gfc_math_sincos(angle,&s,&c);
+    out.x = in.x * c - in.y * s; // now x is something different than original gfc_vector x
+    out.y = in.x * s + in.y * c;
     return out;
 }
 
 float gfc_vector_angle(float x,float y)
 {
-    return atan2f(y,x) + GFC_HALF_PI;
+    return gfc_math_atan2(y,x) + GFC_HALF_PI;
 }
 
 void gfc_angle_clamp_radians(float *a)
@@ -918,4 +948,148 @@ void gfc_vector3d_randomize(GFC_Vector3D *out,GFC_Vector3D in)
     out->z = in.z * gfc_crandom();
 }
 
+
+GFC_Vector3DBatch gfc_vector3d_batch(float *x,float *y,float *z)
+{
+    GFC_Vector3DBatch batch;
+    batch.x = x;
+    batch.y = y;
+    batch.z = z;
+    return batch;
+}
+
+/*
+ * The batch loops are kept to one simple statement per component so the compiler can vectorize them.
+ * Where an output component needs more than one input component, the inputs are first copied a block at a
+ * time into local arrays.  Then each loop writes one array and reads only locals and its own index, so the
+ * compiler does not have to prove the six arrays never overlap, and out may be the same arrays as an input.
+ */
+#define GFC_VECTOR_BATCH_BLOCK 64
+
+void gfc_vector3d_batch_add(GFC_Vector3DBatch out,GFC_Vector3DBatch a,GFC_Vector3DBatch b,Uint32 count)
+{
+    Uint32 i;
+    for (i = 0; i < count; i++)out.x[i] = a.x[i] + b.x[i];
+    for (i = 0; i < count; i++)out.y[i] = a.y[i] + b.y[i];
+    for (i = 0; i < count; i++)out.z[i] = a.z[i] + b.z[i];
+}
+
+void gfc_vector3d_batch_sub(GFC_Vector3DBatch out,GFC_Vector3DBatch a,GFC_Vector3DBatch b,Uint32 count)
+{
+    Uint32 i;
+    for (i = 0; i < count; i++)out.x[i] = a.x[i] - b.x[i];
+    for (i = 0; i < count; i++)out.y[i] = a.y[i] - b.y[i];
+    for (i = 0; i < count; i++)out.z[i] = a.z[i] - b.z[i];
+}
+
+void gfc_vector3d_batch_scale(GFC_Vector3DBatch out,GFC_Vector3DBatch a,float factor,Uint32 count)
+{
+    Uint32 i;
+    for (i = 0; i < count; i++)out.x[i] = a.x[i] * factor;
+    for (i = 0; i < count; i++)out.y[i] = a.y[i] * factor;
+    for (i = 0; i < count; i++)out.z[i] = a.z[i] * factor;
+}
+
+void gfc_vector3d_batch_add_scaled(GFC_Vector3DBatch out,GFC_Vector3DBatch a,GFC_Vector3DBatch b,float factor,Uint32 count)
+{
+    Uint32 i;
+    for (i = 0; i < count; i++)out.x[i] = a.x[i] + b.x[i] * factor;
+    for (i = 0; i < count; i++)out.y[i] = a.y[i] + b.y[i] * factor;
+    for (i = 0; i < count; i++)out.z[i] = a.z[i] + b.z[i] * factor;
+}
+
+void gfc_vector3d_batch_dot(float *out,GFC_Vector3DBatch a,GFC_Vector3DBatch b,Uint32 count)
+{
+    Uint32 i;
+    if (!out)return;
+    for (i = 0; i < count; i++)
+    {
+        out[i] = a.x[i] * b.x[i] + a.y[i] * b.y[i] + a.z[i] * b.z[i];
+    }
+}
+
+void gfc_vector3d_batch_cross(GFC_Vector3DBatch out,GFC_Vector3DBatch a,GFC_Vector3DBatch b,Uint32 count)
+{
+    Uint32 i,start,n;
+    float *ox,*oy,*oz;
+    float ax[GFC_VECTOR_BATCH_BLOCK],ay[GFC_VECTOR_BATCH_BLOCK],az[GFC_VECTOR_BATCH_BLOCK];
+    float bx[GFC_VECTOR_BATCH_BLOCK],by[GFC_VECTOR_BATCH_BLOCK],bz[GFC_VECTOR_BATCH_BLOCK];
+    for (start = 0; start < count; start += n)
+    {
+        n = MIN(count - start,GFC_VECTOR_BATCH_BLOCK);
+        memcpy(ax,&a.x[start],sizeof(float) * n);
+        memcpy(ay,&a.y[start],sizeof(float) * n);
+        memcpy(az,&a.z[start],sizeof(float) * n);
+        memcpy(bx,&b.x[start],sizeof(float) * n);
+        memcpy(by,&b.y[start],sizeof(float) * n);
+        memcpy(bz,&b.z[start],sizeof(float) * n);
+        ox = &out.x[start];
+        oy = &out.y[start];
+        oz = &out.z[start];
+        for (i = 0; i < n; i++)ox[i] = ay[i] * bz[i] - az[i] * by[i];
+        for (i = 0; i < n; i++)oy[i] = az[i] * bx[i] - ax[i] * bz[i];
+        for (i = 0; i < n; i++)oz[i] = ax[i] * by[i] - ay[i] * bx[i];
+    }
+}
+
+void gfc_vector3d_batch_magnitude_squared(float *out,GFC_Vector3DBatch a,Uint32 count)
+{
+    gfc_vector3d_batch_dot(out,a,a,count);
+}
+
+void gfc_vector3d_batch_magnitude(float *out,GFC_Vector3DBatch a,Uint32 count)
+{
+    Uint32 i = 0;
+#if GFC_SIMD_ENABLED && defined(GFC_SIMD_HAS_SQRT)
+    GFC_Simd4f x,y,z;
+#endif
+    if (!out)return;
+#if GFC_SIMD_ENABLED && defined(GFC_SIMD_HAS_SQRT)
+    //sqrtf sets errno, which stops the compiler vectorizing it unless built with -fno-math-errno
+    for (; i + 4 <= count; i += 4)
+    {
+        x = gfc_simd_load(&a.x[i]);
+        y = gfc_simd_load(&a.y[i]);
+        z = gfc_simd_load(&a.z[i]);
+        gfc_simd_store(&out[i],gfc_simd_sqrt(gfc_simd_madd(x,x,gfc_simd_madd(y,y,gfc_simd_mul(z,z)))));
+    }
+#endif
+    for (; i < count; i++)
+    {
+        out[i] = sqrtf(a.x[i] * a.x[i] + a.y[i] * a.y[i] + a.z[i] * a.z[i]);
+    }
+}
+
+void gfc_vector3d_batch_normalize(GFC_Vector3DBatch out,GFC_Vector3DBatch a,Uint32 count)
+{
+    Uint32 i = 0;
+    float x,y,z,m;
+#if GFC_SIMD_ENABLED && defined(GFC_SIMD_HAS_SQRT)
+    GFC_Simd4f vx,vy,vz,vm,one = gfc_simd_set1(1.0f);
+    for (; i + 4 <= count; i += 4)
+    {
+        vx = gfc_simd_load(&a.x[i]);
+        vy = gfc_simd_load(&a.y[i]);
+        vz = gfc_simd_load(&a.z[i]);
+        vm = gfc_simd_madd(vx,vx,gfc_simd_madd(vy,vy,gfc_simd_mul(vz,vz)));
+        //zero length lanes get a scale of 1 so they pass through unchanged
+        vm = gfc_simd_select_positive(vm,gfc_simd_div(one,gfc_simd_sqrt(vm)),one);
+        gfc_simd_store(&out.x[i],gfc_simd_mul(vx,vm));
+        gfc_simd_store(&out.y[i],gfc_simd_mul(vy,vm));
+        gfc_simd_store(&out.z[i],gfc_simd_mul(vz,vm));
+    }
+#endif
+    for (; i < count; i++)
+    {
+        x = a.x[i];
+        y = a.y[i];
+        z = a.z[i];
+        m = x * x + y * y + z * z;
+        m = (m > 0) ? 1.0f / sqrtf(m) : 1.0f;//zero length vectors pass through unchanged
+        out.x[i] = x * m;
+        out.y[i] = y * m;
+        out.z[i] = z * m;
+    }
+}
+
 /*eol@eof*/
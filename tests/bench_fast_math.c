@@ -0,0 +1,138 @@
+#include <string.h>
+
+#include "gfc_fast_math.h"
+#include "gfc_test.h"
+
+/**
+ * Measures the gfc_fast_ approximations against double precision libm, checks them against the error
+ * bounds documented in gfc_fast_math.h, and times them against the libm calls they replace.
+ */
+
+#define COUNT 4096
+#define ROUNDS 2000
+
+static float inputs[COUNT],inputs2[COUNT],outputs[COUNT],outputs2[COUNT];
+
+/**
+ * @brief largest relative error of gfc_fast_rsqrt over every stride'th positive normal float
+ */
+static double rsqrt_error(Uint32 stride,float *where)
+{
+    Uint32 bits;
+    float x;
+    double error,worst = 0;
+    for (bits = 0x00800000u;bits < 0x7f800000u;bits += stride)
+    {
+        memcpy(&x,&bits,sizeof(x));
+        error = fabs(gfc_fast_rsqrt(x) * sqrt((double)x) - 1.0);
+        if (error > worst)
+        {
+            worst = error;
+            *where = x;
+        }
+    }
+    return worst;
+}
+
+/**
+ * @brief largest absolute error of gfc_sincos over count evenly spaced angles in [-range,range]
+ */
+static double sincos_error(double range,Uint32 count)
+{
+    Uint32 i;
+    float x,s,c;
+    double error,worst = 0;
+    for (i = 0;i <= count;i++)
+    {
+        x = (float)(-range + 2 * range * i / count);
+        gfc_sincos(x,&s,&c);
+        error = fmax(fabs(s - sin((double)x)),fabs(c - cos((double)x)));
+        if (error > worst)worst = error;
+    }
+    return worst;
+}
+
+static double atan2_error(Uint32 count)
+{
+    Uint32 i;
+    float x,y;
+    double error,worst = 0;
+    for (i = 0;i < count;i++)
+    {
+        //points around a circle, and random ones of mixed size
+        if (i & 1)
+        {
+            x = (float)cos(i * 1e-5);
+            y = (float)sin(i * 1e-5);
+        }
+        else
+        {
+            x = gfc_test_randf(-1000,1000);
+            y = gfc_test_randf(-1000,1000);
+        }
+        error = fabs(gfc_fast_atan2(y,x) - atan2((double)y,(double)x));
+        if (error > worst)worst = error;
+    }
+    return worst;
+}
+
+#define TIME_ROUNDS(result,body) do {\
+    double start = gfc_test_seconds();\
+    int r,k;\
+    for (r = 0;r < ROUNDS;r++)\
+    {\
+        for (k = 0;k < COUNT;k++)\
+        {\
+            body;\
+        }\
+        gfc_test_barrier();\
+    }\
+    result = (gfc_test_seconds() - start) * 1e9 / ((double)ROUNDS * COUNT);\
+} while (0)
+
+int main(int argc,char *argv[])
+{
+    double error,libmTime,floatTime,fastTime;
+    float where = 0;
+    int i;
+
+    printf("max error against double libm:\n");
+    error = rsqrt_error(7,&where);
+#ifdef GFC_FAST_MATH_SSE
+    printf("  rsqrt   %.3g relative (SSE), worst at x = %g\n",error,where);
+    gfc_test_check(error <= 3e-7,"gfc_fast_rsqrt error %g is over the documented 3e-7",error);
+#else
+    printf("  rsqrt   %.3g relative (portable), worst at x = %g\n",error,where);
+    gfc_test_check(error <= 5e-6,"gfc_fast_rsqrt error %g is over the documented 5e-6",error);
+#endif
+    error = sincos_error(1000,20000000);
+    printf("  sincos  %.3g absolute for |x| <= 1000\n",error);
+    gfc_test_check(error <= 1e-7,"gfc_sincos error %g is over the documented 1e-7",error);
+    error = sincos_error(1e5,20000000);
+    printf("  sincos  %.3g absolute for |x| <= 1e5\n",error);
+    gfc_test_check(error <= 1e-6,"gfc_sincos error %g is over the documented 1e-6",error);
+    error = atan2_error(4000000);
+    printf("  atan2   %.3g absolute\n",error);
+    gfc_test_check(error <= 2e-6,"gfc_fast_atan2 error %g is over the documented 2e-6",error);
+
+    for (i = 0;i < COUNT;i++)
+    {
+        inputs[i] = gfc_test_randf(-10,10);
+        inputs2[i] = gfc_test_randf(-10,10);
+    }
+    printf("ns per call: double libm, float libm, gfc_fast\n");
+    TIME_ROUNDS(libmTime,outputs[k] = sin(inputs[k]);outputs2[k] = cos(inputs[k]));
+    TIME_ROUNDS(floatTime,outputs[k] = sinf(inputs[k]);outputs2[k] = cosf(inputs[k]));
+    TIME_ROUNDS(fastTime,gfc_sincos(inputs[k],&outputs[k],&outputs2[k]));
+    printf("  sin+cos %6.2f %6.2f %6.2f\n",libmTime,floatTime,fastTime);
+    TIME_ROUNDS(libmTime,outputs[k] = atan2(inputs[k],inputs2[k]));
+    TIME_ROUNDS(floatTime,outputs[k] = atan2f(inputs[k],inputs2[k]));
+    TIME_ROUNDS(fastTime,outputs[k] = gfc_fast_atan2(inputs[k],inputs2[k]));
+    printf("  atan2   %6.2f %6.2f %6.2f\n",libmTime,floatTime,fastTime);
+    for (i = 0;i < COUNT;i++)inputs[i] = fabsf(inputs[i]) + 0.01f;
+    TIME_ROUNDS(libmTime,outputs[k] = 1.0 / sqrt(inputs[k]));
+    TIME_ROUNDS(floatTime,outputs[k] = 1.0f / sqrtf(inputs[k]));
+    TIME_ROUNDS(fastTime,outputs[k] = gfc_fast_rsqrt(inputs[k]));
+    printf("  1/sqrt  %6.2f %6.2f %6.2f\n",libmTime,floatTime,fastTime);
+    return gfc_test_result("bench_fast_math");
+}
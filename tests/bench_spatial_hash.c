@@ -0,0 +1,251 @@
+#include <string.h>
+
+#include "gfc_spatial_hash.h"
+#include "gfc_test.h"
+
+/**
+ * Checks GFC_SpatialHash2D queries and pairs against testing every body against every other over random
+ * inserts, moves and removes, checks that a travelling body does not leave cells behind, then times moving
+ * and pairing 10k small circles, the case the hash is built for.
+ */
+
+#define BODY_COUNT 2000
+#define STEPS 20
+#define WORLD 1000
+
+static Uint32 handles[BODY_COUNT];
+static GFC_Shape shapes[BODY_COUNT];
+static Uint8 alive[BODY_COUNT];
+static Uint8 *seen;     /**<BODY_COUNT * BODY_COUNT flags for the pairs reported this step*/
+static int pairCount,badPairs;
+
+static GFC_Shape random_shape()
+{
+    float x,y;
+    switch (gfc_test_rand() % 3)
+    {
+        case 0:
+            return gfc_shape_rect(gfc_test_randf(0,WORLD),gfc_test_randf(0,WORLD),gfc_test_randf(0,20),gfc_test_randf(0,20));
+        case 1:
+            return gfc_shape_circle(gfc_test_randf(0,WORLD),gfc_test_randf(0,WORLD),gfc_test_randf(0,10));
+        default:
+            x = gfc_test_randf(0,WORLD);
+            y = gfc_test_randf(0,WORLD);
+            return gfc_shape_edge(x,y,x + gfc_test_randf(-15,15),y + gfc_test_randf(-15,15));
+    }
+}
+
+/**
+ * @brief find which of our bodies a handle belongs to
+ * @return -1 if none of the live ones
+ */
+static int body_index(Uint32 handle)
+{
+    int i;
+    for (i = 0;i < BODY_COUNT;i++)
+    {
+        if ((alive[i])&&(handles[i] == handle))return i;
+    }
+    return -1;
+}
+
+static void record_pair(Uint32 a,Uint32 b,void *context)
+{
+    int i = body_index(a),j = body_index(b),t;
+    if ((i < 0)||(j < 0)||(i == j))
+    {
+        badPairs++;
+        return;
+    }
+    if (i > j)
+    {
+        t = i;
+        i = j;
+        j = t;
+    }
+    if (seen[i * BODY_COUNT + j])badPairs++;
+    seen[i * BODY_COUNT + j] = 1;
+    pairCount++;
+}
+
+static void count_pair(Uint32 a,Uint32 b,void *context)
+{
+    (*(int *)context)++;
+}
+
+static void check_queries(GFC_SpatialHash2D *hash)
+{
+    static Uint32 found[BODY_COUNT];
+    Uint8 got[BODY_COUNT];
+    GFC_Shape query;
+    Uint32 n;
+    int i,j,k;
+    for (j = 0;j < 50;j++)
+    {
+        memset(got,0,sizeof(got));
+        if (j & 1)
+        {
+            query = gfc_shape_rect(gfc_test_randf(0,WORLD),gfc_test_randf(0,WORLD),gfc_test_randf(0,300),gfc_test_randf(0,300));
+            n = gfc_spatial_hash_query_rect(hash,query.s.r,found,BODY_COUNT);
+        }
+        else
+        {
+            query = gfc_shape_circle(gfc_test_randf(0,WORLD),gfc_test_randf(0,WORLD),gfc_test_randf(0,200));
+            n = gfc_spatial_hash_query_circle(hash,query.s.c,found,BODY_COUNT);
+        }
+        for (i = 0;i < (int)n;i++)
+        {
+            k = body_index(found[i]);
+            gfc_test_check((k >= 0)&&(!got[k]),"query %i gave a bad or repeated handle %u",j,found[i]);
+            if (k >= 0)got[k] = 1;
+        }
+        for (i = 0;i < BODY_COUNT;i++)
+        {
+            if (!alive[i])continue;
+            gfc_test_check((gfc_shape_overlap(query,shapes[i]) ? 1 : 0) == got[i],"query %i, body %i",j,i);
+        }
+    }
+    //a query far bigger than the occupied cells
+    query = gfc_shape_rect(-1e6,-1e6,2e6,2e6);
+    n = gfc_spatial_hash_query_rect(hash,query.s.r,found,BODY_COUNT);
+    for (i = 0,k = 0;i < BODY_COUNT;i++)
+    {
+        if ((alive[i])&&(gfc_shape_overlap(query,shapes[i])))k++;
+    }
+    gfc_test_check((int)n == k,"huge query found %u of %i",n,k);
+}
+
+static void check_pairs(GFC_SpatialHash2D *hash)
+{
+    int i,j,want = 0;
+    memset(seen,0,BODY_COUNT * BODY_COUNT);
+    pairCount = badPairs = 0;
+    gfc_spatial_hash_foreach_overlap(hash,record_pair,NULL);
+    gfc_test_check(badPairs == 0,"%i bad or repeated pairs",badPairs);
+    for (i = 0;i < BODY_COUNT;i++)
+    {
+        if (!alive[i])continue;
+        for (j = i + 1;j < BODY_COUNT;j++)
+        {
+            if ((!alive[j])||(!gfc_shape_overlap(shapes[i],shapes[j])))continue;
+            want++;
+            gfc_test_check(seen[i * BODY_COUNT + j],"missed pair %i %i",i,j);
+        }
+    }
+    gfc_test_check(want == pairCount,"found %i pairs, want %i",pairCount,want);
+}
+
+static void check_against_brute_force()
+{
+    GFC_SpatialHash2D *hash = gfc_spatial_hash_new(25);
+    GFC_Vector2D move;
+    int i,step;
+    seen = malloc(BODY_COUNT * BODY_COUNT);
+    for (i = 0;i < BODY_COUNT;i++)
+    {
+        shapes[i] = random_shape();
+        handles[i] = gfc_spatial_hash_insert(hash,shapes[i],(void *)(size_t)(i + 1));
+        alive[i] = 1;
+    }
+    for (step = 0;step < STEPS;step++)
+    {
+        for (i = 0;i < BODY_COUNT;i++)
+        {
+            if (gfc_test_rand() % 10 == 0)
+            {
+                if (alive[i])
+                {
+                    gfc_spatial_hash_remove(hash,handles[i]);
+                    alive[i] = 0;
+                }
+                else
+                {
+                    shapes[i] = random_shape();
+                    handles[i] = gfc_spatial_hash_insert(hash,shapes[i],(void *)(size_t)(i + 1));
+                    alive[i] = 1;
+                }
+            }
+            else if (alive[i])
+            {
+                move = gfc_vector2d(gfc_test_randf(-20,20),gfc_test_randf(-20,20));
+                gfc_spatial_hash_move(hash,handles[i],move);
+                gfc_shape_move(&shapes[i],move);
+            }
+        }
+        for (i = 0;i < BODY_COUNT;i++)
+        {
+            if (!alive[i])continue;
+            gfc_test_check(gfc_spatial_hash_get_data(hash,handles[i]) == (void *)(size_t)(i + 1),"data of body %i",i);
+        }
+        check_queries(hash);
+        check_pairs(hash);
+    }
+    gfc_spatial_hash_clear(hash);
+    gfc_test_check(gfc_spatial_hash_get_count(hash) == 0,"count after clear");
+    gfc_spatial_hash_free(hash);
+    free(seen);
+}
+
+/**
+ * @brief a body that travels must not leave the cells it passed through in the grid
+ */
+static void check_travel()
+{
+    GFC_SpatialHash2D *hash = gfc_spatial_hash_new(1);
+    Uint32 a,b;
+    int i;
+    a = gfc_spatial_hash_insert(hash,gfc_shape_circle(0.5,0.5,0.2),NULL);
+    b = gfc_spatial_hash_insert(hash,gfc_shape_circle(0.5,0.5,0.2),NULL);
+    for (i = 0;i < 100000;i++)gfc_spatial_hash_move(hash,a,gfc_vector2d(0.37,0.11));
+    gfc_test_check(gfc_list_get_count(hash->cellList) <= 8,"%u cells left after travelling",gfc_list_get_count(hash->cellList));
+    gfc_test_check(gfc_intmap_get_count(hash->cells) == gfc_list_get_count(hash->cellList),"cell map and list disagree");
+    gfc_spatial_hash_remove(hash,a);
+    gfc_spatial_hash_remove(hash,b);
+    gfc_test_check(gfc_list_get_count(hash->cellList) == 0,"%u cells left when empty",gfc_list_get_count(hash->cellList));
+    gfc_test_check(gfc_intmap_get_count(hash->cells) == 0,"cell map not empty");
+    gfc_spatial_hash_free(hash);
+}
+
+#define MOVING_COUNT 10000
+#define FRAMES 100
+
+static void time_moving_circles()
+{
+    GFC_SpatialHash2D *hash = gfc_spatial_hash_new(16);
+    Uint32 *bodies = malloc(sizeof(Uint32) * MOVING_COUNT);
+    GFC_Vector2D *moves = malloc(sizeof(GFC_Vector2D) * MOVING_COUNT);
+    double start,moveTime = 0,pairTime = 0;
+    int i,frame,pairs = 0;
+    for (i = 0;i < MOVING_COUNT;i++)
+    {
+        bodies[i] = gfc_spatial_hash_insert(hash,gfc_shape_circle(gfc_test_randf(0,2000),gfc_test_randf(0,2000),4),NULL);
+        moves[i] = gfc_vector2d(gfc_test_randf(-1,1),gfc_test_randf(-1,1));
+    }
+    for (frame = 0;frame < FRAMES;frame++)
+    {
+        start = gfc_test_seconds();
+        for (i = 0;i < MOVING_COUNT;i++)
+        {
+            gfc_spatial_hash_move(hash,bodies[i],(frame & 1) ? gfc_vector2d(-moves[i].x,-moves[i].y) : moves[i]);
+        }
+        moveTime += gfc_test_seconds() - start;
+        start = gfc_test_seconds();
+        pairs = 0;
+        gfc_spatial_hash_foreach_pair(hash,count_pair,&pairs);
+        pairTime += gfc_test_seconds() - start;
+    }
+    printf("%i radius 4 circles, 16 unit cells, ms per frame:\n",MOVING_COUNT);
+    printf("  move all %6.3f\n",moveTime * 1000 / FRAMES);
+    printf("  pairs    %6.3f (%i pairs)\n",pairTime * 1000 / FRAMES,pairs);
+    free(moves);
+    free(bodies);
+    gfc_spatial_hash_free(hash);
+}
+
+int main(int argc,char *argv[])
+{
+    check_against_brute_force();
+    check_travel();
+    time_moving_circles();
+    return gfc_test_result("bench_spatial_hash");
+}
@@ -0,0 +1,214 @@
+#include <ctype.h>
+#include <string.h>
+
+#include "gfc_text.h"
+#include "gfc_test.h"
+
+/**
+ * Benchmarks gfc_strlcmp, gfc_stricmp, gfc_strincmp and gfc_str_suffix against the byte loop versions they
+ * replaced, on identifier sized strings, and checks their results against a plain reference.
+ * Every string is its own exact size heap allocation, so building with -fsanitize=address catches any read
+ * past a terminator.
+ */
+
+#define NAME_COUNT 256
+#define ROUNDS 4000
+
+/*the versions before the SSE2 rewrite, kept here only to time against*/
+
+static int old_strlcmp(const char *a,const char *b)
+{
+    if ((!a)||(!b))return -3;
+    if (strlen(a)!=strlen(b))return -2;
+    return strcmp(a,b);
+}
+
+static int old_strincmp(const char *a,const char *b,int n)
+{
+    int i,v = 0,c = 0;
+    const char *A,*B;
+    char bufferA[1025];
+    char bufferB[1025];
+    A = a;
+    B = b;
+    do
+    {
+        memset(bufferA,0,sizeof(bufferA));
+        memset(bufferB,0,sizeof(bufferB));
+        for (i = 0; (i < 1024) && (*B != '\0') && (*A != '\0') && (c < n);i++,A++,B++,c++)
+        {
+            bufferA[i] = tolower(*A);
+            bufferB[i] = tolower(*B);
+        }
+        if ((*B == '\0')||(*A == '\0'))
+        {
+            v = strcmp(bufferA,bufferB) + (tolower(*A) - tolower(*B));
+            return v;
+        }
+        v = strcmp(bufferA,bufferB);
+    }
+    while((v == 0) && (c < n));
+    return v;
+}
+
+static int old_stricmp(const char *a,const char *b)
+{
+    return old_strincmp(a,b,0x7fffffff);
+}
+
+static int old_str_suffix(const char *str, const char *suffix)
+{
+    size_t lenstr,lensuffix;
+    if (!str || !suffix)
+        return 0;
+    lenstr = strlen(str);
+    lensuffix = strlen(suffix);
+    if (lensuffix >  lenstr)return 0;
+    return strncmp(str + (lenstr - lensuffix), suffix, lensuffix) == 0;
+}
+
+/*plain references for the results*/
+
+static int sign(int v)
+{
+    return (v > 0) - (v < 0);
+}
+
+static int ref_strincmp(const char *a,const char *b,size_t n)
+{
+    size_t i;
+    int ca,cb;
+    for (i = 0;i < n;i++)
+    {
+        ca = tolower((unsigned char)a[i]);
+        cb = tolower((unsigned char)b[i]);
+        if ((ca != cb)||(!ca))return ca - cb;
+    }
+    return 0;
+}
+
+static char *names[NAME_COUNT];
+static char *others[NAME_COUNT];
+
+/**
+ * @brief make a random identifier of the given length in an exact size allocation
+ */
+static char *make_name(size_t length)
+{
+    static const char chars[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_./";
+    size_t i;
+    char *name = malloc(length + 1);
+    for (i = 0;i < length;i++)name[i] = chars[gfc_test_rand() % (sizeof(chars) - 1)];
+    name[length] = '\0';
+    return name;
+}
+
+/**
+ * @brief make a string to compare name against: an exact match, a case flipped match, a late mismatch, or
+ * a shorter or longer string, as lookups meet them
+ */
+static char *make_other(const char *name)
+{
+    size_t i,length = strlen(name);
+    char *other;
+    switch (gfc_test_rand() % 5)
+    {
+        case 0:
+            other = strdup(name);
+            break;
+        case 1:
+            other = strdup(name);
+            for (i = 0;i < length;i++)
+            {
+                if (gfc_test_rand() & 1)other[i] = isupper((unsigned char)other[i]) ? tolower((unsigned char)other[i]) : toupper((unsigned char)other[i]);
+            }
+            break;
+        case 2:
+            other = strdup(name);
+            if (length)other[length - 1] = (other[length - 1] == 'x') ? 'y' : 'x';
+            break;
+        case 3:
+            other = strdup(name);
+            if (length)other[length - 1] = '\0';
+            break;
+        default:
+            other = malloc(length + 3);
+            memcpy(other,name,length);
+            memcpy(other + length,"_2",3);
+            break;
+    }
+    return other;
+}
+
+static void check_results()
+{
+    int i,n;
+    size_t la,lb;
+    for (i = 0;i < NAME_COUNT;i++)
+    {
+        la = strlen(names[i]);
+        lb = strlen(others[i]);
+        gfc_test_check(sign(gfc_stricmp(names[i],others[i])) == sign(ref_strincmp(names[i],others[i],(size_t)-1)),
+            "gfc_stricmp(\"%s\",\"%s\")",names[i],others[i]);
+        for (n = 0;n <= (int)la + 1;n += 3)
+        {
+            gfc_test_check(sign(gfc_strincmp(names[i],others[i],n)) == sign(ref_strincmp(names[i],others[i],n)),
+                "gfc_strincmp(\"%s\",\"%s\",%i)",names[i],others[i],n);
+        }
+        if (la != lb)gfc_test_check(gfc_strlcmp(names[i],others[i]) == -2,"gfc_strlcmp(\"%s\",\"%s\")",names[i],others[i]);
+        else gfc_test_check(sign(gfc_strlcmp(names[i],others[i])) == sign(strcmp(names[i],others[i])),
+            "gfc_strlcmp(\"%s\",\"%s\")",names[i],others[i]);
+        gfc_test_check(gfc_str_suffix(names[i],others[i] + (lb / 2)) == old_str_suffix(names[i],others[i] + (lb / 2)),
+            "gfc_str_suffix(\"%s\",\"%s\")",names[i],others[i] + (lb / 2));
+    }
+}
+
+#define TIME_CALLS(result,call) do {\
+    double start = gfc_test_seconds();\
+    int r,k;\
+    for (r = 0;r < ROUNDS;r++)\
+    {\
+        for (k = 0;k < NAME_COUNT;k++)sink += call;\
+        gfc_test_barrier();\
+    }\
+    result = (gfc_test_seconds() - start) * 1e9 / ((double)ROUNDS * NAME_COUNT);\
+} while (0)
+
+int main(int argc,char *argv[])
+{
+    static const size_t lengths[] = {4,8,16,24,32,64};
+    volatile int sink = 0;
+    double oldTime,newTime;
+    size_t l;
+    int i;
+    printf("ns per call, old byte loop -> current\n");
+    printf("%6s %18s %18s %18s %18s\n","length","strlcmp","stricmp","strincmp(16)","str_suffix");
+    for (l = 0;l < sizeof(lengths) / sizeof(lengths[0]);l++)
+    {
+        for (i = 0;i < NAME_COUNT;i++)
+        {
+            names[i] = make_name(lengths[l]);
+            others[i] = make_other(names[i]);
+        }
+        check_results();
+        printf("%6zu",lengths[l]);
+        TIME_CALLS(oldTime,old_strlcmp(names[k],others[k]));
+        TIME_CALLS(newTime,gfc_strlcmp(names[k],others[k]));
+        printf("   %6.1f -> %6.1f",oldTime,newTime);
+        TIME_CALLS(oldTime,old_stricmp(names[k],others[k]));
+        TIME_CALLS(newTime,gfc_stricmp(names[k],others[k]));
+        printf("   %6.1f -> %6.1f",oldTime,newTime);
+        TIME_CALLS(oldTime,old_strincmp(names[k],others[k],16));
+        TIME_CALLS(newTime,gfc_strincmp(names[k],others[k],16));
+        printf("   %6.1f -> %6.1f",oldTime,newTime);
+        TIME_CALLS(oldTime,old_str_suffix(names[k],others[k] + 1));
+        TIME_CALLS(newTime,gfc_str_suffix(names[k],others[k] + 1));
+        printf("   %6.1f -> %6.1f\n",oldTime,newTime);
+        for (i = 0;i < NAME_COUNT;i++)
+        {
+            free(names[i]);
+            free(others[i]);
+        }
+    }
+    return gfc_test_result("bench_text");
+}
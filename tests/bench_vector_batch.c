@@ -0,0 +1,109 @@
+#include <float.h>
+
+#include "gfc_vector.h"
+#include "gfc_matrix.h"
+#include "gfc_test.h"
+
+/**
+ * Times the gfc_vector3d_batch_ kernels against calling the one vector functions in a loop over an array of
+ * GFC_Vector3D, the way particle code did before, and checks both give the same answers.
+ */
+
+#define COUNT 16384
+#define ROUNDS 200
+
+static GFC_Vector3D points[COUNT],others[COUNT],results[COUNT];
+static float x[COUNT],y[COUNT],z[COUNT],ox[COUNT],oy[COUNT],oz[COUNT],bx[COUNT],by[COUNT],bz[COUNT];
+static float scalars[COUNT],batchScalars[COUNT];
+
+static int close_to(float got,float want)
+{
+    return fabsf(got - want) <= 1e-5f * (fabsf(want) + 1.0f);
+}
+
+static void reset_batch()
+{
+    int i;
+    for (i = 0;i < COUNT;i++)
+    {
+        x[i] = points[i].x;
+        y[i] = points[i].y;
+        z[i] = points[i].z;
+    }
+}
+
+#define TIME_ROUNDS(result,body) do {\
+    double start = gfc_test_seconds();\
+    int r;\
+    for (r = 0;r < ROUNDS;r++)\
+    {\
+        body;\
+        gfc_test_barrier();\
+    }\
+    result = (gfc_test_seconds() - start) * 1e6 / ROUNDS;\
+} while (0)
+
+int main(int argc,char *argv[])
+{
+    GFC_Vector3DBatch in = {x,y,z},out = {ox,oy,oz},b = {bx,by,bz};
+    GFC_Matrix4 mat;
+    GFC_Vector4D v4;
+    double loopTime,batchTime;
+    int i,j;
+    for (i = 0;i < COUNT;i++)
+    {
+        points[i] = gfc_vector3d(gfc_test_randf(-100,100),gfc_test_randf(-100,100),gfc_test_randf(-100,100));
+        others[i] = gfc_vector3d(gfc_test_randf(-100,100),gfc_test_randf(-100,100),gfc_test_randf(-100,100));
+        bx[i] = others[i].x;
+        by[i] = others[i].y;
+        bz[i] = others[i].z;
+    }
+    for (i = 0;i < 4;i++)
+    {
+        for (j = 0;j < 4;j++)mat[i][j] = gfc_test_randf(-2,2);
+    }
+    reset_batch();
+    printf("microseconds for %i vectors, per element calls -> batch kernel\n",COUNT);
+
+    TIME_ROUNDS(loopTime,for (i = 0;i < COUNT;i++)scalars[i] = gfc_vector3d_magnitude(points[i]));
+    TIME_ROUNDS(batchTime,gfc_vector3d_batch_magnitude(batchScalars,in,COUNT));
+    printf("  magnitude  %8.1f -> %8.1f\n",loopTime,batchTime);
+    for (i = 0;i < COUNT;i++)gfc_test_check(close_to(batchScalars[i],scalars[i]),"magnitude [%i]",i);
+
+    TIME_ROUNDS(loopTime,for (i = 0;i < COUNT;i++)scalars[i] = gfc_vector3d_dot_product(points[i],others[i]));
+    TIME_ROUNDS(batchTime,gfc_vector3d_batch_dot(batchScalars,in,b,COUNT));
+    printf("  dot        %8.1f -> %8.1f\n",loopTime,batchTime);
+    for (i = 0;i < COUNT;i++)gfc_test_check(close_to(batchScalars[i],scalars[i]),"dot [%i]",i);
+
+    TIME_ROUNDS(loopTime,for (i = 0;i < COUNT;i++)gfc_vector3d_cross_product(&results[i],points[i],others[i]));
+    TIME_ROUNDS(batchTime,gfc_vector3d_batch_cross(out,in,b,COUNT));
+    printf("  cross      %8.1f -> %8.1f\n",loopTime,batchTime);
+    for (i = 0;i < COUNT;i++)
+    {
+        gfc_test_check(close_to(ox[i],results[i].x)&&close_to(oy[i],results[i].y)&&close_to(oz[i],results[i].z),"cross [%i]",i);
+    }
+
+    TIME_ROUNDS(loopTime,for (i = 0;i < COUNT;i++){results[i] = points[i];gfc_vector3d_normalize(&results[i]);});
+    TIME_ROUNDS(batchTime,gfc_vector3d_batch_normalize(out,in,COUNT));
+    printf("  normalize  %8.1f -> %8.1f\n",loopTime,batchTime);
+    for (i = 0;i < COUNT;i++)
+    {
+        gfc_test_check(close_to(ox[i],results[i].x)&&close_to(oy[i],results[i].y)&&close_to(oz[i],results[i].z),"normalize [%i]",i);
+    }
+
+    TIME_ROUNDS(loopTime,for (i = 0;i < COUNT;i++)
+    {
+        gfc_matrix4_v_multiply(&v4,gfc_vector4d(points[i].x,points[i].y,points[i].z,1),mat);
+        results[i] = gfc_vector3d(v4.x,v4.y,v4.z);
+    });
+    TIME_ROUNDS(batchTime,gfc_vector3d_batch_transform(out,in,mat,COUNT));
+    printf("  transform  %8.1f -> %8.1f\n",loopTime,batchTime);
+    for (i = 0;i < COUNT;i++)
+    {
+        gfc_test_check(close_to(ox[i],results[i].x)&&close_to(oy[i],results[i].y)&&close_to(oz[i],results[i].z),"transform [%i]",i);
+    }
+    //in place use must give the same answer
+    gfc_vector3d_batch_transform(in,in,mat,COUNT);
+    for (i = 0;i < COUNT;i++)gfc_test_check((x[i] == ox[i])&&(y[i] == oy[i])&&(z[i] == oz[i]),"transform in place [%i]",i);
+    return gfc_test_result("bench_vector_batch");
+}
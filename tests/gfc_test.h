@@ -0,0 +1,87 @@
+#ifndef __GFC_TEST_H__
+#define __GFC_TEST_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "gfc_types.h"
+
+/**
+ * @purpose small helpers shared by the programs in tests/: a timer, a repeatable random source and a check
+ * that counts failures.  Each program is standalone, prints what it measured and returns non zero if any
+ * check failed, so `make test` stops on the first broken one.
+ */
+
+static int gfc_test_failures = 0;
+
+/**
+ * @brief record a failure, with where it happened, if the condition is false
+ */
+#define gfc_test_check(cond,...) do {\
+    if (!(cond))\
+    {\
+        gfc_test_failures++;\
+        if (gfc_test_failures <= 10)\
+        {\
+            printf("%s:%i: check failed: ",__FILE__,__LINE__);\
+            printf(__VA_ARGS__);\
+            printf("\n");\
+        }\
+    }\
+} while (0)
+
+/**
+ * @brief print the pass or fail line and give the exit code for main
+ */
+static inline int gfc_test_result(const char *name)
+{
+    if (gfc_test_failures)
+    {
+        printf("%s: FAILED, %i checks\n",name,gfc_test_failures);
+        return 1;
+    }
+    printf("%s: ok\n",name);
+    return 0;
+}
+
+/**
+ * @brief seconds since some fixed point, for timing
+ */
+static inline double gfc_test_seconds()
+{
+    return (double)SDL_GetPerformanceCounter() / (double)SDL_GetPerformanceFrequency();
+}
+
+/**
+ * @brief stop the compiler from moving memory accesses across this point, so a timed loop whose results go
+ * unread is not hoisted out or merged with the next round
+ */
+#if defined(__GNUC__)
+#define gfc_test_barrier() __asm__ __volatile__("" ::: "memory")
+#else
+#define gfc_test_barrier()
+#endif
+
+static Uint32 gfc_test_seed = 0x9E3779B9;
+
+/**
+ * @brief a repeatable xorshift random number, so every run tests the same inputs
+ */
+static inline Uint32 gfc_test_rand()
+{
+    gfc_test_seed ^= gfc_test_seed << 13;
+    gfc_test_seed ^= gfc_test_seed >> 17;
+    gfc_test_seed ^= gfc_test_seed << 5;
+    return gfc_test_seed;
+}
+
+/**
+ * @brief a random float between low and high
+ */
+static inline float gfc_test_randf(float low,float high)
+{
+    return low + (high - low) * (float)(gfc_test_rand() & 0xffffff) / (float)0xffffff;
+}
+
+#endif
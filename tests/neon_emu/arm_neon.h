@@ -0,0 +1,80 @@
+#ifndef __GFC_TEST_ARM_NEON_H__
+#define __GFC_TEST_ARM_NEON_H__
+
+/**
+ * @purpose a plain C stand in for <arm_neon.h>, covering only the intrinsics gfc_simd.h uses, so the NEON
+ * path can be compiled and run on an x86 host where no arm compiler is available (see test_simd_neon_emu in
+ * the Makefile).  The types are gcc vector types, so mixing float and integer vectors is an error as it is
+ * with the real header, lane numbers must be constants, and vsqrtq_f32 / vdivq_f32 only exist on aarch64.
+ * The semantics follow the Arm C Language Extensions.  It is no substitute for a real cross compile
+ * (make cross), it only catches mistakes that would also break one.
+ */
+
+#include <math.h>
+#include <string.h>
+
+typedef float float32_t;
+typedef float float32x2_t __attribute__((vector_size(8)));
+typedef float float32x4_t __attribute__((vector_size(16)));
+typedef unsigned int uint32x4_t __attribute__((vector_size(16)));
+
+typedef struct
+{
+    float32x4_t val[2];
+}float32x4x2_t;
+
+//the lane must be a constant 0 to 3, a bit field width has to be a constant expression so this will not compile otherwise
+#define gfc_neon_emu_lane(lane,count) ((void)sizeof(struct {int check:(((lane) >= 0)&&((lane) < (count))) ? 1 : -1;}))
+
+static inline float32x4_t vld1q_f32(const float32_t *p){float32x4_t v;memcpy(&v,p,sizeof(v));return v;}
+static inline void vst1q_f32(float32_t *p,float32x4_t v){memcpy(p,&v,sizeof(v));}
+static inline float32x4_t vdupq_n_f32(float32_t f){float32x4_t v = {f,f,f,f};return v;}
+static inline float32x4_t vaddq_f32(float32x4_t a,float32x4_t b){return a + b;}
+static inline float32x4_t vsubq_f32(float32x4_t a,float32x4_t b){return a - b;}
+static inline float32x4_t vmulq_f32(float32x4_t a,float32x4_t b){return a * b;}
+static inline float32x4_t vmlaq_f32(float32x4_t a,float32x4_t b,float32x4_t c){return a + b * c;}
+static inline float32x2_t vadd_f32(float32x2_t a,float32x2_t b){return a + b;}
+
+#define vgetq_lane_f32(v,lane) (gfc_neon_emu_lane(lane,4),(v)[(lane)])
+#define vget_lane_f32(v,lane) (gfc_neon_emu_lane(lane,2),(v)[(lane)])
+
+static inline float32x2_t vget_low_f32(float32x4_t v){float32x2_t r = {v[0],v[1]};return r;}
+static inline float32x2_t vget_high_f32(float32x4_t v){float32x2_t r = {v[2],v[3]};return r;}
+static inline float32x4_t vcombine_f32(float32x2_t low,float32x2_t high){float32x4_t r = {low[0],low[1],high[0],high[1]};return r;}
+static inline float32x2_t vpadd_f32(float32x2_t a,float32x2_t b){float32x2_t r = {a[0] + a[1],b[0] + b[1]};return r;}
+
+static inline float32x4x2_t vtrnq_f32(float32x4_t a,float32x4_t b)
+{
+    float32x4x2_t r;
+    float32x4_t even = {a[0],b[0],a[2],b[2]};
+    float32x4_t odd = {a[1],b[1],a[3],b[3]};
+    r.val[0] = even;
+    r.val[1] = odd;
+    return r;
+}
+
+static inline uint32x4_t vcgtq_f32(float32x4_t a,float32x4_t b)
+{
+    uint32x4_t r;
+    int i;
+    for (i = 0;i < 4;i++)r[i] = (a[i] > b[i]) ? 0xffffffffu : 0;
+    return r;
+}
+
+static inline float32x4_t vbslq_f32(uint32x4_t mask,float32x4_t a,float32x4_t b)
+{
+    uint32x4_t ua,ub,r;
+    float32x4_t out;
+    memcpy(&ua,&a,sizeof(ua));
+    memcpy(&ub,&b,sizeof(ub));
+    r = (ua & mask) | (ub & ~mask);
+    memcpy(&out,&r,sizeof(out));
+    return out;
+}
+
+#ifdef __aarch64__
+static inline float32x4_t vsqrtq_f32(float32x4_t v){float32x4_t r = {sqrtf(v[0]),sqrtf(v[1]),sqrtf(v[2]),sqrtf(v[3])};return r;}
+static inline float32x4_t vdivq_f32(float32x4_t a,float32x4_t b){return a / b;}
+#endif
+
+#endif
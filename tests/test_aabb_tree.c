@@ -0,0 +1,397 @@
+#include <string.h>
+
+#include "gfc_aabb_tree.h"
+#include "gfc_test.h"
+
+/**
+ * Stress test for GFC_AABBTree: random inserts, moves and removes, checking after each step that the tree is
+ * well formed and that query, foreach_pair and raycast agree with testing every body's fat bounds by brute
+ * force.  gfc_aabb_tree_raycast_batch is checked against gfc_raycast_shape on every shape.
+ * Then it times a 10k body scene where 1% are long thin edges, the mix the tree is meant for.
+ */
+
+#define BODY_COUNT 3000
+#define STEPS 30
+#define WORLD 2000
+
+static GFC_AABBTree *tree;
+static Uint32 handles[BODY_COUNT];
+static GFC_Rect bounds[BODY_COUNT];
+static Uint8 alive[BODY_COUNT];
+static Uint8 *seen;     /**<BODY_COUNT * BODY_COUNT flags for the pairs reported this step*/
+static int pairCount,badPairs;
+
+/**
+ * @brief the body a handle belongs to, from the data it was inserted with
+ */
+static int body_index(Uint32 handle)
+{
+    return (int)(size_t)gfc_aabb_tree_get_data(tree,handle) - 1;
+}
+
+static int rects_overlap(GFC_Rect a,GFC_Rect b)
+{
+    return (a.x <= b.x + b.w)&&(b.x <= a.x + a.w)&&(a.y <= b.y + b.h)&&(b.y <= a.y + a.h);
+}
+
+static int rect_contains(GFC_Rect outer,GFC_Rect inner,float slack)
+{
+    return (inner.x >= outer.x - slack)&&(inner.y >= outer.y - slack)&&
+        (inner.x + inner.w <= outer.x + outer.w + slack)&&(inner.y + inner.h <= outer.y + outer.h + slack);
+}
+
+/**
+ * @brief check parent links, heights and bounds below a node
+ * @return the height of the node, or -1 if anything is wrong
+ */
+static int validate(Uint32 n,Uint32 parent,int *leaves)
+{
+    GFC_AABBTreeNode *node = &tree->nodes[n];
+    int h1,h2;
+    if (node->parent != parent)return -1;
+    if (node->child1 == GFC_AABB_TREE_NONE)
+    {
+        if ((node->child2 != GFC_AABB_TREE_NONE)||(node->height != 0))return -1;
+        (*leaves)++;
+        return 0;
+    }
+    h1 = validate(node->child1,n,leaves);
+    h2 = validate(node->child2,n,leaves);
+    if ((h1 < 0)||(h2 < 0))return -1;
+    if (node->height != 1 + MAX(h1,h2))return -1;
+    if (!rect_contains(node->bounds,tree->nodes[node->child1].bounds,1e-3))return -1;
+    if (!rect_contains(node->bounds,tree->nodes[node->child2].bounds,1e-3))return -1;
+    return node->height;
+}
+
+static void record_pair(Uint32 a,Uint32 b,void *context)
+{
+    int i = body_index(a),j = body_index(b),t;
+    if ((i < 0)||(j < 0)||(i == j))
+    {
+        badPairs++;
+        return;
+    }
+    if (i > j)
+    {
+        t = i;
+        i = j;
+        j = t;
+    }
+    if (seen[i * BODY_COUNT + j])badPairs++;
+    seen[i * BODY_COUNT + j] = 1;
+    pairCount++;
+}
+
+static void count_pair(Uint32 a,Uint32 b,void *context)
+{
+    (*(int *)context)++;
+}
+
+/**
+ * @brief where a segment enters a rect, by clipping it against each slab
+ * @return the fraction along the ray, or -1 if it misses
+ */
+static float ray_rect(GFC_Edge2D ray,GFC_Rect rect)
+{
+    float dx = ray.x2 - ray.x1,dy = ray.y2 - ray.y1;
+    float p[4],q[4],t,enter = 0,leave = 1;
+    int k;
+    p[0] = -dx;
+    p[1] = dx;
+    p[2] = -dy;
+    p[3] = dy;
+    q[0] = ray.x1 - rect.x;
+    q[1] = rect.x + rect.w - ray.x1;
+    q[2] = ray.y1 - rect.y;
+    q[3] = rect.y + rect.h - ray.y1;
+    for (k = 0;k < 4;k++)
+    {
+        if (p[k] == 0)
+        {
+            if (q[k] < 0)return -1;
+            continue;
+        }
+        t = q[k] / p[k];
+        if (p[k] < 0)enter = MAX(enter,t);
+        else leave = MIN(leave,t);
+    }
+    return (enter <= leave) ? enter : -1;
+}
+
+/**
+ * @brief narrowphase for the raycast check, treats the fat bounds as the body
+ */
+static float ray_fat_bounds(Uint32 handle,GFC_Edge2D ray,float maxFraction,void *context)
+{
+    return ray_rect(ray,gfc_aabb_tree_get_fat_bounds(tree,handle));
+}
+
+static void check_step(int step)
+{
+    static Uint32 found[BODY_COUNT];
+    Uint8 got[BODY_COUNT];
+    GFC_Rect query,fat;
+    GFC_Edge2D ray;
+    Uint32 n,hitHandle;
+    float fraction,best,s;
+    int i,j,k,leaves = 0,living = 0,want,nearest;
+
+    for (i = 0;i < BODY_COUNT;i++)living += alive[i];
+    if (tree->root != GFC_AABB_TREE_NONE)
+    {
+        gfc_test_check(validate(tree->root,GFC_AABB_TREE_NONE,&leaves) >= 0,"step %i: tree is malformed",step);
+    }
+    gfc_test_check((leaves == living)&&(gfc_aabb_tree_get_count(tree) == (Uint32)living),
+        "step %i: %i leaves, count %u, want %i",step,leaves,gfc_aabb_tree_get_count(tree),living);
+    for (i = 0;i < BODY_COUNT;i++)
+    {
+        if (!alive[i])continue;
+        gfc_test_check(rect_contains(gfc_aabb_tree_get_fat_bounds(tree,handles[i]),bounds[i],0),"step %i: fat bounds of %i",step,i);
+    }
+
+    for (j = 0;j < 50;j++)
+    {
+        query = gfc_rect(gfc_test_randf(0,WORLD),gfc_test_randf(0,WORLD),gfc_test_randf(0,300),gfc_test_randf(0,300));
+        memset(got,0,sizeof(got));
+        n = gfc_aabb_tree_query(tree,query,found,BODY_COUNT);
+        for (i = 0;i < (int)n;i++)
+        {
+            k = body_index(found[i]);
+            gfc_test_check((k >= 0)&&(!got[k]),"step %i: query gave a bad or repeated handle %u",step,found[i]);
+            if (k >= 0)got[k] = 1;
+        }
+        for (i = 0;i < BODY_COUNT;i++)
+        {
+            if (!alive[i])continue;
+            fat = gfc_aabb_tree_get_fat_bounds(tree,handles[i]);
+            gfc_test_check(rects_overlap(query,fat) == got[i],"step %i: query %i, body %i",step,j,i);
+        }
+    }
+
+    memset(seen,0,BODY_COUNT * BODY_COUNT);
+    pairCount = badPairs = 0;
+    gfc_aabb_tree_foreach_pair(tree,record_pair,NULL);
+    gfc_test_check(badPairs == 0,"step %i: %i bad or repeated pairs",step,badPairs);
+    want = 0;
+    for (i = 0;i < BODY_COUNT;i++)
+    {
+        if (!alive[i])continue;
+        fat = gfc_aabb_tree_get_fat_bounds(tree,handles[i]);
+        for (j = i + 1;j < BODY_COUNT;j++)
+        {
+            if ((!alive[j])||(!rects_overlap(fat,gfc_aabb_tree_get_fat_bounds(tree,handles[j]))))continue;
+            want++;
+            gfc_test_check(seen[i * BODY_COUNT + j],"step %i: missed pair %i %i",step,i,j);
+        }
+    }
+    gfc_test_check(want == pairCount,"step %i: found %i pairs, want %i",step,pairCount,want);
+
+    for (j = 0;j < 50;j++)
+    {
+        ray = gfc_edge(gfc_test_randf(0,WORLD),gfc_test_randf(0,WORLD),gfc_test_randf(0,WORLD),gfc_test_randf(0,WORLD));
+        hitHandle = gfc_aabb_tree_raycast(tree,ray,ray_fat_bounds,NULL,&fraction);
+        best = 1;
+        nearest = -1;
+        for (i = 0;i < BODY_COUNT;i++)
+        {
+            if (!alive[i])continue;
+            s = ray_rect(ray,gfc_aabb_tree_get_fat_bounds(tree,handles[i]));
+            if ((s >= 0)&&(s < best))
+            {
+                best = s;
+                nearest = i;
+            }
+        }
+        if (nearest < 0)gfc_test_check(hitHandle == GFC_AABB_TREE_NONE,"step %i: ray %i hit nothing, got %u",step,j,hitHandle);
+        else gfc_test_check(fabsf(fraction - best) <= 1e-5,"step %i: ray %i hit at %f, want %f",step,j,fraction,best);
+    }
+}
+
+static void check_against_brute_force()
+{
+    GFC_Vector2D move;
+    float size;
+    int i,step;
+    tree = gfc_aabb_tree_new(2);
+    seen = malloc(BODY_COUNT * BODY_COUNT);
+    for (i = 0;i < BODY_COUNT;i++)
+    {
+        //every 50th body is a long thin edge
+        size = (i % 50 == 0) ? gfc_test_randf(0,500) : gfc_test_randf(0,8);
+        bounds[i] = gfc_rect(gfc_test_randf(0,WORLD),gfc_test_randf(0,WORLD),size,(i % 50 == 0) ? 2 : size);
+        handles[i] = gfc_aabb_tree_insert(tree,bounds[i],(void *)(size_t)(i + 1));
+        alive[i] = 1;
+    }
+    for (step = 0;step < STEPS;step++)
+    {
+        for (i = 0;i < BODY_COUNT;i++)
+        {
+            if (gfc_test_rand() % 10 == 0)
+            {
+                if (alive[i])
+                {
+                    gfc_aabb_tree_remove(tree,handles[i]);
+                    alive[i] = 0;
+                }
+                else
+                {
+                    bounds[i] = gfc_rect(gfc_test_randf(0,WORLD),gfc_test_randf(0,WORLD),gfc_test_randf(0,10),gfc_test_randf(0,10));
+                    handles[i] = gfc_aabb_tree_insert(tree,bounds[i],(void *)(size_t)(i + 1));
+                    alive[i] = 1;
+                }
+            }
+            else if (alive[i])
+            {
+                move = gfc_vector2d(gfc_test_randf(-3,3),gfc_test_randf(-3,3));
+                bounds[i].x += move.x;
+                bounds[i].y += move.y;
+                gfc_aabb_tree_move(tree,handles[i],bounds[i],move);
+            }
+        }
+        check_step(step);
+    }
+    gfc_aabb_tree_clear(tree);
+    gfc_test_check(gfc_aabb_tree_get_count(tree) == 0,"count after clear");
+    gfc_test_check(gfc_aabb_tree_query(tree,gfc_rect(-1e9,-1e9,2e9,2e9),handles,BODY_COUNT) == 0,"query after clear");
+    gfc_aabb_tree_free(tree);
+    tree = NULL;
+    free(seen);
+}
+
+#define SHAPE_COUNT 1000
+#define RAY_COUNT 500
+
+/**
+ * @brief gfc_aabb_tree_raycast_batch must find the same nearest hit as testing every shape
+ */
+static void check_raycast_batch()
+{
+    static GFC_Shape shapes[SHAPE_COUNT];
+    static Uint32 shapeHandles[SHAPE_COUNT];
+    static GFC_Edge2D rays[RAY_COUNT];
+    static GFC_RaycastHit hits[RAY_COUNT];
+    GFC_RaycastHit hit,best;
+    Uint32 hitCount,wantCount = 0;
+    float x,y;
+    int i,j;
+    tree = gfc_aabb_tree_new(1);
+    for (i = 0;i < SHAPE_COUNT;i++)
+    {
+        x = gfc_test_randf(0,WORLD);
+        y = gfc_test_randf(0,WORLD);
+        switch (i % 3)
+        {
+            case 0:
+                shapes[i] = gfc_shape_rect(x,y,gfc_test_randf(1,30),gfc_test_randf(1,30));
+                break;
+            case 1:
+                shapes[i] = gfc_shape_circle(x,y,gfc_test_randf(1,15));
+                break;
+            default:
+                shapes[i] = gfc_shape_edge(x,y,x + gfc_test_randf(-200,200),y + gfc_test_randf(-200,200));
+                break;
+        }
+        shapeHandles[i] = gfc_aabb_tree_insert(tree,gfc_shape_get_bounds(shapes[i]),&shapes[i]);
+    }
+    for (i = 0;i < RAY_COUNT;i++)
+    {
+        rays[i] = gfc_edge(gfc_test_randf(0,WORLD),gfc_test_randf(0,WORLD),gfc_test_randf(0,WORLD),gfc_test_randf(0,WORLD));
+    }
+    hitCount = gfc_aabb_tree_raycast_batch(tree,rays,RAY_COUNT,hits);
+    for (i = 0;i < RAY_COUNT;i++)
+    {
+        memset(&best,0,sizeof(best));
+        best.fraction = 1;
+        for (j = 0;j < SHAPE_COUNT;j++)
+        {
+            if ((gfc_raycast_shape(rays[i],shapes[j],&hit))&&((!best.hit)||(hit.fraction < best.fraction)))
+            {
+                best = hit;
+                best.id = shapeHandles[j];
+            }
+        }
+        wantCount += best.hit;
+        gfc_test_check(hits[i].hit == best.hit,"batch ray %i hit %i, want %i",i,hits[i].hit,best.hit);
+        if ((!best.hit)||(!hits[i].hit))continue;
+        gfc_test_check(fabsf(hits[i].fraction - best.fraction) <= 1e-5,"batch ray %i hit at %f, want %f",i,hits[i].fraction,best.fraction);
+    }
+    gfc_test_check(hitCount == wantCount,"batch hit %u rays, want %u",hitCount,wantCount);
+    gfc_aabb_tree_free(tree);
+    tree = NULL;
+}
+
+#define SCENE_COUNT 10000
+#define FRAMES 100
+
+static void time_mixed_scene()
+{
+    static Uint32 found[SCENE_COUNT];
+    Uint32 *bodies = malloc(sizeof(Uint32) * SCENE_COUNT);
+    GFC_Rect *rects = malloc(sizeof(GFC_Rect) * SCENE_COUNT);
+    GFC_Vector2D *velocity = malloc(sizeof(GFC_Vector2D) * SCENE_COUNT);
+    double start,buildTime,moveTime = 0,pairTime = 0,queryTime = 0,rayTime = 0;
+    float size,fraction;
+    int i,j,frame,pairs = 0;
+    tree = gfc_aabb_tree_new(1);
+    start = gfc_test_seconds();
+    for (i = 0;i < SCENE_COUNT;i++)
+    {
+        //every 100th body is a long thin static edge, the rest are small and moving
+        size = (i % 100 == 0) ? gfc_test_randf(0,1000) : 4;
+        rects[i] = gfc_rect(gfc_test_randf(0,WORLD),gfc_test_randf(0,WORLD),size,(i % 100 == 0) ? 1 : size);
+        velocity[i] = (i % 100 == 0) ? gfc_vector2d(0,0) : gfc_vector2d(gfc_test_randf(-2,2),gfc_test_randf(-2,2));
+        bodies[i] = gfc_aabb_tree_insert(tree,rects[i],NULL);
+    }
+    buildTime = gfc_test_seconds() - start;
+    for (frame = 0;frame < FRAMES;frame++)
+    {
+        start = gfc_test_seconds();
+        for (i = 0;i < SCENE_COUNT;i++)
+        {
+            rects[i].x += velocity[i].x;
+            rects[i].y += velocity[i].y;
+            if ((rects[i].x < 0)||(rects[i].x > WORLD))velocity[i].x = -velocity[i].x;
+            if ((rects[i].y < 0)||(rects[i].y > WORLD))velocity[i].y = -velocity[i].y;
+            gfc_aabb_tree_move(tree,bodies[i],rects[i],velocity[i]);
+        }
+        moveTime += gfc_test_seconds() - start;
+        start = gfc_test_seconds();
+        pairs = 0;
+        gfc_aabb_tree_foreach_pair(tree,count_pair,&pairs);
+        pairTime += gfc_test_seconds() - start;
+        start = gfc_test_seconds();
+        for (j = 0;j < 100;j++)
+        {
+            gfc_aabb_tree_query(tree,gfc_rect(gfc_test_randf(0,WORLD),gfc_test_randf(0,WORLD),50,50),found,SCENE_COUNT);
+        }
+        queryTime += gfc_test_seconds() - start;
+        start = gfc_test_seconds();
+        for (j = 0;j < 100;j++)
+        {
+            gfc_aabb_tree_raycast(tree,
+                gfc_edge(gfc_test_randf(0,WORLD),gfc_test_randf(0,WORLD),gfc_test_randf(0,WORLD),gfc_test_randf(0,WORLD)),
+                ray_fat_bounds,NULL,&fraction);
+        }
+        rayTime += gfc_test_seconds() - start;
+    }
+    printf("%i bodies, 1%% long edges, height %u, ms:\n",SCENE_COUNT,gfc_aabb_tree_get_height(tree));
+    printf("  build            %6.3f\n",buildTime * 1000);
+    printf("  move all         %6.3f per frame\n",moveTime * 1000 / FRAMES);
+    printf("  pairs            %6.3f per frame (%i pairs)\n",pairTime * 1000 / FRAMES,pairs);
+    printf("  100 queries      %6.3f per frame\n",queryTime * 1000 / FRAMES);
+    printf("  100 rays         %6.3f per frame\n",rayTime * 1000 / FRAMES);
+    gfc_aabb_tree_free(tree);
+    tree = NULL;
+    free(velocity);
+    free(rects);
+    free(bodies);
+}
+
+int main(int argc,char *argv[])
+{
+    check_against_brute_force();
+    check_raycast_batch();
+    time_mixed_scene();
+    return gfc_test_result("test_aabb_tree");
+}
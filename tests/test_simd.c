@@ -0,0 +1,271 @@
+#include <float.h>
+#include <string.h>
+
+#include "gfc_vector.h"
+#include "gfc_matrix.h"
+#include "gfc_simd.h"
+#include "gfc_test.h"
+
+/**
+ * Checks the Vector4D and Matrix4 functions that have a GFC_SIMD path against a double precision reference
+ * on random inputs.  The Makefile builds this once per backend (scalar, SSE2, SSE4.1, and NEON where it can),
+ * and every build is held to the same tolerance, so passing them all means the SIMD paths agree with the
+ * scalar one to within twice that.
+ */
+
+#define CASES 20000
+
+/*float error bound for a sum of up to four products, relative to the sum of their magnitudes*/
+#define TOLERANCE (8 * FLT_EPSILON)
+
+static void random_matrix(GFC_Matrix4 m)
+{
+    int i,j;
+    for (i = 0;i < 4;i++)
+    {
+        for (j = 0;j < 4;j++)m[i][j] = gfc_test_randf(-100,100);
+    }
+}
+
+static GFC_Vector4D random_vector()
+{
+    return gfc_vector4d(gfc_test_randf(-100,100),gfc_test_randf(-100,100),gfc_test_randf(-100,100),gfc_test_randf(-100,100));
+}
+
+static int close_to(double got,double want,double scale)
+{
+    return fabs(got - want) <= TOLERANCE * scale + FLT_MIN;
+}
+
+/**
+ * @brief out[i][j] = sum a[i][k] * b[k][j], the order gfc_matrix4_multiply(out,a,b) uses
+ */
+static void check_product(GFC_Matrix4 got,GFC_Matrix4 a,GFC_Matrix4 b,const char *what)
+{
+    int i,j,k;
+    double want,scale;
+    for (i = 0;i < 4;i++)
+    {
+        for (j = 0;j < 4;j++)
+        {
+            want = scale = 0;
+            for (k = 0;k < 4;k++)
+            {
+                want += (double)a[i][k] * b[k][j];
+                scale += fabs((double)a[i][k] * b[k][j]);
+            }
+            gfc_test_check(close_to(got[i][j],want,scale),"%s [%i][%i]: %.9g, expected %.9g",what,i,j,got[i][j],want);
+        }
+    }
+}
+
+static void test_matrix4_multiply()
+{
+    int n;
+    GFC_Matrix4 a,b,out,copy;
+    for (n = 0;n < CASES;n++)
+    {
+        random_matrix(a);
+        random_matrix(b);
+        gfc_matrix4_multiply(out,a,b);
+        check_product(out,a,b,"gfc_matrix4_multiply");
+        //the output may be either input
+        memcpy(copy,a,sizeof(GFC_Matrix4));
+        gfc_matrix4_multiply(copy,copy,b);
+        gfc_test_check(memcmp(copy,out,sizeof(GFC_Matrix4)) == 0,"gfc_matrix4_multiply with out == first input");
+        memcpy(copy,b,sizeof(GFC_Matrix4));
+        gfc_matrix4_multiply(copy,a,copy);
+        gfc_test_check(memcmp(copy,out,sizeof(GFC_Matrix4)) == 0,"gfc_matrix4_multiply with out == second input");
+    }
+}
+
+static void test_matrix4_multiply_chain()
+{
+    int n,i,j,k,l;
+    double want,scale,term;
+    GFC_Matrix4 a,b,c,out;
+    GFC_Matrix4 *chain[3];
+    chain[0] = &a;
+    chain[1] = &b;
+    chain[2] = &c;
+    for (n = 0;n < CASES / 4;n++)
+    {
+        random_matrix(a);
+        random_matrix(b);
+        random_matrix(c);
+        gfc_matrix4_multiply_chain(out,chain,2);
+        check_product(out,a,b,"gfc_matrix4_multiply_chain of 2");
+        gfc_matrix4_multiply_chain(out,chain,3);
+        for (i = 0;i < 4;i++)
+        {
+            for (j = 0;j < 4;j++)
+            {
+                want = scale = 0;
+                for (k = 0;k < 4;k++)
+                {
+                    for (l = 0;l < 4;l++)
+                    {
+                        term = (double)a[i][k] * b[k][l] * c[l][j];
+                        want += term;
+                        scale += fabs(term);
+                    }
+                }
+                //two rounds of rounding
+                gfc_test_check(close_to(out[i][j],want,2 * scale),"gfc_matrix4_multiply_chain of 3 [%i][%i]: %.9g, expected %.9g",
+                    i,j,out[i][j],want);
+            }
+        }
+    }
+}
+
+static void test_matrix4_vector()
+{
+    int n,i,k;
+    GFC_Matrix4 m;
+    GFC_Vector4D v,out;
+    float *in,*got;
+    double want,scale;
+    for (n = 0;n < CASES;n++)
+    {
+        random_matrix(m);
+        v = random_vector();
+        in = &v.x;
+        got = &out.x;
+        //row vector times matrix
+        gfc_matrix4_v_multiply(&out,v,m);
+        for (i = 0;i < 4;i++)
+        {
+            want = scale = 0;
+            for (k = 0;k < 4;k++)
+            {
+                want += (double)in[k] * m[k][i];
+                scale += fabs((double)in[k] * m[k][i]);
+            }
+            gfc_test_check(close_to(got[i],want,scale),"gfc_matrix4_v_multiply [%i]: %.9g, expected %.9g",i,got[i],want);
+        }
+        //matrix times column vector
+        gfc_matrix4_multiply_v(&out,m,v);
+        for (i = 0;i < 4;i++)
+        {
+            want = scale = 0;
+            for (k = 0;k < 4;k++)
+            {
+                want += (double)m[i][k] * in[k];
+                scale += fabs((double)m[i][k] * in[k]);
+            }
+            gfc_test_check(close_to(got[i],want,scale),"gfc_matrix4_multiply_v [%i]: %.9g, expected %.9g",i,got[i],want);
+        }
+    }
+}
+
+static void test_matrix4_multiply_scalar()
+{
+    int n,i,j;
+    float s;
+    GFC_Matrix4 m,out;
+    for (n = 0;n < CASES;n++)
+    {
+        random_matrix(m);
+        s = gfc_test_randf(-10,10);
+        gfc_matrix4_multiply_scalar(out,m,s);
+        for (i = 0;i < 4;i++)
+        {
+            for (j = 0;j < 4;j++)
+            {
+                //a single product rounds the same way on every path
+                gfc_test_check(out[i][j] == m[i][j] * s,"gfc_matrix4_multiply_scalar [%i][%i]",i,j);
+            }
+        }
+        gfc_matrix4_multiply_scalar(m,m,s);
+        gfc_test_check(memcmp(m,out,sizeof(GFC_Matrix4)) == 0,"gfc_matrix4_multiply_scalar with out == m");
+    }
+}
+
+static void test_vector4d()
+{
+    int n,i;
+    GFC_Vector4D a,b,out;
+    float *pa,*pb,*po;
+    double want,scale;
+    for (n = 0;n < CASES;n++)
+    {
+        a = random_vector();
+        b = random_vector();
+        pa = &a.x;
+        pb = &b.x;
+        po = &out.x;
+        out = gfc_vector4d_multiply(a,b);
+        for (i = 0;i < 4;i++)gfc_test_check(po[i] == pa[i] * pb[i],"gfc_vector4d_multiply [%i]",i);
+        want = 0;
+        for (i = 0;i < 4;i++)want += (double)pa[i] * pa[i];
+        gfc_test_check(close_to(gfc_vector4d_magnitude_squared(a),want,want),"gfc_vector4d_magnitude_squared");
+        gfc_test_check(close_to(gfc_vector4d_magnitude(a),sqrt(want),sqrt(want)),"gfc_vector4d_magnitude: %.9g, expected %.9g",
+            gfc_vector4d_magnitude(a),sqrt(want));
+        out = a;
+        gfc_vector4d_normalize(&out);
+        scale = sqrt(want);
+        for (i = 0;i < 4;i++)
+        {
+            gfc_test_check(close_to(po[i],pa[i] / scale,1),"gfc_vector4d_normalize [%i]: %.9g, expected %.9g",i,po[i],pa[i] / scale);
+        }
+    }
+    out = gfc_vector4d(0,0,0,0);
+    gfc_vector4d_normalize(&out);
+    gfc_test_check((out.x == 0)&&(out.y == 0)&&(out.z == 0)&&(out.w == 0),"gfc_vector4d_normalize of zero");
+}
+
+static void test_vector3d_batch()
+{
+    enum {COUNT = 1027};//not a multiple of 4, so the scalar tail runs too
+    static float x[COUNT],y[COUNT],z[COUNT],nx[COUNT],ny[COUNT],nz[COUNT],length[COUNT];
+    GFC_Vector3DBatch in = {x,y,z},out = {nx,ny,nz};
+    double want;
+    int i;
+    for (i = 0;i < COUNT;i++)
+    {
+        x[i] = gfc_test_randf(-100,100);
+        y[i] = gfc_test_randf(-100,100);
+        z[i] = gfc_test_randf(-100,100);
+    }
+    x[5] = y[5] = z[5] = 0;
+    gfc_vector3d_batch_magnitude(length,in,COUNT);
+    gfc_vector3d_batch_normalize(out,in,COUNT);
+    for (i = 0;i < COUNT;i++)
+    {
+        want = sqrt((double)x[i] * x[i] + (double)y[i] * y[i] + (double)z[i] * z[i]);
+        gfc_test_check(close_to(length[i],want,want),"gfc_vector3d_batch_magnitude [%i]",i);
+        if (want == 0)
+        {
+            gfc_test_check((nx[i] == 0)&&(ny[i] == 0)&&(nz[i] == 0),"gfc_vector3d_batch_normalize of zero [%i]",i);
+            continue;
+        }
+        gfc_test_check(close_to(nx[i],x[i] / want,1)&&close_to(ny[i],y[i] / want,1)&&close_to(nz[i],z[i] / want,1),
+            "gfc_vector3d_batch_normalize [%i]",i);
+    }
+}
+
+int main(int argc,char *argv[])
+{
+#if defined(GFC_SIMD_SSE)
+    #ifdef __SSE4_1__
+    const char *backend = "test_simd (SSE4.1)";
+    #else
+    const char *backend = "test_simd (SSE2)";
+    #endif
+#elif defined(GFC_SIMD_NEON)
+    #ifdef GFC_SIMD_HAS_SQRT
+    const char *backend = "test_simd (NEON aarch64)";
+    #else
+    const char *backend = "test_simd (NEON armv7)";
+    #endif
+#else
+    const char *backend = "test_simd (scalar)";
+#endif
+    test_matrix4_multiply();
+    test_matrix4_multiply_chain();
+    test_matrix4_vector();
+    test_matrix4_multiply_scalar();
+    test_vector4d();
+    test_vector3d_batch();
+    return gfc_test_result(backend);
+}